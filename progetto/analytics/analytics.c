@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "analytics.h"
+
+// Counters of one course over every collection
+struct course {
+    char name[51];
+    int numel[3];
+    long minutes[3];          // estimated time per collection
+    long long remaining;      // estimated time not done of the open tasks, in 1/10000 of minute
+    int late;                 // completed after the deadline
+    long lateDays;
+};
+
+struct analytics {
+    struct course *courses;
+    int numCourses;
+    int totCourses;
+    int *table;               // open addressing hash table of positions in 'courses', -1 if free
+    int tableSize;            // always a power of two, at least twice 'numCourses'
+};
+
+/* newAnalytics
+ * Syntax Specification:
+ * Analytics newAnalytics(void);
+ *
+ * Semantic Specification:
+ * Creates empty per-course rollups. The tasks are then added with trackCourse,
+ * and the rollups are kept up to date at every change of state.
+ *
+ * Preconditions:
+ * - None.
+ *
+ * Postconditions:
+ * - Returns the new rollups, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+Analytics newAnalytics(void) {
+    Analytics a = calloc(1, sizeof(struct analytics));
+    if (a == NULL) return NULL;
+
+    a->tableSize = 16;
+    a->table = malloc(a->tableSize * sizeof(int));
+    if (a->table == NULL) {
+        free(a);
+        return NULL;
+    }
+    for (int i = 0; i < a->tableSize; i++) a->table[i] = -1;
+    return a;
+}
+
+void freeAnalytics(Analytics a) {
+    if (a == NULL) return;
+    free(a->courses);
+    free(a->table);
+    free(a);
+}
+
+/* findSlot
+ * Syntax Specification:
+ * static int findSlot(Analytics a, const char *name);
+ *
+ * Semantic Specification:
+ * Returns the slot of the hash table holding the course, or the free slot where it would go.
+ *
+ * Preconditions:
+ * - 'a' must be valid, with at least one free slot.
+ *
+ * Postconditions:
+ * - Returns a slot index in [0, tableSize).
+ *
+ * Side Effects:
+ * - None.
+ */
+static int findSlot(Analytics a, const char *name) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; name[i] != '\0'; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    int slot = h & (a->tableSize - 1);
+    while (a->table[slot] != -1 && strcmp(a->courses[a->table[slot]].name, name) != 0) {
+        slot = (slot + 1) & (a->tableSize - 1);
+    }
+    return slot;
+}
+
+/* findCourse
+ * Syntax Specification:
+ * static struct course *findCourse(Analytics a, const char *name, bool add);
+ *
+ * Semantic Specification:
+ * Returns the counters of a course; if 'add' is true a new course is added.
+ *
+ * Preconditions:
+ * - 'a' must be valid, 'name' a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns the counters, or NULL if the course is unknown (and not added)
+ *   or memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static struct course *findCourse(Analytics a, const char *name, bool add) {
+    int slot = findSlot(a, name);
+    if (a->table[slot] != -1) return &a->courses[a->table[slot]];
+    if (!add) return NULL;
+
+    // the table stays at most half full
+    if ((a->numCourses + 1) * 2 > a->tableSize) {
+        int *table = malloc(a->tableSize * 2 * sizeof(int));
+        if (table == NULL) return NULL;
+        free(a->table);
+        a->table = table;
+        a->tableSize *= 2;
+        for (int i = 0; i < a->tableSize; i++) a->table[i] = -1;
+        for (int i = 0; i < a->numCourses; i++) a->table[findSlot(a, a->courses[i].name)] = i;
+        slot = findSlot(a, name);
+    }
+    if (a->numCourses == a->totCourses) {
+        int tot = a->totCourses ? a->totCourses * 2 : 8;
+        struct course *courses = realloc(a->courses, tot * sizeof(struct course));
+        if (courses == NULL) return NULL;
+        a->courses = courses;
+        a->totCourses = tot;
+    }
+
+    struct course *c = &a->courses[a->numCourses];
+    memset(c, 0, sizeof(struct course));
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    a->table[slot] = a->numCourses++;
+    return c;
+}
+
+/* count
+ * Syntax Specification:
+ * static void count(Analytics a, Task t, int collection, int sign);
+ *
+ * Semantic Specification:
+ * Adds (sign 1) or removes (sign -1) a task from the counters of its course.
+ * The remaining time is kept as an integer, so that removing a task subtracts
+ * exactly what adding it added.
+ *
+ * Preconditions:
+ * - 'a' and 't' must be valid, 'collection' one of ANALYTICS_OPEN, ANALYTICS_COMPLETED
+ *   or ANALYTICS_EXPIRED.
+ *
+ * Postconditions:
+ * - The counters of the course are updated.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static void count(Analytics a, Task t, int collection, int sign) {
+    struct course *c = findCourse(a, getCourse(t), sign > 0);
+    if (c == NULL) return;
+
+    c->numel[collection] += sign;
+    c->minutes[collection] += sign * getExdTime(t);
+    if (collection == ANALYTICS_OPEN) {
+        long long todo = (long long)((100.0f - getCompletionPercentage(t)) * 100.0f + 0.5f);
+        c->remaining += sign * getExdTime(t) * todo;
+    } else if (collection == ANALYTICS_COMPLETED) {
+        int days = compareDates(getCompletionDate(t), getDeadline(t));
+        if (days > 0) {
+            c->late += sign;
+            c->lateDays += sign * days;
+        }
+    }
+}
+
+/* trackCourse, untrackCourse
+ * Syntax Specification:
+ * void trackCourse(Analytics a, Task t, int collection);
+ * void untrackCourse(Analytics a, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Record that a task entered or is leaving a collection. untrackCourse must be
+ * called before the fields used by the rollups (course, estimated time,
+ * completion percentage and dates) are changed.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'a' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The rollup of the course of the task includes it (or no longer does).
+ *
+ * Side Effects:
+ * - trackCourse may allocate memory.
+ */
+void trackCourse(Analytics a, Task t, int collection) {
+    if (a != NULL && t != NULL) count(a, t, collection, 1);
+}
+
+void untrackCourse(Analytics a, Task t, int collection) {
+    if (a != NULL && t != NULL) count(a, t, collection, -1);
+}
+
+/* clearCourseHistory
+ * Syntax Specification:
+ * void clearCourseHistory(Analytics a);
+ *
+ * Semantic Specification:
+ * Resets the counters of the completed and expired tasks, when the history is deleted.
+ *
+ * Preconditions:
+ * - 'a' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - Only the open tasks are counted.
+ *
+ * Side Effects:
+ * - None.
+ */
+void clearCourseHistory(Analytics a) {
+    if (a == NULL) return;
+    for (int i = 0; i < a->numCourses; i++) {
+        struct course *c = &a->courses[i];
+        c->numel[ANALYTICS_COMPLETED] = c->numel[ANALYTICS_EXPIRED] = 0;
+        c->minutes[ANALYTICS_COMPLETED] = c->minutes[ANALYTICS_EXPIRED] = 0;
+        c->late = 0;
+        c->lateDays = 0;
+    }
+}
+
+/* fillRollup
+ * Syntax Specification:
+ * static void fillRollup(struct course *c, struct courseRollup *r);
+ *
+ * Semantic Specification:
+ * Computes the rollup of a course from its counters, in constant time.
+ *
+ * Preconditions:
+ * - 'c' and 'r' must be valid.
+ *
+ * Postconditions:
+ * - 'r' describes the course; 'r->course' points into the counters.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void fillRollup(struct course *c, struct courseRollup *r) {
+    int completed = c->numel[ANALYTICS_COMPLETED];
+    int closed = completed + c->numel[ANALYTICS_EXPIRED];
+
+    r->course = c->name;
+    r->open = c->numel[ANALYTICS_OPEN];
+    r->completed = completed;
+    r->expired = c->numel[ANALYTICS_EXPIRED];
+    r->totalMinutes = c->minutes[ANALYTICS_OPEN] + c->minutes[ANALYTICS_COMPLETED] + c->minutes[ANALYTICS_EXPIRED];
+    r->remainingMinutes = c->remaining / 10000.0;
+    r->onTimeRate = closed > 0 ? (float)(completed - c->late) * 100.0f / closed : -1.0f;
+    r->averageLateness = c->late > 0 ? (float)c->lateDays / c->late : 0.0f;
+}
+
+/* getRollupCount, getRollupAt
+ * Syntax Specification:
+ * int getRollupCount(Analytics a);
+ * void getRollupAt(Analytics a, int i, struct courseRollup *r);
+ *
+ * Semantic Specification:
+ * Visit the rollups in order of first appearance of the courses. A course whose
+ * tasks were all removed is still visited, with every count at zero.
+ *
+ * Preconditions:
+ * - 'a' must be valid, 0 <= i < getRollupCount(a).
+ *
+ * Postconditions:
+ * - getRollupAt fills 'r' with the rollup of the i-th course.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getRollupCount(Analytics a) {
+    return a->numCourses;
+}
+
+void getRollupAt(Analytics a, int i, struct courseRollup *r) {
+    fillRollup(&a->courses[i], r);
+}
+
+/* getCourseRollup
+ * Syntax Specification:
+ * bool getCourseRollup(Analytics a, const char *course, struct courseRollup *r);
+ *
+ * Semantic Specification:
+ * Returns the rollup of one course, with a single lookup in the hash table.
+ *
+ * Preconditions:
+ * - 'a' and 'r' must be valid, 'course' a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns true and fills 'r' if the course is known, false otherwise.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool getCourseRollup(Analytics a, const char *course, struct courseRollup *r) {
+    struct course *c = findCourse(a, course, false);
+    if (c == NULL) return false;
+    fillRollup(c, r);
+    return true;
+}
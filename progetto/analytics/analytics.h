@@ -0,0 +1,34 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Collections of the rollups: same indexes as the planner and the weekly counters
+#define ANALYTICS_OPEN 0
+#define ANALYTICS_COMPLETED 1
+#define ANALYTICS_EXPIRED 2
+
+// Rollup of one course, computed from the counters without visiting its tasks
+struct courseRollup {
+    const char *course;
+    int open;
+    int completed;
+    int expired;
+    long totalMinutes;       // estimated time of every task of the course
+    double remainingMinutes; // estimated time not done yet of the open tasks
+    float onTimeRate;        // percentage of completed on time over completed and expired, -1 if none
+    float averageLateness;   // days past the deadline of the late completions, 0 if none
+};
+
+// Forward declaration of the analytics struct
+typedef struct analytics *Analytics;
+
+ //analytics prototypes
+Analytics newAnalytics(void);
+void freeAnalytics(Analytics a);
+
+void trackCourse(Analytics a, Task t, int collection);
+void untrackCourse(Analytics a, Task t, int collection);
+void clearCourseHistory(Analytics a);
+
+int getRollupCount(Analytics a);
+void getRollupAt(Analytics a, int i, struct courseRollup *r);
+bool getCourseRollup(Analytics a, const char *course, struct courseRollup *r);
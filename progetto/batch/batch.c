@@ -0,0 +1,575 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../planner/planner.h"
+#include "batch.h"
+
+// Longest command accepted: an add with all its fields at the maximum length
+#define MAX_COMMAND 1024
+#define MAX_FIELDS 10
+
+/* splitCommand
+ * Syntax Specification:
+ * static int splitCommand(char *line, char **fields, int max);
+ *
+ * Semantic Specification:
+ * Splits a command in place on the tabs.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string without the line terminator.
+ * - 'fields' must have space for 'max' pointers.
+ *
+ * Postconditions:
+ * - Returns the number of fields found (it can be greater than 'max').
+ *
+ * Side Effects:
+ * - Modifies 'line'.
+ */
+static int splitCommand(char *line, char **fields, int max) {
+    int n = 0;
+    while (1) {
+        if (n < max) fields[n] = line;
+        n++;
+        char *tab = strchr(line, '\t');
+        if (tab == NULL) break;
+        *tab = '\0';
+        line = tab + 1;
+    }
+    return n;
+}
+
+/* parseNumber
+ * Syntax Specification:
+ * static bool parseNumber(const char *s, int *value);
+ *
+ * Semantic Specification:
+ * Reads a non-negative integer made only of digits.
+ *
+ * Preconditions:
+ * - 's' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns true and sets '*value' if 's' is a number of at most 9 digits.
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool parseNumber(const char *s, int *value) {
+    int len = strlen(s);
+    if (len == 0 || len > 9 || !isOnlyDigits(s, len)) return false;
+    *value = atoi(s);
+    return true;
+}
+
+/* findTask
+ * Syntax Specification:
+ * static int findTask(Planner p, const char *key, bool expired);
+ *
+ * Semantic Specification:
+ * Resolves the task named by a command: a number is an id, anything else the
+ * title of a task in progress (or expired, if 'expired').
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the id, or PLANNER_ENOTFOUND for an unknown title.
+ *
+ * Side Effects:
+ * - May load the expired tasks.
+ */
+static int findTask(Planner p, const char *key, bool expired) {
+    int id;
+    if (parseNumber(key, &id)) return id;
+    return expired ? plannerFindExpired(p, key) : plannerFindTask(p, key);
+}
+
+/* parsePatch
+ * Syntax Specification:
+ * static const char *parsePatch(char **fields, int n, struct taskPatch *patch);
+ *
+ * Semantic Specification:
+ * Builds a patch from "name=value" fields; the names are title, description,
+ * course, time, deadline, priority and completion.
+ *
+ * Preconditions:
+ * - 'fields' must hold 'n' null-terminated strings.
+ *
+ * Postconditions:
+ * - Returns NULL if every field was understood, the reason otherwise.
+ *
+ * Side Effects:
+ * - Modifies the fields (the '=' is replaced).
+ */
+static const char *parsePatch(char **fields, int n, struct taskPatch *patch) {
+    memset(patch, 0, sizeof(struct taskPatch));
+    if (n == 0) return "nothing to update";
+
+    for (int i = 0; i < n; i++) {
+        char *value = strchr(fields[i], '=');
+        if (value == NULL) return "fields must be written as name=value";
+        *value++ = '\0';
+
+        const char *name = fields[i];
+        if (strcmp(name, "title") == 0) {
+            patch->fields |= PATCH_TITLE;
+            patch->title = value;
+        } else if (strcmp(name, "description") == 0) {
+            patch->fields |= PATCH_DESCRIPTION;
+            patch->description = value;
+        } else if (strcmp(name, "course") == 0) {
+            patch->fields |= PATCH_COURSE;
+            patch->course = value;
+        } else if (strcmp(name, "time") == 0) {
+            if (!parseNumber(value, &patch->estimatedTime)) return "time must be a non-negative number of minutes";
+            patch->fields |= PATCH_TIME;
+        } else if (strcmp(name, "deadline") == 0) {
+            patch->fields |= PATCH_DEADLINE;
+            patch->deadline = value;
+        } else if (strcmp(name, "priority") == 0) {
+            patch->fields |= PATCH_PRIORITY;
+            patch->priority = value;
+        } else if (strcmp(name, "completion") == 0) {
+            char *end;
+            patch->completion = strtof(value, &end);
+            if (*value == '\0' || *end != '\0' || !isfinite(patch->completion))
+                return "completion must be a number from 0 to 100";
+            patch->fields |= PATCH_COMPLETION;
+        } else {
+            return "unknown field";
+        }
+    }
+    return NULL;
+}
+
+/* parseLevel
+ * Syntax Specification:
+ * static int parseLevel(const char *s);
+ *
+ * Semantic Specification:
+ * Converts a priority to its level.
+ *
+ * Preconditions:
+ * - 's' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns 1 for "low", 2 for "medium", 3 for "high", 0 otherwise.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int parseLevel(const char *s) {
+    if (strcmp(s, "low") == 0) return 1;
+    if (strcmp(s, "medium") == 0) return 2;
+    if (strcmp(s, "high") == 0) return 3;
+    return 0;
+}
+
+/* parseQuery
+ * Syntax Specification:
+ * static const char *parseQuery(char **fields, int n, struct taskQuery *q);
+ *
+ * Semantic Specification:
+ * Builds a query from "name=value" fields: id, title, course, priority, from and
+ * to (range of the deadline), mincompletion, maxcompletion, state (progress,
+ * completed or expired, more than one separated by commas), sort (deadline,
+ * priority or completion), order (asc or desc) and limit. Without 'state' only
+ * the tasks in progress are searched.
+ *
+ * Preconditions:
+ * - 'fields' must hold 'n' null-terminated strings.
+ *
+ * Postconditions:
+ * - Returns NULL if every field was understood, the reason otherwise.
+ *
+ * Side Effects:
+ * - Modifies the fields (the '=' and the commas are replaced).
+ */
+static const char *parseQuery(char **fields, int n, struct taskQuery *q) {
+    memset(q, 0, sizeof(struct taskQuery));
+    q->states = QUERY_PROGRESS;
+    q->minCompletion = 0;
+    q->maxCompletion = 100;
+
+    for (int i = 0; i < n; i++) {
+        char *value = strchr(fields[i], '=');
+        if (value == NULL) return "fields must be written as name=value";
+        *value++ = '\0';
+
+        const char *name = fields[i];
+        char *end;
+        if (strcmp(name, "id") == 0) {
+            if (!parseNumber(value, &q->id)) return "id must be a number";
+            q->filters |= QUERY_ID;
+        } else if (strcmp(name, "title") == 0) {
+            q->filters |= QUERY_TITLE;
+            q->title = value;
+        } else if (strcmp(name, "course") == 0) {
+            q->filters |= QUERY_COURSE;
+            q->course = value;
+        } else if (strcmp(name, "priority") == 0) {
+            q->minPriority = q->maxPriority = parseLevel(value);
+            if (q->minPriority == 0) return "priority must be low, medium or high";
+            q->filters |= QUERY_PRIORITY;
+        } else if (strcmp(name, "from") == 0 || strcmp(name, "to") == 0) {
+            q->filters |= QUERY_DEADLINE;
+            if (name[0] == 'f') q->deadlineFrom = value;
+                else q->deadlineTo = value;
+        } else if (strcmp(name, "mincompletion") == 0 || strcmp(name, "maxcompletion") == 0) {
+            float completion = strtof(value, &end);
+            if (*value == '\0' || *end != '\0' || !isfinite(completion)) return "completion must be a number from 0 to 100";
+            q->filters |= QUERY_COMPLETION;
+            if (name[1] == 'i') q->minCompletion = completion;
+                else q->maxCompletion = completion;
+        } else if (strcmp(name, "state") == 0) {
+            q->states = 0;
+            for (char *state = strtok(value, ","); state != NULL; state = strtok(NULL, ",")) {
+                if (strcmp(state, "progress") == 0) q->states |= QUERY_PROGRESS;
+                    else if (strcmp(state, "completed") == 0) q->states |= QUERY_COMPLETED;
+                    else if (strcmp(state, "expired") == 0) q->states |= QUERY_EXPIRED;
+                    else return "state must be progress, completed or expired";
+            }
+            if (q->states == 0) return "state must be progress, completed or expired";
+        } else if (strcmp(name, "sort") == 0) {
+            if (strcmp(value, "deadline") == 0) q->sort = QUERY_SORT_DEADLINE;
+                else if (strcmp(value, "priority") == 0) q->sort = QUERY_SORT_PRIORITY;
+                else if (strcmp(value, "completion") == 0) q->sort = QUERY_SORT_COMPLETION;
+                else return "sort must be deadline, priority or completion";
+        } else if (strcmp(name, "order") == 0) {
+            if (strcmp(value, "asc") != 0 && strcmp(value, "desc") != 0) return "order must be asc or desc";
+            q->descending = (strcmp(value, "desc") == 0);
+        } else if (strcmp(name, "limit") == 0) {
+            if (!parseNumber(value, &q->limit)) return "limit must be a non-negative number";
+        } else {
+            return "unknown field";
+        }
+    }
+    return NULL;
+}
+
+/* runCommand
+ * Syntax Specification:
+ * static int runCommand(Planner p, char **f, int n, int row, FILE *out, int *id, const char **reason);
+ *
+ * Semantic Specification:
+ * Applies one command through the planner API.
+ *
+ * Preconditions:
+ * - 'f' must hold the 'n' fields of the command, the first being its name.
+ *
+ * Postconditions:
+ * - Returns the result of the API (positive on success), or PLANNER_EINVALID
+ *   with '*reason' set when the command itself is malformed.
+ * - '*id' is the id of the task of the command (0 for report, the number of
+ *   tasks found for query).
+ *
+ * Side Effects:
+ * - Modifies the planner; 'report' and 'query' write into 'out'.
+ */
+static int runCommand(Planner p, char **f, int n, int row, FILE *out, int *id, const char **reason) {
+    const char *cmd = f[0];
+    *id = 0;
+
+    if (strcmp(cmd, "add") == 0) {
+        if (n != 7) {
+            *reason = "add expects title, description, course, time, deadline, priority";
+            return PLANNER_EINVALID;
+        }
+        struct taskFields fields = { f[1], f[2], f[3], 0, f[5], f[6] };
+        if (!parseNumber(f[4], &fields.estimatedTime)) {
+            *reason = "time must be a non-negative number of minutes";
+            return PLANNER_EINVALID;
+        }
+        *id = plannerAddTask(p, &fields);
+        return *id;
+    }
+    if (strcmp(cmd, "recur") == 0) {
+        if (n != 9) {
+            *reason = "recur expects title, description, course, time, deadline, priority, days, last deadline";
+            return PLANNER_EINVALID;
+        }
+        struct taskFields fields = { f[1], f[2], f[3], 0, f[5], f[6] };
+        int every;
+        if (!parseNumber(f[4], &fields.estimatedTime)) {
+            *reason = "time must be a non-negative number of minutes";
+            return PLANNER_EINVALID;
+        }
+        if (!parseNumber(f[7], &every) || every == 0) {
+            *reason = "days must be a positive number";
+            return PLANNER_EINVALID;
+        }
+        *id = plannerAddRecurring(p, &fields, every, f[8]);
+        return *id;
+    }
+    if (strcmp(cmd, "stop") == 0) {
+        if (n != 2 || !parseNumber(f[1], id)) {
+            *reason = "stop expects the number of a recurring task";
+            return PLANNER_EINVALID;
+        }
+        int result = plannerStopRecurring(p, *id);
+        if (result == PLANNER_ENOTFOUND) *reason = "recurring task not found";
+        return result;
+    }
+    if (strcmp(cmd, "update") == 0) {
+        struct taskPatch patch;
+        if (n < 2 || n > MAX_FIELDS) {
+            *reason = "update expects a task and up to 8 name=value fields";
+            return PLANNER_EINVALID;
+        }
+        if ((*reason = parsePatch(f + 2, n - 2, &patch)) != NULL) return PLANNER_EINVALID;
+        *id = findTask(p, f[1], false);
+        return (*id < 0) ? *id : plannerUpdate(p, *id, &patch);
+    }
+    if (strcmp(cmd, "complete") == 0) {
+        if (n != 2 && n != 3) {
+            *reason = "complete expects a task and an optional date";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        return (*id < 0) ? *id : plannerComplete(p, *id, n == 3 ? f[2] : NULL);
+    }
+    if (strcmp(cmd, "delete") == 0) {
+        if (n != 2) {
+            *reason = "delete expects a task";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        return (*id < 0) ? *id : plannerDelete(p, *id);
+    }
+    if (strcmp(cmd, "restore") == 0) {
+        if (n != 4) {
+            *reason = "restore expects a task, a deadline and a priority";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], true);
+        return (*id < 0) ? *id : plannerRestore(p, *id, f[2], f[3]);
+    }
+    if (strcmp(cmd, "depend") == 0 || strcmp(cmd, "undepend") == 0) {
+        if (n != 3) {
+            *reason = "depend and undepend expect a task and the task to finish first";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        int prerequisite = findTask(p, f[2], false);
+        if (*id < 0 || prerequisite < 0) return PLANNER_ENOTFOUND;
+        int result = (cmd[0] == 'd') ? plannerAddPrerequisite(p, *id, prerequisite) : plannerRemovePrerequisite(p, *id, prerequisite);
+        if (result == PLANNER_ENOTFOUND && cmd[0] == 'u') *reason = "prerequisite not found";
+        return result;
+    }
+    if (strcmp(cmd, "start") == 0 || strcmp(cmd, "finish") == 0) {
+        if (n != 2) {
+            *reason = "start and finish expect a task";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        if (*id < 0) return *id;
+        int minutes;
+        return (cmd[0] == 's') ? plannerStartStudy(p, *id) : plannerStopStudy(p, *id, &minutes);
+    }
+    if (strcmp(cmd, "studied") == 0) {
+        int minutes;
+        if (n != 3 || !parseNumber(f[2], &minutes)) {
+            *reason = "studied expects a task and the minutes";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        return (*id < 0) ? *id : plannerLogStudy(p, *id, minutes);
+    }
+    if (strcmp(cmd, "time") == 0) {
+        if (n != 2) {
+            *reason = "time expects a task";
+            return PLANNER_EINVALID;
+        }
+        *id = findTask(p, f[1], false);
+        if (*id < 0) return *id;
+        struct taskTime t;
+        int result = plannerStudyTime(p, *id, &t);
+        if (result < 0) return result;
+        // a task no longer in progress is named by its id, and shown without title and estimate
+        Task task = plannerGetTask(p, *id);
+        fprintf(out, "time\t%d\n", row);
+        fprintf(out, "spent\t%d\t%s\t%d\t%ld\t%d\t%d\n", *id, task ? getTitle(task) : "", task ? getExdTime(task) : 0,
+                t.minutes, t.sessions, t.started != 0);
+        fprintf(out, "end\t%d\n", row);
+        return 1;
+    }
+    if (strcmp(cmd, "undo") == 0 || strcmp(cmd, "redo") == 0) {
+        if (n != 1) {
+            *reason = "undo and redo expect no fields";
+            return PLANNER_EINVALID;
+        }
+        *id = (cmd[0] == 'u') ? plannerUndo(p) : plannerRedo(p);
+        if (*id == PLANNER_ENOTFOUND) *reason = (cmd[0] == 'u') ? "nothing to undo" : "nothing to redo";
+        return *id;
+    }
+    if (strcmp(cmd, "report") == 0) {
+        if (n > 2) {
+            *reason = "report expects an optional date";
+            return PLANNER_EINVALID;
+        }
+        // the lines of the report are framed so that they cannot be mistaken for results
+        fprintf(out, "report\t%d\n", row);
+        int result = plannerReport(p, n == 2 ? f[1] : getPreviousMonday(), out);
+        fprintf(out, "end\t%d\n", row);
+        if (result == PLANNER_ENOTFOUND) *reason = "report not found";
+        return result;
+    }
+    if (strcmp(cmd, "query") == 0) {
+        struct taskQuery q;
+        if ((*reason = parseQuery(f + 1, n - 1, &q)) != NULL) return PLANNER_EINVALID;
+        Task *tasks;
+        int numel = plannerQuery(p, &q, &tasks);
+        if (numel < 0) return numel;
+
+        // framed as a report, one task per line
+        fprintf(out, "query\t%d\n", row);
+        for (int i = 0; i < numel; i++) {
+            Task t = tasks[i];
+            fprintf(out, "task\t%d\t%s\t%s\t%s\t%d\t%.2f\n", getId(t), getTitle(t), getCourse(t),
+                    getDeadline(t), getPriority(t), getCompletionPercentage(t));
+        }
+        fprintf(out, "end\t%d\n", row);
+        free(tasks);
+        *id = numel;
+        return 1;
+    }
+    if (strcmp(cmd, "ready") == 0) {
+        int limit = 0;
+        if (n > 2 || (n == 2 && (!parseNumber(f[1], &limit) || limit == 0))) {
+            *reason = "ready expects an optional positive number of tasks";
+            return PLANNER_EINVALID;
+        }
+        // without a limit, room is doubled until every ready task fits
+        int max = limit ? limit : 64, numel;
+        Task *tasks = NULL;
+        do {
+            Task *grown = realloc(tasks, max * sizeof(Task));
+            if (grown == NULL) {
+                free(tasks);
+                return PLANNER_ENOMEM;
+            }
+            tasks = grown;
+            numel = plannerReadyTasks(p, tasks, max);
+            max *= 2;
+        } while (limit == 0 && numel == max / 2);
+        if (numel < 0) {
+            free(tasks);
+            return numel;
+        }
+
+        fprintf(out, "ready\t%d\n", row);
+        for (int i = 0; i < numel; i++) {
+            Task t = tasks[i];
+            fprintf(out, "task\t%d\t%s\t%s\t%s\t%d\t%.2f\n", getId(t), getTitle(t), getCourse(t),
+                    getDeadline(t), getPriority(t), getCompletionPercentage(t));
+        }
+        fprintf(out, "end\t%d\n", row);
+        free(tasks);
+        *id = numel;
+        return 1;
+    }
+    if (strcmp(cmd, "search") == 0) {
+        if (n != 2) {
+            *reason = "search expects the words";
+            return PLANNER_EINVALID;
+        }
+        Task *tasks;
+        int numel = plannerSearchText(p, f[1], &tasks);
+        if (numel < 0) return numel;
+
+        fprintf(out, "search\t%d\n", row);
+        for (int i = 0; i < numel; i++) {
+            Task t = tasks[i];
+            fprintf(out, "task\t%d\t%s\t%s\t%s\t%d\t%.2f\n", getId(t), getTitle(t), getCourse(t),
+                    getDeadline(t), getPriority(t), getCompletionPercentage(t));
+        }
+        fprintf(out, "end\t%d\n", row);
+        free(tasks);
+        *id = numel;
+        return 1;
+    }
+
+    *reason = "unknown command";
+    return PLANNER_EINVALID;
+}
+
+/* runBatch
+ * Syntax Specification:
+ * int runBatch(Planner p, FILE *in, FILE *out);
+ *
+ * Semantic Specification:
+ * Applies the commands read from 'in', one per line with the fields separated by
+ * tabs, and writes one result line per command into 'out':
+ *   add      title  description  course  time  deadline  priority
+ *   update   task   name=value ...   (title, description, course, time, deadline, priority, completion)
+ *   complete task   [date]
+ *   delete   task
+ *   restore  task   deadline  priority
+ *   recur    title  description  course  time  deadline  priority  days  last deadline
+ *   stop     recurring task
+ *   depend   task   task to finish first
+ *   undepend task   task to finish first
+ *   start    task
+ *   finish   task
+ *   studied  task   minutes
+ *   time     task
+ *   undo
+ *   redo
+ *   report   [monday]
+ *   query    name=value ...   (see parseQuery)
+ *   search   words
+ *   ready    [limit]
+ * A task is named by its id or by its title. The results are "ok<TAB>row<TAB>id"
+ * (id of the task or of the recurring task, 0 for report, number of tasks for
+ * query, search and ready, number of tasks changed for undo and redo) and
+ * "error<TAB>row<TAB>reason"; a wrong command is reported and skipped, never
+ * asked again. The lines of a report are written between "report<TAB>row" and
+ * "end<TAB>row", the tasks of a query (or search, or ready) between "query<TAB>row"
+ * (or "search<TAB>row", "ready<TAB>row") and "end<TAB>row" as
+ * "task<TAB>id<TAB>title<TAB>course<TAB>deadline<TAB>priority<TAB>completion".
+ * The time spent on a task is written between "time<TAB>row" and "end<TAB>row" as
+ * "spent<TAB>id<TAB>title<TAB>estimated<TAB>actual<TAB>sessions<TAB>1 if running".
+ * Empty lines and lines starting with '#' are ignored.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'in' readable and 'out' writable.
+ *
+ * Postconditions:
+ * - Returns the number of commands that failed.
+ *
+ * Side Effects:
+ * - Modifies the planner, reads 'in' and writes 'out'.
+ */
+int runBatch(Planner p, FILE *in, FILE *out) {
+    char line[MAX_COMMAND + 2];
+    char *f[MAX_FIELDS];
+    int row = 0, errors = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        row++;
+        int len = strcspn(line, "\r\n");
+        if (line[len] == '\0' && !feof(in)) {
+            int c;
+            while ((c = fgetc(in)) != '\n' && c != EOF);
+            fprintf(out, "error\t%d\tcommand longer than %d characters\n", row, MAX_COMMAND);
+            errors++;
+            continue;
+        }
+        line[len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+
+        int n = splitCommand(line, f, MAX_FIELDS);
+        const char *reason = NULL;
+        int id, result = runCommand(p, f, n, row, out, &id, &reason);
+        if (result > 0) {
+            fprintf(out, "ok\t%d\t%d\n", row, id);
+        } else {
+            fprintf(out, "error\t%d\t%s\n", row, reason != NULL ? reason : plannerError(result));
+            errors++;
+        }
+    }
+    fflush(out);
+    return errors;
+}
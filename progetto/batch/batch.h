@@ -0,0 +1,5 @@
+// Forward declaration of the planner struct
+typedef struct planner *Planner;
+
+ //batch prototypes
+int runBatch(Planner p, FILE *in, FILE *out);
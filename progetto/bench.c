@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "./progress/progress.h"
+
+// Tasks of the batch and repetitions of the measures (the per-task version is far slower)
+#define BENCH_TASKS 100000
+#define BENCH_ROUNDS 200
+#define BENCH_SCALAR_ROUNDS 2
+
+double elapsed(clock_t start);
+void scalarProgress(int numel, const char (*start)[9], const char (*deadline)[9], const float *completion,
+                    float *timeProgress, float *gap);
+
+int main(void){
+    today = "16062025";
+    int numel = BENCH_TASKS, errors = 0;
+    int *start = malloc(numel * sizeof(int)), *deadline = malloc(numel * sizeof(int));
+    char (*startTxt)[9] = malloc(numel * sizeof(*startTxt)), (*deadlineTxt)[9] = malloc(numel * sizeof(*deadlineTxt));
+    float *completion = malloc(numel * sizeof(float)), *timeProgress = malloc(numel * sizeof(float));
+    float *gap = malloc(numel * sizeof(float)), *expected = malloc(numel * sizeof(float)), *expectedGap = malloc(numel * sizeof(float));
+    unsigned char *valid = malloc(numel);
+    if (!start || !deadline || !startTxt || !deadlineTxt || !completion || !timeProgress || !gap || !expected || !expectedGap || !valid) {
+        printf("\nMemory allocation error.");
+        return 1;
+    }
+
+    // tasks started in the last 60 days, due in the next 90
+    srand(1);
+    for (int i = 0; i < numel; i++) {
+        start[i] = dateToDays(today) - rand() % 60;
+        deadline[i] = dateToDays(today) + rand() % 90;
+        daysToDate(start[i], startTxt[i]);
+        daysToDate(deadline[i], deadlineTxt[i]);
+        completion[i] = (float)(rand() % 10001) / 100.0f;
+    }
+
+    clock_t begin = clock();
+    for (int r = 0; r < BENCH_SCALAR_ROUNDS; r++) scalarProgress(numel, startTxt, deadlineTxt, completion, expected, expectedGap);
+    double scalar = elapsed(begin);
+
+    begin = clock();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        progressKernel(numel, start, deadline, completion, dateToDays(today), timeProgress, gap, valid);
+    }
+    double kernel = elapsed(begin);
+
+    for (int i = 0; i < numel; i++) {
+        if (timeProgress[i] != expected[i] || gap[i] != expectedGap[i] || !valid[i]) errors++;
+    }
+
+    double tasks = (double)numel * BENCH_ROUNDS, scalarTasks = (double)numel * BENCH_SCALAR_ROUNDS;
+    printf("\nProgress of %d tasks", numel);
+    printf("\n- per task (compareDates): %8.2f Mtasks/s", scalar > 0 ? scalarTasks / scalar / 1e6 : 0.0);
+    printf("\n- batch kernel:            %8.2f Mtasks/s", kernel > 0 ? tasks / kernel / 1e6 : 0.0);
+    printf("\n- results differing:       %d\n", errors);
+    return errors != 0;
+}
+
+// Seconds of processor time since 'start'
+double elapsed(clock_t start){
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Progress computed one task at a time on the dates, as showTaskProgress used to do
+void scalarProgress(int numel, const char (*start)[9], const char (*deadline)[9], const float *completion,
+                    float *timeProgress, float *gap){
+    for (int i = 0; i < numel; i++) {
+        int totalTime = compareDates(deadline[i], start[i]);
+        int timeSpent = compareDates(today, start[i]);
+        if (totalTime == 0) timeProgress[i] = 100.0;
+            else timeProgress[i] = ((float)timeSpent / totalTime) * 100.0;
+        gap[i] = timeProgress[i] - completion[i];
+    }
+}
@@ -411,6 +411,64 @@ int compareDates(const char *date1, const char *date2) {
     return days1 - days2;
 }
 
+/* dateToDays
+ * Syntax Specification:
+ * int dateToDays(const char *date);
+ *
+ * Semantic Specification:
+ * Same count as totalDays, computed in constant time: used to sort and compare
+ * many dates without parsing them again.
+ *
+ * Preconditions:
+ * - 'date' must be in "ddmmyyyy" format.
+ *
+ * Postconditions:
+ * - Returns the number of days from 01/01/0000 to the date.
+ *
+ * Side Effects:
+ * - None.
+ */
+int dateToDays(const char *date) {
+    int day, month, year;
+    parseData(date, &day, &month, &year);
+
+    // leap years from year 0 to year - 1
+    int days = 365 * year + (year + 3) / 4 - (year + 99) / 100 + (year + 399) / 400;
+    for (int m = 1; m < month; m++) {
+        days += daysInMonth(m, year);
+    }
+    return days + day;
+}
+
+/* daysToDate
+ * Syntax Specification:
+ * void daysToDate(int days, char *date);
+ *
+ * Semantic Specification:
+ * Inverse of dateToDays.
+ *
+ * Preconditions:
+ * - 'days' must be positive, 'date' must have space for 9 characters.
+ *
+ * Postconditions:
+ * - 'date' contains the date in "ddmmyyyy" format.
+ *
+ * Side Effects:
+ * - None.
+ */
+void daysToDate(int days, char *date) {
+    int year = days / 366;
+    while (365 * (year + 1) + (year + 4) / 4 - (year + 100) / 100 + (year + 400) / 400 < days) year++;
+    days -= 365 * year + (year + 3) / 4 - (year + 99) / 100 + (year + 399) / 400;
+
+    int month = 1;
+    while (days > daysInMonth(month, year)) {
+        days -= daysInMonth(month, year);
+        month++;
+    }
+    sprintf(date, "%02d%02d%04d", days, month, year);
+}
+
 char* getLastWeekDate() {
     static char lastWeek[9];
     int day, month, year;
@@ -10,6 +10,8 @@ bool isOnlyDigits(const char *, int);
 
 bool isValidDate(const char *);
 int compareDates(const char *, const char *);
+int dateToDays(const char *);
+void daysToDate(int, char *);
 void printDate(const char *);
 void fprintDate(FILE *reportFile, const char *date);
 char *getCurrentDateAT();
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include "codec.h"
+
+/* Block format: a sequence of tokens.
+ * - 0x00..0x7F: literal run, followed by (token + 1) raw bytes.
+ * - 0x80..0xFF: match of (token - 0x80 + MIN_MATCH) bytes, followed by a 2 byte
+ *   little-endian distance back into the output (or into the dictionary before it).
+ */
+#define MIN_MATCH 4
+#define MAX_MATCH (0x7F + MIN_MATCH)
+#define MAX_LITERALS 0x80
+#define MAX_DISTANCE 0xFFFF
+#define HASH_BITS 12
+
+static unsigned int hash4(const unsigned char *p) {
+    unsigned int v = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/* flushLiterals
+ * Syntax Specification:
+ * static int flushLiterals(const unsigned char *lit, int n, unsigned char *dst, int pos, int cap);
+ *
+ * Semantic Specification:
+ * Emits 'n' pending literal bytes as one or more literal runs.
+ *
+ * Preconditions:
+ * - 'dst' must have 'cap' bytes of space.
+ *
+ * Postconditions:
+ * - Returns the new output position, or -1 if the output is full.
+ *
+ * Side Effects:
+ * - Writes into 'dst'.
+ */
+static int flushLiterals(const unsigned char *lit, int n, unsigned char *dst, int pos, int cap) {
+    while (n > 0) {
+        int run = (n > MAX_LITERALS) ? MAX_LITERALS : n;
+        if (pos + 1 + run > cap) return -1;
+        dst[pos++] = run - 1;
+        memcpy(dst + pos, lit, run);
+        pos += run;
+        lit += run;
+        n -= run;
+    }
+    return pos;
+}
+
+/* compressBlock
+ * Syntax Specification:
+ * int compressBlock(const char *src, int len, char *dst, int cap, const char *dict, int dictLen);
+ *
+ * Semantic Specification:
+ * Compresses a block with a greedy LZ77 scheme. Matches may also refer to an optional
+ * preset dictionary, which must be passed unchanged to decompressBlock.
+ *
+ * Preconditions:
+ * - 'src' holds 'len' bytes, 'dst' has 'cap' bytes of space.
+ * - 'dict' can be NULL when 'dictLen' is 0.
+ *
+ * Postconditions:
+ * - Returns the compressed size, or -1 if it does not fit in 'cap' bytes.
+ *
+ * Side Effects:
+ * - Allocates temporary memory.
+ */
+int compressBlock(const char *src, int len, char *dst, int cap, const char *dict, int dictLen) {
+    int total = dictLen + len;
+    unsigned char *buffer = malloc(total + 1);
+    int *table = malloc((1 << HASH_BITS) * sizeof(int));
+    if (buffer == NULL || table == NULL) {
+        free(buffer);
+        free(table);
+        return -1;
+    }
+    if (dictLen > 0) memcpy(buffer, dict, dictLen);
+    memcpy(buffer + dictLen, src, len);
+    for (int i = 0; i < (1 << HASH_BITS); i++) table[i] = -1;
+    for (int i = 0; i + MIN_MATCH <= dictLen; i++) table[hash4(buffer + i)] = i;
+
+    unsigned char *out = (unsigned char *)dst;
+    int pos = 0, i = dictLen, literal = dictLen;
+    while (i + MIN_MATCH <= total && pos >= 0) {
+        unsigned int h = hash4(buffer + i);
+        int candidate = table[h];
+        table[h] = i;
+
+        int matchLen = 0;
+        if (candidate >= 0 && i - candidate <= MAX_DISTANCE) {
+            while (i + matchLen < total && matchLen < MAX_MATCH &&
+                   buffer[candidate + matchLen] == buffer[i + matchLen]) {
+                matchLen++;
+            }
+        }
+
+        if (matchLen < MIN_MATCH) {
+            i++;
+            continue;
+        }
+
+        pos = flushLiterals(buffer + literal, i - literal, out, pos, cap);
+        if (pos < 0 || pos + 3 > cap) {
+            pos = -1;
+            break;
+        }
+        int distance = i - candidate;
+        out[pos++] = 0x80 | (matchLen - MIN_MATCH);
+        out[pos++] = distance & 0xFF;
+        out[pos++] = distance >> 8;
+
+        for (int k = i + 1; k < i + matchLen && k + MIN_MATCH <= total; k++) {
+            table[hash4(buffer + k)] = k;
+        }
+        i += matchLen;
+        literal = i;
+    }
+    if (pos >= 0) pos = flushLiterals(buffer + literal, total - literal, out, pos, cap);
+
+    free(buffer);
+    free(table);
+    return pos;
+}
+
+/* decompressBlock
+ * Syntax Specification:
+ * int decompressBlock(const char *src, int len, char *dst, int rawLen, const char *dict, int dictLen);
+ *
+ * Semantic Specification:
+ * Restores a block produced by compressBlock with the same dictionary.
+ *
+ * Preconditions:
+ * - 'dst' must have 'rawLen' bytes of space.
+ *
+ * Postconditions:
+ * - Returns 'rawLen' on success, -1 if the block is corrupted.
+ *
+ * Side Effects:
+ * - Allocates temporary memory.
+ */
+int decompressBlock(const char *src, int len, char *dst, int rawLen, const char *dict, int dictLen) {
+    unsigned char *buffer = malloc(dictLen + rawLen + 1);
+    if (buffer == NULL) return -1;
+    if (dictLen > 0) memcpy(buffer, dict, dictLen);
+
+    const unsigned char *in = (const unsigned char *)src;
+    int i = 0, out = dictLen, end = dictLen + rawLen;
+    while (i < len) {
+        int token = in[i++];
+        if (token < 0x80) {
+            int run = token + 1;
+            if (i + run > len || out + run > end) break;
+            memcpy(buffer + out, in + i, run);
+            i += run;
+            out += run;
+        } else {
+            if (i + 2 > len) break;
+            int matchLen = (token & 0x7F) + MIN_MATCH;
+            int distance = in[i] | (in[i + 1] << 8);
+            i += 2;
+            if (distance == 0 || distance > out || out + matchLen > end) break;
+            // byte by byte: the match may overlap the bytes it produces
+            for (int k = 0; k < matchLen; k++, out++) buffer[out] = buffer[out - distance];
+        }
+    }
+
+    int result = (i == len && out == end) ? rawLen : -1;
+    if (result > 0) memcpy(dst, buffer + dictLen, rawLen);
+    free(buffer);
+    return result;
+}
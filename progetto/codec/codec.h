@@ -0,0 +1,3 @@
+ //codec prototypes
+int compressBlock(const char *src, int len, char *dst, int cap, const char *dict, int dictLen);
+int decompressBlock(const char *src, int len, char *dst, int rawLen, const char *dict, int dictLen);
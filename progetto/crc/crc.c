@@ -0,0 +1,122 @@
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include "crc.h"
+
+// CRC32C (Castagnoli), reflected polynomial
+#define CRC32C_POLY 0x82F63B78u
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <nmmintrin.h>
+    #define HAVE_CRC_INSTRUCTION
+#endif
+
+static unsigned int table[256];
+// built once, also when the first CRCs are computed by several threads at the same time
+static pthread_once_t tableOnce = PTHREAD_ONCE_INIT;
+
+/* buildTable
+ * Syntax Specification:
+ * static void buildTable(void);
+ *
+ * Semantic Specification:
+ * Fills the lookup table used by the portable implementation.
+ *
+ * Preconditions:
+ * - None.
+ *
+ * Postconditions:
+ * - 'table' holds the CRC of every byte value.
+ *
+ * Side Effects:
+ * - Modifies the static table.
+ */
+static void buildTable(void) {
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        table[i] = c;
+    }
+}
+
+static unsigned int crc32cTable(unsigned int crc, const unsigned char *p, size_t len) {
+    pthread_once(&tableOnce, buildTable);
+    while (len--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef HAVE_CRC_INSTRUCTION
+/* crc32cHardware
+ * Syntax Specification:
+ * static unsigned int crc32cHardware(unsigned int crc, const unsigned char *p, size_t len);
+ *
+ * Semantic Specification:
+ * Same as crc32cTable, using the SSE 4.2 crc32 instruction 8 (or 4) bytes at a time.
+ *
+ * Preconditions:
+ * - The CPU must support SSE 4.2.
+ *
+ * Postconditions:
+ * - Returns the updated CRC.
+ *
+ * Side Effects:
+ * - None.
+ */
+__attribute__((target("sse4.2")))
+static unsigned int crc32cHardware(unsigned int crc, const unsigned char *p, size_t len) {
+#ifdef __x86_64__
+    unsigned long long c = crc;
+    while (len >= 8) {
+        unsigned long long v;
+        memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = (unsigned int)c;
+#endif
+    while (len >= 4) {
+        unsigned int v;
+        memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+static int hardware;
+static pthread_once_t cpuOnce = PTHREAD_ONCE_INIT;
+
+static void detectCpu(void) {
+    hardware = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+}
+#endif
+
+/* crc32c
+ * Syntax Specification:
+ * unsigned int crc32c(unsigned int crc, const void *data, size_t len);
+ *
+ * Semantic Specification:
+ * Updates a CRC32C with 'len' bytes. Start from 0; the CRC of consecutive pieces
+ * can be computed by passing the previous result. Uses the CPU instruction when
+ * available, a lookup table otherwise.
+ *
+ * Preconditions:
+ * - 'data' must hold 'len' bytes.
+ *
+ * Postconditions:
+ * - Returns the updated CRC.
+ *
+ * Side Effects:
+ * - None.
+ */
+unsigned int crc32c(unsigned int crc, const void *data, size_t len) {
+    crc = ~crc;
+#ifdef HAVE_CRC_INSTRUCTION
+    pthread_once(&cpuOnce, detectCpu);
+    if (hardware) return ~crc32cHardware(crc, data, len);
+#endif
+    return ~crc32cTable(crc, data, len);
+}
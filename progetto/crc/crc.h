@@ -0,0 +1,4 @@
+#include <stddef.h>
+
+ //crc prototypes
+unsigned int crc32c(unsigned int crc, const void *data, size_t len);
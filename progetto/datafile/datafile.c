@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "datafile.h"
+#include "../task/task.h"
+#include "../crc/crc.h"
+
+// The header has a fixed width, so it can be rewritten once the CRC is known
+#define HEADER_FORMAT "#PSD\t%d\t%010d\t%08x\t%010d\n"
+
+struct dataWriter {
+    FILE *f;
+    int count;           // records announced in the header
+    int lastId;          // id counter saved in the header
+    int written;
+    int inBlock;         // records of the current block
+    unsigned int crc;    // CRC of all records
+    unsigned int blockCrc;
+    bool failed;
+};
+
+struct dataReader {
+    FILE *f;
+    int version;
+    int count;           // -1 for files without header
+    unsigned int expectedCrc;
+    unsigned int crc;
+    Task block[DATA_BLOCK_RECORDS]; // verified block waiting to be returned
+    int numel;
+    int next;
+    int records;
+    bool valid;
+    bool end;
+};
+
+/* isHeaderLine
+ * Syntax Specification:
+ * bool isHeaderLine(const char *line, int *count, unsigned int *crc, int *lastId);
+ *
+ * Semantic Specification:
+ * Recognizes the header line of a data file and extracts its fields
+ * ('lastId' is 0 for version 2 headers).
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns true if 'line' is a header this version can read, filling 'count',
+ *   'crc' and 'lastId'; headers of newer versions are not recognized.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool isHeaderLine(const char *line, int *count, unsigned int *crc, int *lastId) {
+    int version;
+    *lastId = 0;
+    return strncmp(line, "#PSD\t", 5) == 0 &&
+           sscanf(line + 5, "%d\t%d\t%x\t%d", &version, count, crc, lastId) >= 3 &&
+           version <= DATA_FILE_VERSION;
+}
+
+/* isBlockLine
+ * Syntax Specification:
+ * bool isBlockLine(const char *line, unsigned int *crc);
+ *
+ * Semantic Specification:
+ * Recognizes the checksum line closing a block of records.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns true if 'line' closes a block, filling 'crc'.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool isBlockLine(const char *line, unsigned int *crc) {
+    return strncmp(line, "#B\t", 3) == 0 && sscanf(line + 3, "%x", crc) == 1;
+}
+
+/* beginDataFile
+ * Syntax Specification:
+ * DataWriter beginDataFile(const char *filename, int count, int lastId);
+ *
+ * Semantic Specification:
+ * Creates a data file that will contain 'count' records and writes a provisional
+ * header. 'lastId' is the id counter saved in the header: it is passed by the
+ * caller, since the counter may change while another thread writes the file.
+ *
+ * Preconditions:
+ * - 'filename' must not be NULL, 'count' >= 0, 'lastId' >= every id written.
+ *
+ * Postconditions:
+ * - Returns a writer, or NULL if the file cannot be created.
+ *
+ * Side Effects:
+ * - Creates or overwrites a file, allocates memory.
+ */
+DataWriter beginDataFile(const char *filename, int count, int lastId) {
+    DataWriter w = malloc(sizeof(struct dataWriter));
+    if (w == NULL) return NULL;
+
+    w->f = fopen(filename, "w");
+    if (w->f == NULL) {
+        free(w);
+        return NULL;
+    }
+    w->count = count;
+    w->lastId = lastId;
+    w->written = 0;
+    w->inBlock = 0;
+    w->crc = 0;
+    w->blockCrc = 0;
+    w->failed = fprintf(w->f, HEADER_FORMAT, DATA_FILE_VERSION, count, 0u, lastId) < 0;
+    return w;
+}
+
+/* writeRecord
+ * Syntax Specification:
+ * int writeRecord(DataWriter w, Task t);
+ *
+ * Semantic Specification:
+ * Appends a task to the data file, closing the block every DATA_BLOCK_RECORDS records.
+ *
+ * Preconditions:
+ * - 'w' must be a writer returned by beginDataFile, 't' a valid Task.
+ *
+ * Postconditions:
+ * - Returns 1 if the record was written, 0 otherwise.
+ *
+ * Side Effects:
+ * - Writes into the file.
+ */
+int writeRecord(DataWriter w, Task t) {
+    char line[DATA_MAX_LINE];
+    int len = sPrintTask(t, line, sizeof(line));
+    if (w == NULL || len < 0) {
+        if (w != NULL) w->failed = true;
+        return 0;
+    }
+
+    w->crc = crc32c(w->crc, line, len);
+    w->blockCrc = crc32c(w->blockCrc, line, len);
+    if (fprintf(w->f, "%s\n", line) < 0) w->failed = true;
+    w->written++;
+
+    if (++w->inBlock == DATA_BLOCK_RECORDS) {
+        if (fprintf(w->f, "#B\t%08x\n", w->blockCrc) < 0) w->failed = true;
+        w->inBlock = 0;
+        w->blockCrc = 0;
+    }
+    return !w->failed;
+}
+
+/* endDataFile
+ * Syntax Specification:
+ * int endDataFile(DataWriter w);
+ *
+ * Semantic Specification:
+ * Closes the last block, writes the final header with the CRC of all the records
+ * and closes the file.
+ *
+ * Preconditions:
+ * - 'w' must be a writer returned by beginDataFile.
+ *
+ * Postconditions:
+ * - Returns 1 if every write succeeded and the number of records matches the header.
+ *
+ * Side Effects:
+ * - Writes into and closes the file, frees the writer.
+ */
+int endDataFile(DataWriter w) {
+    if (w == NULL) return 0;
+
+    if (w->inBlock > 0 && fprintf(w->f, "#B\t%08x\n", w->blockCrc) < 0) w->failed = true;
+    if (fseek(w->f, 0, SEEK_SET) != 0 ||
+        fprintf(w->f, HEADER_FORMAT, DATA_FILE_VERSION, w->written, w->crc, w->lastId) < 0) {
+        w->failed = true;
+    }
+    if (fclose(w->f) != 0) w->failed = true;
+
+    int ok = !w->failed && w->written == w->count;
+    if (!ok) fprintf(stderr, "\nFile was not updated correctly\n");
+    free(w);
+    return ok;
+}
+
+/* readLine
+ * Syntax Specification:
+ * static bool readLine(FILE *f, char *line, int *len);
+ *
+ * Semantic Specification:
+ * Reads the next line, without terminators.
+ *
+ * Preconditions:
+ * - 'line' must have DATA_MAX_LINE bytes of space.
+ *
+ * Postconditions:
+ * - Returns false at the end of the file.
+ *
+ * Side Effects:
+ * - Reads from file.
+ */
+static bool readLine(FILE *f, char *line, int *len) {
+    if (fgets(line, DATA_MAX_LINE, f) == NULL) return false;
+    *len = strcspn(line, "\r\n");
+    line[*len] = '\0';
+    return true;
+}
+
+/* openDataFile
+ * Syntax Specification:
+ * DataReader openDataFile(FILE *f);
+ *
+ * Semantic Specification:
+ * Starts reading a data file, parsing its header if present. A file written by a
+ * newer version is not read at all: its records may not match the task format.
+ *
+ * Preconditions:
+ * - 'f' must be a file open for reading.
+ *
+ * Postconditions:
+ * - Returns a reader, or NULL if memory is not available.
+ * - The reader of a newer file returns no record and fails closeDataFile.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+DataReader openDataFile(FILE *f) {
+    DataReader r = malloc(sizeof(struct dataReader));
+    if (r == NULL) return NULL;
+
+    r->f = f;
+    r->version = 1;
+    r->count = -1;
+    r->expectedCrc = 0;
+    r->crc = 0;
+    r->numel = 0;
+    r->next = 0;
+    r->records = 0;
+    r->valid = true;
+    r->end = false;
+
+    char line[DATA_MAX_LINE];
+    int len, lastId;
+    long start = ftell(f);
+    bool read = readLine(f, line, &len);
+    if (read && isHeaderLine(line, &r->count, &r->expectedCrc, &lastId)) {
+        r->version = DATA_FILE_VERSION;
+        reserveTaskIds(lastId);
+    } else if (read && strncmp(line, "#PSD\t", 5) == 0) {
+        // header of a newer version
+        r->version = DATA_FILE_VERSION;
+        r->count = 0;
+        r->valid = false;
+        r->end = true;
+    } else {
+        fseek(f, start, SEEK_SET);
+        r->count = -1;
+    }
+    return r;
+}
+
+/* getRecordCount
+ * Syntax Specification:
+ * int getRecordCount(DataReader r);
+ *
+ * Semantic Specification:
+ * Returns the number of records announced by the header, so that the caller
+ * can allocate its structures once.
+ *
+ * Preconditions:
+ * - 'r' must be a valid reader.
+ *
+ * Postconditions:
+ * - Returns the count, or -1 if the file has no header.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getRecordCount(DataReader r) {
+    return (r != NULL) ? r->count : -1;
+}
+
+/* fillBlock
+ * Syntax Specification:
+ * static void fillBlock(DataReader r);
+ *
+ * Semantic Specification:
+ * Reads the next block and keeps its tasks only if the block checksum matches.
+ *
+ * Preconditions:
+ * - 'r' must be a reader of a file with header, with no pending tasks.
+ *
+ * Postconditions:
+ * - 'block' holds the tasks of the next valid block, or 'end' is set.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory, marks the reader invalid on errors.
+ */
+static void fillBlock(DataReader r) {
+    char line[DATA_MAX_LINE];
+    int len;
+    unsigned int blockCrc = 0, expected, fileCrc = r->crc;
+    r->numel = r->next = 0;
+
+    while (readLine(r->f, line, &len)) {
+        if (isBlockLine(line, &expected)) {
+            if (expected == blockCrc && r->numel > 0) {
+                r->crc = fileCrc;
+                return;
+            }
+            // damaged block: its records are dropped, the following ones are still read
+            for (int i = 0; i < r->numel; i++) freeTask(r->block[i]);
+            r->numel = 0;
+            r->valid = false;
+            blockCrc = 0;
+            fileCrc = r->crc;
+            continue;
+        }
+
+        blockCrc = crc32c(blockCrc, line, len);
+        fileCrc = crc32c(fileCrc, line, len);
+        Task t = (r->numel < DATA_BLOCK_RECORDS) ? sReadTask(line) : NULL;
+        if (t == NULL) {
+            r->valid = false;
+            continue;
+        }
+        r->block[r->numel++] = t;
+    }
+
+    // end of file: a block without its checksum line was truncated
+    if (r->numel > 0) {
+        for (int i = 0; i < r->numel; i++) freeTask(r->block[i]);
+        r->numel = 0;
+        r->valid = false;
+    }
+    r->end = true;
+}
+
+/* readRecord
+ * Syntax Specification:
+ * Task readRecord(DataReader r);
+ *
+ * Semantic Specification:
+ * Returns the next task of the file. With a header, tasks are returned only
+ * after the checksum of their block has been verified.
+ *
+ * Preconditions:
+ * - 'r' must be a valid reader.
+ *
+ * Postconditions:
+ * - Returns a new Task with its id registered, or NULL at the end of the file.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+Task readRecord(DataReader r) {
+    if (r == NULL) return NULL;
+
+    if (r->version == 1) {
+        Task t = fReadTask(r->f);
+        if (t != NULL) r->records++;
+        return assignTaskId(t);
+    }
+
+    if (r->next == r->numel) {
+        if (r->end) return NULL;
+        fillBlock(r);
+        if (r->numel == 0) return NULL;
+    }
+    r->records++;
+    return assignTaskId(r->block[r->next++]);
+}
+
+/* closeDataFile
+ * Syntax Specification:
+ * bool closeDataFile(DataReader r);
+ *
+ * Semantic Specification:
+ * Finishes reading: checks the record count and the CRC of the whole file
+ * against the header, then closes the file.
+ *
+ * Preconditions:
+ * - 'r' must be a valid reader; all the records should have been read.
+ *
+ * Postconditions:
+ * - Returns true if the file passed every check (always for files without header).
+ *
+ * Side Effects:
+ * - Closes the file, frees the reader and any task not returned.
+ */
+bool closeDataFile(DataReader r) {
+    if (r == NULL) return false;
+
+    bool valid = r->valid;
+    if (r->version != 1) {
+        valid = valid && r->end && r->records == r->count && r->crc == r->expectedCrc;
+    }
+    for (int i = r->next; i < r->numel; i++) freeTask(r->block[i]);
+    fclose(r->f);
+    free(r);
+    return valid;
+}
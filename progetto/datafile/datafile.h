@@ -0,0 +1,30 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Layout of the data files (version 3):
+//   #PSD <version> <record count> <CRC32C of all records> <last task id>
+//   up to DATA_BLOCK_RECORDS task lines, then  #B <CRC32C of the block>
+//   ... more blocks ...
+// Fields are tab separated; CRCs cover the record lines without terminators.
+// Since version 3 every record ends with the task id.
+// Files without header (version 1) are still read, without any check.
+#define DATA_FILE_VERSION 3
+#define DATA_BLOCK_RECORDS 256
+#define DATA_MAX_LINE 1024
+
+typedef struct dataWriter *DataWriter;
+typedef struct dataReader *DataReader;
+
+ //data file prototypes
+DataWriter beginDataFile(const char *filename, int count, int lastId);
+int writeRecord(DataWriter w, Task t);
+int endDataFile(DataWriter w);
+
+DataReader openDataFile(FILE *f);
+int getRecordCount(DataReader r);
+Task readRecord(DataReader r);
+bool closeDataFile(DataReader r);
+
+bool isHeaderLine(const char *line, int *count, unsigned int *crc, int *lastId);
+bool isBlockLine(const char *line, unsigned int *crc);
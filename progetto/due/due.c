@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "due.h"
+
+// Tasks due on one day
+struct bucket {
+    Task *tasks;
+    int numel;
+    int tot;
+};
+
+struct dueView {
+    int first;              // day of days[0], in days (see dateToDays): today
+    struct bucket *days;    // days[i] holds the tasks due on day first + i
+    int numDays;
+    int tot;
+};
+
+/* newDueView
+ * Syntax Specification:
+ * DueView newDueView(void);
+ *
+ * Semantic Specification:
+ * Creates an empty view starting today. The tasks are then added with trackDue,
+ * and the view is kept up to date at every change.
+ *
+ * Preconditions:
+ * - The global 'today' must be initialized.
+ *
+ * Postconditions:
+ * - Returns the new view, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+DueView newDueView(void) {
+    DueView v = calloc(1, sizeof(struct dueView));
+    if (v == NULL) return NULL;
+    v->first = dateToDays(today);
+    return v;
+}
+
+void freeDueView(DueView v) {
+    if (v == NULL) return;
+    for (int i = 0; i < v->numDays; i++) free(v->days[i].tasks);
+    free(v->days);
+    free(v);
+}
+
+/* rollDueView
+ * Syntax Specification:
+ * void rollDueView(DueView v);
+ *
+ * Semantic Specification:
+ * Moves the first day of the view to today when the date has changed. The
+ * buckets of the past days are dropped (their tasks are expired); the others
+ * are kept as they are.
+ *
+ * Preconditions:
+ * - 'v' must be valid, the global 'today' must be initialized.
+ *
+ * Postconditions:
+ * - getDueTasks(v, 0, ...) returns the tasks due today.
+ *
+ * Side Effects:
+ * - Frees the dropped buckets.
+ */
+void rollDueView(DueView v) {
+    int shift = dateToDays(today) - v->first;
+    if (shift <= 0) return;
+
+    if (shift > v->numDays) shift = v->numDays;
+    for (int i = 0; i < shift; i++) free(v->days[i].tasks);
+    memmove(v->days, v->days + shift, (v->numDays - shift) * sizeof(struct bucket));
+    v->numDays -= shift;
+    v->first = dateToDays(today);
+}
+
+/* findBucket
+ * Syntax Specification:
+ * static struct bucket *findBucket(DueView v, Task t, bool add);
+ *
+ * Semantic Specification:
+ * Returns the bucket of the deadline of the task; if 'add' is true the missing
+ * days up to it are added.
+ *
+ * Preconditions:
+ * - 'v' and 't' must be valid.
+ *
+ * Postconditions:
+ * - Returns the bucket, or NULL if the deadline is past, the day is not in the
+ *   view (and not added) or memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static struct bucket *findBucket(DueView v, Task t, bool add) {
+    int day = dateToDays(getDeadline(t)) - v->first;
+    if (day < 0) return NULL;
+    if (day < v->numDays) return &v->days[day];
+    if (!add) return NULL;
+
+    if (day >= v->tot) {
+        int tot = v->tot ? v->tot : 16;
+        while (tot <= day) tot *= 2;
+        struct bucket *days = realloc(v->days, tot * sizeof(struct bucket));
+        if (days == NULL) return NULL;
+        v->days = days;
+        v->tot = tot;
+    }
+    memset(&v->days[v->numDays], 0, (day + 1 - v->numDays) * sizeof(struct bucket));
+    v->numDays = day + 1;
+    return &v->days[day];
+}
+
+/* trackDue
+ * Syntax Specification:
+ * void trackDue(DueView v, Task t);
+ *
+ * Semantic Specification:
+ * Adds a task in progress to the bucket of its deadline.
+ *
+ * Preconditions:
+ * - 't' must be valid and not in the view; 'v' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The task is in the bucket of its deadline, unless the deadline is past.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+void trackDue(DueView v, Task t) {
+    if (v == NULL || t == NULL) return;
+
+    struct bucket *b = findBucket(v, t, true);
+    if (b == NULL) return;
+    if (b->numel == b->tot) {
+        int tot = b->tot ? b->tot * 2 : 4;
+        Task *tasks = realloc(b->tasks, tot * sizeof(Task));
+        if (tasks == NULL) return;
+        b->tasks = tasks;
+        b->tot = tot;
+    }
+    b->tasks[b->numel++] = t;
+}
+
+/* untrackDue
+ * Syntax Specification:
+ * void untrackDue(DueView v, Task t);
+ *
+ * Semantic Specification:
+ * Removes a task from the bucket of its deadline. Must be called before the
+ * deadline is changed, since it is used to find the bucket.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'v' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The task is no longer in the view.
+ *
+ * Side Effects:
+ * - None.
+ */
+void untrackDue(DueView v, Task t) {
+    if (v == NULL || t == NULL) return;
+
+    struct bucket *b = findBucket(v, t, false);
+    if (b == NULL) return;
+    for (int i = 0; i < b->numel; i++) {
+        if (b->tasks[i] == t) {
+            // the order of a bucket is the order of insertion
+            memmove(&b->tasks[i], &b->tasks[i + 1], (b->numel - i - 1) * sizeof(Task));
+            b->numel--;
+            return;
+        }
+    }
+}
+
+/* getDueTasks
+ * Syntax Specification:
+ * int getDueTasks(DueView v, int day, Task **tasks);
+ *
+ * Semantic Specification:
+ * Returns the tasks due 'day' days from today (0 today, 1 tomorrow, ...),
+ * without visiting the other tasks.
+ *
+ * Preconditions:
+ * - 'v' must be valid and rolled to today (see rollDueView), 'day' >= 0.
+ *
+ * Postconditions:
+ * - '*tasks' points to an array owned by 'v', valid until the next change.
+ * - Returns the number of tasks.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getDueTasks(DueView v, int day, Task **tasks) {
+    *tasks = NULL;
+    if (day < 0 || day >= v->numDays) return 0;
+    *tasks = v->days[day].tasks;
+    return v->days[day].numel;
+}
@@ -0,0 +1,16 @@
+#include "../task/task.h"
+
+// Tasks in progress bucketed by deadline: one bucket per day from today on
+
+// Forward declaration of the view struct
+typedef struct dueView *DueView;
+
+ //due view prototypes
+DueView newDueView(void);
+void freeDueView(DueView v);
+void rollDueView(DueView v);
+
+void trackDue(DueView v, Task t);
+void untrackDue(DueView v, Task t);
+
+int getDueTasks(DueView v, int day, Task **tasks);
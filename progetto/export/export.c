@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "export.h"
+#include "../task/task.h"
+
+// Exports are written through a large stdio buffer, one record at a time
+#define EXPORT_BUFFER (1 << 20)
+
+/* openExport
+ * Syntax Specification:
+ * FILE *openExport(const char *filename);
+ *
+ * Semantic Specification:
+ * Creates an export file with a large write buffer. Close it with fclose.
+ *
+ * Preconditions:
+ * - 'filename' must not be NULL.
+ *
+ * Postconditions:
+ * - Returns the open file, or NULL on error.
+ *
+ * Side Effects:
+ * - Creates or overwrites a file.
+ */
+FILE *openExport(const char *filename) {
+    FILE *f = fopen(filename, "w");
+    if (f == NULL) {
+        fprintf(stderr, "\nError: unable to create '%s'.\n", filename);
+        return NULL;
+    }
+    setvbuf(f, NULL, _IOFBF, EXPORT_BUFFER);
+    return f;
+}
+
+/* writeJSONString
+ * Syntax Specification:
+ * static void writeJSONString(FILE *f, const char *s);
+ *
+ * Semantic Specification:
+ * Writes a quoted JSON string, escaping quotes, backslashes and control characters.
+ *
+ * Preconditions:
+ * - 'f' must be writable, 's' a null-terminated string.
+ *
+ * Postconditions:
+ * - The string is written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+static void writeJSONString(FILE *f, const char *s) {
+    putc('"', f);
+    for (; *s != '\0'; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') {
+            putc('\\', f);
+            putc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            putc(c, f);
+        }
+    }
+    putc('"', f);
+}
+
+/* writeCSVField
+ * Syntax Specification:
+ * static void writeCSVField(FILE *f, const char *s);
+ *
+ * Semantic Specification:
+ * Writes a CSV field, quoting it when it contains separators, quotes or newlines.
+ *
+ * Preconditions:
+ * - 'f' must be writable, 's' a null-terminated string.
+ *
+ * Postconditions:
+ * - The field is written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+static void writeCSVField(FILE *f, const char *s) {
+    if (strpbrk(s, ",\"\r\n") == NULL) {
+        fputs(s, f);
+        return;
+    }
+    putc('"', f);
+    for (; *s != '\0'; s++) {
+        if (*s == '"') putc('"', f);
+        putc(*s, f);
+    }
+    putc('"', f);
+}
+
+/* isoDate
+ * Syntax Specification:
+ * static const char *isoDate(const char *date, char *buffer);
+ *
+ * Semantic Specification:
+ * Converts a "ddmmyyyy" date into "yyyy-mm-dd"; the "00000000" placeholder becomes "".
+ *
+ * Preconditions:
+ * - 'buffer' must have space for 11 characters.
+ *
+ * Postconditions:
+ * - Returns 'buffer'.
+ *
+ * Side Effects:
+ * - None.
+ */
+static const char *isoDate(const char *date, char *buffer) {
+    if (strcmp(date, "00000000") == 0) {
+        buffer[0] = '\0';
+    } else {
+        sprintf(buffer, "%.4s-%.2s-%.2s", date + 4, date + 2, date);
+    }
+    return buffer;
+}
+
+static const char *priorityName(int priority) {
+    switch (priority) {
+        case 1: return "low";
+        case 2: return "medium";
+        case 3: return "high";
+        default: return "undefined";
+    }
+}
+
+/* exportTaskHeader
+ * Syntax Specification:
+ * void exportTaskHeader(FILE *f, int format);
+ *
+ * Semantic Specification:
+ * Writes the column names of the task export; JSON Lines needs no header.
+ *
+ * Preconditions:
+ * - 'f' must be writable.
+ *
+ * Postconditions:
+ * - The header is written for EXPORT_CSV.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+void exportTaskHeader(FILE *f, int format) {
+    if (format == EXPORT_CSV) {
+        fputs("state,title,description,course,estimated_minutes,start_date,deadline,"
+              "completion_percentage,completion_date,priority\n", f);
+    }
+}
+
+/* exportTask
+ * Syntax Specification:
+ * void exportTask(FILE *f, Task t, const char *state, int format);
+ *
+ * Semantic Specification:
+ * Writes one task as a JSON object on its own line or as a CSV row. Dates are in
+ * ISO format, a missing completion date is null (JSON) or empty (CSV).
+ *
+ * Preconditions:
+ * - 'f' must be writable, 't' a valid Task.
+ * - 'state' is "in_progress", "completed" or "expired".
+ *
+ * Postconditions:
+ * - One record is written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+void exportTask(FILE *f, Task t, const char *state, int format) {
+    char start[11], deadline[11], completion[11];
+    isoDate(getStartDate(t), start);
+    isoDate(getDeadline(t), deadline);
+    isoDate(getCompletionDate(t), completion);
+
+    if (format == EXPORT_JSON) {
+        fprintf(f, "{\"state\":\"%s\",\"title\":", state);
+        writeJSONString(f, getTitle(t));
+        fputs(",\"description\":", f);
+        writeJSONString(f, getDescription(t));
+        fputs(",\"course\":", f);
+        writeJSONString(f, getCourse(t));
+        fprintf(f, ",\"estimated_minutes\":%d,\"start_date\":\"%s\",\"deadline\":\"%s\","
+                   "\"completion_percentage\":%.2f,\"completion_date\":",
+                getExdTime(t), start, deadline, getCompletionPercentage(t));
+        if (completion[0] == '\0') fputs("null", f);
+        else fprintf(f, "\"%s\"", completion);
+        fprintf(f, ",\"priority\":\"%s\"}\n", priorityName(getPriority(t)));
+    } else {
+        fprintf(f, "%s,", state);
+        writeCSVField(f, getTitle(t));
+        putc(',', f);
+        writeCSVField(f, getDescription(t));
+        putc(',', f);
+        writeCSVField(f, getCourse(t));
+        fprintf(f, ",%d,%s,%s,%.2f,%s,%s\n", getExdTime(t), start, deadline,
+                getCompletionPercentage(t), completion, priorityName(getPriority(t)));
+    }
+}
+
+/* exportSummary
+ * Syntax Specification:
+ * void exportSummary(FILE *f, const struct weekSummary *s, int format);
+ *
+ * Semantic Specification:
+ * Writes the aggregates of the weekly report as one JSON line, or as a CSV table
+ * with header and a single row.
+ *
+ * Preconditions:
+ * - 'f' must be writable, 's' must not be NULL.
+ *
+ * Postconditions:
+ * - The aggregates are written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+void exportSummary(FILE *f, const struct weekSummary *s, int format) {
+    char monday[11], today[11];
+    isoDate(s->monday, monday);
+    isoDate(s->today, today);
+
+    if (format == EXPORT_JSON) {
+        fprintf(f, "{\"week_start\":\"%s\",\"date\":\"%s\",\"completed\":%d,\"in_progress\":%d,"
+                   "\"due_today\":%d,\"expired\":%d,\"minutes_planned\":%ld}\n",
+                monday, today, s->completed, s->inProgress, s->dueToday, s->expired, s->minutesPlanned);
+    } else {
+        fputs("week_start,date,completed,in_progress,due_today,expired,minutes_planned\n", f);
+        fprintf(f, "%s,%s,%d,%d,%d,%d,%ld\n",
+                monday, today, s->completed, s->inProgress, s->dueToday, s->expired, s->minutesPlanned);
+    }
+}
+
+/* exportCourseHeader
+ * Syntax Specification:
+ * void exportCourseHeader(FILE *f, int format);
+ *
+ * Semantic Specification:
+ * Starts the per-course aggregates after the summary: a second CSV table, nothing for JSON.
+ *
+ * Preconditions:
+ * - 'f' must be writable.
+ *
+ * Postconditions:
+ * - The CSV header of the course rows is written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+void exportCourseHeader(FILE *f, int format) {
+    if (format == EXPORT_CSV) fputs("\ncourse,completed,in_progress,expired,minutes_planned\n", f);
+}
+
+/* exportCourse
+ * Syntax Specification:
+ * void exportCourse(FILE *f, const char *course, int completed, int inProgress, int expired, long minutes, int format);
+ *
+ * Semantic Specification:
+ * Writes the aggregates of the week for one course, as a JSON line or a CSV row.
+ *
+ * Preconditions:
+ * - 'f' must be writable, 'course' a null-terminated string.
+ *
+ * Postconditions:
+ * - The record is written.
+ *
+ * Side Effects:
+ * - Writes into a file.
+ */
+void exportCourse(FILE *f, const char *course, int completed, int inProgress, int expired, long minutes, int format) {
+    if (format == EXPORT_JSON) {
+        fputs("{\"course\":", f);
+        writeJSONString(f, course);
+        fprintf(f, ",\"completed\":%d,\"in_progress\":%d,\"expired\":%d,\"minutes_planned\":%ld}\n",
+                completed, inProgress, expired, minutes);
+    } else {
+        writeCSVField(f, course);
+        fprintf(f, ",%d,%d,%d,%ld\n", completed, inProgress, expired, minutes);
+    }
+}
@@ -0,0 +1,24 @@
+#include <stdio.h>
+#include "../task/task.h"
+
+// Output formats of the exporter
+enum { EXPORT_JSON, EXPORT_CSV };
+
+// Aggregates of the weekly report, from 'monday' to 'today'
+struct weekSummary {
+    char monday[9];
+    char today[9];
+    int completed;
+    int inProgress;
+    int dueToday;
+    int expired;
+    long minutesPlanned;
+};
+
+ //export prototypes
+FILE *openExport(const char *filename);
+void exportTaskHeader(FILE *f, int format);
+void exportTask(FILE *f, Task t, const char *state, int format);
+void exportSummary(FILE *f, const struct weekSummary *s, int format);
+void exportCourseHeader(FILE *f, int format);
+void exportCourse(FILE *f, const char *course, int completed, int inProgress, int expired, long minutes, int format);
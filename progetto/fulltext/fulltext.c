@@ -0,0 +1,688 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../crc/crc.h"
+#include "fulltext.h"
+
+#define HEADER_FORMAT "#PTI\t%d\t%010d\t%010d\t%010ld\t%010ld\t%08x\n"
+#define TEXT_VERSION 1
+
+// Distinct words of a task (title, description and course: at most 325 characters)
+// and of a search
+#define MAX_TASK_WORDS 128
+#define MAX_QUERY_WORDS 16
+
+// Stale ids tolerated before isTextStale asks for a rebuild
+#define MIN_STALE 4096
+
+// Ids of one word
+struct term {
+    char word[TEXT_MAX_WORD + 1];
+    unsigned char *bytes;   // gaps between the ids (see fulltext.h)
+    int length;             // bytes used
+    int size;               // bytes allocated
+    int count;              // ids in 'bytes'
+    int last;               // greatest id in 'bytes'
+    int *extra;             // ids lower than 'last' added later (a task changed), in any order
+    int numExtra;
+    int totExtra;
+};
+
+struct textIndex {
+    struct term *terms;
+    int numTerms;
+    int totTerms;
+    int *table;             // open addressing hash table of positions in 'terms', -1 if free
+    int tableSize;          // always a power of two, at least twice 'numTerms'
+    long entries;           // ids in every word
+    long stale;             // ids of words no longer in their task (or of removed tasks)
+    int lastId;             // greatest id added
+};
+
+TextIndex newTextIndex(void) {
+    TextIndex x = calloc(1, sizeof(struct textIndex));
+    if (x == NULL) return NULL;
+
+    x->tableSize = 64;
+    x->table = malloc(x->tableSize * sizeof(int));
+    if (x->table == NULL) {
+        free(x);
+        return NULL;
+    }
+    for (int i = 0; i < x->tableSize; i++) x->table[i] = -1;
+    return x;
+}
+
+void freeTextIndex(TextIndex x) {
+    if (x == NULL) return;
+    for (int i = 0; i < x->numTerms; i++) {
+        free(x->terms[i].bytes);
+        free(x->terms[i].extra);
+    }
+    free(x->terms);
+    free(x->table);
+    free(x);
+}
+
+/* nextWord
+ * Syntax Specification:
+ * static int nextWord(const char *s, int *pos, char *word);
+ *
+ * Semantic Specification:
+ * Reads the next word of 's' from '*pos': a run of letters and digits (bytes
+ * outside ASCII included), lowercase, cut at TEXT_MAX_WORD characters. Words
+ * shorter than TEXT_MIN_WORD are skipped.
+ *
+ * Preconditions:
+ * - 's' must be a null-terminated string, 'word' must have room for TEXT_MAX_WORD + 1 characters.
+ *
+ * Postconditions:
+ * - Returns the length of the word (0 at the end of 's') and moves '*pos' after it.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int nextWord(const char *s, int *pos, char *word) {
+    int i = *pos;
+    while (s[i] != '\0') {
+        while (s[i] != '\0' && !((unsigned char)s[i] >= 0x80 || (s[i] >= '0' && s[i] <= '9')
+                                 || (s[i] >= 'a' && s[i] <= 'z') || (s[i] >= 'A' && s[i] <= 'Z'))) i++;
+        int len = 0;
+        while ((unsigned char)s[i] >= 0x80 || (s[i] >= '0' && s[i] <= '9')
+               || (s[i] >= 'a' && s[i] <= 'z') || (s[i] >= 'A' && s[i] <= 'Z')) {
+            if (len < TEXT_MAX_WORD) word[len++] = (s[i] >= 'A' && s[i] <= 'Z') ? s[i] - 'A' + 'a' : s[i];
+            i++;
+        }
+        word[len] = '\0';
+        if (len >= TEXT_MIN_WORD) {
+            *pos = i;
+            return len;
+        }
+    }
+    *pos = i;
+    return 0;
+}
+
+/* collectWords
+ * Syntax Specification:
+ * static int collectWords(const char *s, char (*words)[TEXT_MAX_WORD + 1], int numel, int max);
+ *
+ * Semantic Specification:
+ * Adds to 'words' the words of 's' not already there.
+ *
+ * Preconditions:
+ * - 'words' must hold 'numel' words and have room for 'max'.
+ *
+ * Postconditions:
+ * - Returns the new number of words; the words beyond 'max' are dropped.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int collectWords(const char *s, char (*words)[TEXT_MAX_WORD + 1], int numel, int max) {
+    char word[TEXT_MAX_WORD + 1];
+    int pos = 0;
+    while (numel < max && nextWord(s, &pos, word) > 0) {
+        int i = 0;
+        while (i < numel && strcmp(words[i], word) != 0) i++;
+        if (i == numel) strcpy(words[numel++], word);
+    }
+    return numel;
+}
+
+// Distinct words of the title, the description and the course of a task
+static int taskWords(Task t, char (*words)[TEXT_MAX_WORD + 1]) {
+    int numel = collectWords(getTitle(t), words, 0, MAX_TASK_WORDS);
+    numel = collectWords(getDescription(t), words, numel, MAX_TASK_WORDS);
+    return collectWords(getCourse(t), words, numel, MAX_TASK_WORDS);
+}
+
+/* findSlot
+ * Syntax Specification:
+ * static int findSlot(TextIndex x, const char *word);
+ *
+ * Semantic Specification:
+ * Returns the slot of the hash table holding the word, or the free slot where it would go.
+ *
+ * Preconditions:
+ * - 'x' must be valid, with at least one free slot.
+ *
+ * Postconditions:
+ * - Returns a slot index in [0, tableSize).
+ *
+ * Side Effects:
+ * - None.
+ */
+static int findSlot(TextIndex x, const char *word) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; word[i] != '\0'; i++) {
+        h ^= (unsigned char)word[i];
+        h *= 16777619u;
+    }
+    int slot = h & (x->tableSize - 1);
+    while (x->table[slot] != -1 && strcmp(x->terms[x->table[slot]].word, word) != 0) {
+        slot = (slot + 1) & (x->tableSize - 1);
+    }
+    return slot;
+}
+
+/* findTerm
+ * Syntax Specification:
+ * static int findTerm(TextIndex x, const char *word, bool add);
+ *
+ * Semantic Specification:
+ * Returns the position of a word in 'terms'; if 'add' is true a missing word is added.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 'word' a word as read by nextWord.
+ *
+ * Postconditions:
+ * - Returns the position, or -1 if the word is missing (and not added) or memory
+ *   is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static int findTerm(TextIndex x, const char *word, bool add) {
+    int slot = findSlot(x, word);
+    if (x->table[slot] != -1) return x->table[slot];
+    if (!add) return -1;
+
+    if (2 * (x->numTerms + 1) > x->tableSize) {
+        int *table = malloc(2 * x->tableSize * sizeof(int));
+        if (table == NULL) return -1;
+        free(x->table);
+        x->table = table;
+        x->tableSize *= 2;
+        for (int i = 0; i < x->tableSize; i++) x->table[i] = -1;
+        for (int i = 0; i < x->numTerms; i++) x->table[findSlot(x, x->terms[i].word)] = i;
+        slot = findSlot(x, word);
+    }
+    if (x->numTerms == x->totTerms) {
+        int tot = x->totTerms ? x->totTerms * 2 : 64;
+        struct term *terms = realloc(x->terms, tot * sizeof(struct term));
+        if (terms == NULL) return -1;
+        x->terms = terms;
+        x->totTerms = tot;
+    }
+    struct term *t = &x->terms[x->numTerms];
+    memset(t, 0, sizeof(struct term));
+    snprintf(t->word, sizeof(t->word), "%s", word);
+    x->table[slot] = x->numTerms;
+    return x->numTerms++;
+}
+
+/* appendGap
+ * Syntax Specification:
+ * static bool appendGap(struct term *t, int id);
+ *
+ * Semantic Specification:
+ * Appends an id greater than the last one, as its gap from the last one.
+ *
+ * Preconditions:
+ * - 't' must be valid, id > t->last.
+ *
+ * Postconditions:
+ * - Returns true, or false if memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static bool appendGap(struct term *t, int id) {
+    if (t->length + 5 > t->size) {
+        int size = t->size ? t->size : 16;
+        // a list read from file has the exact size
+        while (size < t->length + 5) size *= 2;
+        unsigned char *bytes = realloc(t->bytes, size);
+        if (bytes == NULL) return false;
+        t->bytes = bytes;
+        t->size = size;
+    }
+    unsigned int gap = id - t->last;
+    while (gap >= 0x80) {
+        t->bytes[t->length++] = (gap & 0x7f) | 0x80;
+        gap >>= 7;
+    }
+    t->bytes[t->length++] = gap;
+    t->last = id;
+    t->count++;
+    return true;
+}
+
+static int compareIds(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* decodeTerm
+ * Syntax Specification:
+ * static int decodeTerm(struct term *t, int *ids);
+ *
+ * Semantic Specification:
+ * Writes the ids of a word in increasing order, without repetitions, merging
+ * the compressed ids with the extra ones (which are sorted in place).
+ *
+ * Preconditions:
+ * - 'ids' must have room for t->count + t->numExtra ids.
+ *
+ * Postconditions:
+ * - Returns the number of ids written.
+ *
+ * Side Effects:
+ * - Reorders the extra ids.
+ */
+static int decodeTerm(struct term *t, int *ids) {
+    if (t->numExtra > 1) qsort(t->extra, t->numExtra, sizeof(int), compareIds);
+
+    int numel = 0, id = 0, e = 0, pos = 0;
+    for (int i = 0; i < t->count; i++) {
+        unsigned int gap = 0;
+        int shift = 0;
+        while (t->bytes[pos] & 0x80) {
+            gap |= (unsigned int)(t->bytes[pos++] & 0x7f) << shift;
+            shift += 7;
+        }
+        gap |= (unsigned int)t->bytes[pos++] << shift;
+        id += gap;
+        for (; e < t->numExtra && t->extra[e] <= id; e++) {
+            if (t->extra[e] < id && (numel == 0 || ids[numel - 1] != t->extra[e])) ids[numel++] = t->extra[e];
+        }
+        ids[numel++] = id;
+    }
+    for (; e < t->numExtra; e++) {
+        if (numel == 0 || ids[numel - 1] != t->extra[e]) ids[numel++] = t->extra[e];
+    }
+    return numel;
+}
+
+/* compactTerm
+ * Syntax Specification:
+ * static bool compactTerm(TextIndex x, struct term *t);
+ *
+ * Semantic Specification:
+ * Moves the extra ids of a word into its compressed ids, encoding them again.
+ *
+ * Preconditions:
+ * - 'x' and 't' must be valid.
+ *
+ * Postconditions:
+ * - Returns true with no extra ids left, or false if memory is not available
+ *   (the word is unchanged).
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static bool compactTerm(TextIndex x, struct term *t) {
+    if (t->numExtra == 0) return true;
+
+    // splitting a gap never takes more bytes than writing the new id alone
+    int size = t->length + 5 * t->numExtra;
+    unsigned char *bytes = (size > t->size) ? realloc(t->bytes, size) : t->bytes;
+    int *ids = malloc((t->count + t->numExtra) * sizeof(int));
+    if (bytes != NULL && size > t->size) {
+        t->bytes = bytes;
+        t->size = size;
+    }
+    if (bytes == NULL || ids == NULL) {
+        free(ids);
+        return false;
+    }
+    int numel = decodeTerm(t, ids);
+
+    x->entries -= t->count + t->numExtra;
+    t->length = t->count = t->last = 0;
+    for (int i = 0; i < numel; i++) appendGap(t, ids[i]);
+    x->entries += t->count;
+    t->numExtra = 0;
+    free(ids);
+    return true;
+}
+
+/* addId
+ * Syntax Specification:
+ * static void addId(TextIndex x, struct term *t, int id);
+ *
+ * Semantic Specification:
+ * Adds an id to a word: appended if it is the greatest, among the extra ids
+ * otherwise (moved into the compressed ids when they are many).
+ *
+ * Preconditions:
+ * - 'x' and 't' must be valid, id > 0.
+ *
+ * Postconditions:
+ * - The id is in the word, unless memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static void addId(TextIndex x, struct term *t, int id) {
+    if (id > t->last) {
+        if (appendGap(t, id)) x->entries++;
+        return;
+    }
+    if (id == t->last) return;
+
+    if (t->numExtra == t->totExtra) {
+        int tot = t->totExtra ? t->totExtra * 2 : 4;
+        int *extra = realloc(t->extra, tot * sizeof(int));
+        if (extra == NULL) return;
+        t->extra = extra;
+        t->totExtra = tot;
+    }
+    t->extra[t->numExtra++] = id;
+    x->entries++;
+    if (t->numExtra > 64 && t->numExtra * 8 > t->count) compactTerm(x, t);
+}
+
+/* addTextTask
+ * Syntax Specification:
+ * void addTextTask(TextIndex x, Task t);
+ *
+ * Semantic Specification:
+ * Adds the id of the task to every word of its title, description and course.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'x' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - searchText finds the task by its words.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+void addTextTask(TextIndex x, Task t) {
+    if (x == NULL || t == NULL || getId(t) <= 0) return;
+
+    char words[MAX_TASK_WORDS][TEXT_MAX_WORD + 1];
+    int numel = taskWords(t, words), id = getId(t);
+    for (int i = 0; i < numel; i++) {
+        int k = findTerm(x, words[i], true);
+        if (k != -1) addId(x, &x->terms[k], id);
+    }
+    if (id > x->lastId) x->lastId = id;
+}
+
+/* removeTextTask
+ * Syntax Specification:
+ * void removeTextTask(TextIndex x, Task t);
+ *
+ * Semantic Specification:
+ * Removes a task from the index, before it is deleted or its words are changed.
+ * The ids are not taken off the words, which would mean decoding them again:
+ * they are counted as stale, and searchText returns them as candidates that
+ * matchesText discards.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'x' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The stale ids of the index include the words of the task.
+ *
+ * Side Effects:
+ * - None.
+ */
+void removeTextTask(TextIndex x, Task t) {
+    if (x == NULL || t == NULL) return;
+
+    char words[MAX_TASK_WORDS][TEXT_MAX_WORD + 1];
+    x->stale += taskWords(t, words);
+}
+
+int getTextLastId(TextIndex x) {
+    return x->lastId;
+}
+
+// True when the stale ids are a large part of the index: it is cheaper to build it again
+bool isTextStale(TextIndex x) {
+    return x->stale > MIN_STALE && x->stale * 4 > x->entries;
+}
+
+/* intersectTerm
+ * Syntax Specification:
+ * static int intersectTerm(struct term *t, int *ids, int numel);
+ *
+ * Semantic Specification:
+ * Keeps the ids of the array that are also in the word. The compressed ids are
+ * decoded in order and only until the greatest id of the array.
+ *
+ * Preconditions:
+ * - 'ids' must hold 'numel' ids in increasing order.
+ *
+ * Postconditions:
+ * - Returns the number of ids left, still in increasing order.
+ *
+ * Side Effects:
+ * - Reorders the extra ids of the word.
+ */
+static int intersectTerm(struct term *t, int *ids, int numel) {
+    if (t->numExtra > 1) qsort(t->extra, t->numExtra, sizeof(int), compareIds);
+
+    int kept = 0, i = 0, id = 0, pos = 0, decoded = 0;
+    while (i < numel) {
+        // next id of the compressed list not lower than ids[i]
+        while (decoded < t->count && id < ids[i]) {
+            unsigned int gap = 0;
+            int shift = 0;
+            while (t->bytes[pos] & 0x80) {
+                gap |= (unsigned int)(t->bytes[pos++] & 0x7f) << shift;
+                shift += 7;
+            }
+            gap |= (unsigned int)t->bytes[pos++] << shift;
+            id += gap;
+            decoded++;
+        }
+        if ((decoded > 0 && id == ids[i])
+                || bsearch(&ids[i], t->extra, t->numExtra, sizeof(int), compareIds) != NULL) ids[kept++] = ids[i];
+        i++;
+    }
+    return kept;
+}
+
+/* searchText
+ * Syntax Specification:
+ * int searchText(TextIndex x, const char *text, int **ids);
+ *
+ * Semantic Specification:
+ * Returns the ids of the tasks having every word of 'text' in their title,
+ * description or course. The word with fewest ids is decoded, then the others
+ * are intersected with it from the shortest; no description is read. The ids
+ * may include stale ones (see removeTextTask), to be checked with matchesText.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 'text' a null-terminated string.
+ *
+ * Postconditions:
+ * - '*ids' is an array allocated for the caller, in increasing order (NULL if
+ *   there are no ids).
+ * - Returns the number of ids (0 if 'text' has no word), or -1 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+int searchText(TextIndex x, const char *text, int **ids) {
+    *ids = NULL;
+    char words[MAX_QUERY_WORDS][TEXT_MAX_WORD + 1];
+    int numWords = collectWords(text, words, 0, MAX_QUERY_WORDS);
+    if (numWords == 0) return 0;
+
+    int order[MAX_QUERY_WORDS];
+    for (int i = 0; i < numWords; i++) {
+        int k = findTerm(x, words[i], false);
+        if (k == -1) return 0;
+        // insertion in order of number of ids
+        int j = i;
+        for (; j > 0; j--) {
+            struct term *prev = &x->terms[order[j - 1]];
+            if (prev->count + prev->numExtra <= x->terms[k].count + x->terms[k].numExtra) break;
+            order[j] = order[j - 1];
+        }
+        order[j] = k;
+    }
+
+    struct term *first = &x->terms[order[0]];
+    int *result = malloc((first->count + first->numExtra + 1) * sizeof(int));
+    if (result == NULL) return -1;
+    int numel = decodeTerm(first, result);
+    for (int i = 1; i < numWords && numel > 0; i++) numel = intersectTerm(&x->terms[order[i]], result, numel);
+
+    if (numel == 0) {
+        free(result);
+        return 0;
+    }
+    *ids = result;
+    return numel;
+}
+
+/* matchesText
+ * Syntax Specification:
+ * bool matchesText(Task t, const char *text);
+ *
+ * Semantic Specification:
+ * Checks whether the task has every word of 'text' in its title, description or course.
+ *
+ * Preconditions:
+ * - 't' must be valid, 'text' a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns true if every word is found.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool matchesText(Task t, const char *text) {
+    char words[MAX_QUERY_WORDS][TEXT_MAX_WORD + 1], own[MAX_TASK_WORDS][TEXT_MAX_WORD + 1];
+    int numWords = collectWords(text, words, 0, MAX_QUERY_WORDS), numOwn = taskWords(t, own);
+    for (int i = 0; i < numWords; i++) {
+        int j = 0;
+        while (j < numOwn && strcmp(own[j], words[i]) != 0) j++;
+        if (j == numOwn) return false;
+    }
+    return true;
+}
+
+/* saveTextIndex
+ * Syntax Specification:
+ * int saveTextIndex(TextIndex x, const char *path);
+ *
+ * Semantic Specification:
+ * Writes the index file (see fulltext.h), after moving the extra ids of every
+ * word into its compressed ids. The header is written last, with the checksum.
+ *
+ * Preconditions:
+ * - 'x' must be valid.
+ *
+ * Postconditions:
+ * - Returns 1 if the file was written, 0 otherwise.
+ *
+ * Side Effects:
+ * - Writes to a file.
+ */
+int saveTextIndex(TextIndex x, const char *path) {
+    for (int i = 0; i < x->numTerms; i++) {
+        if (!compactTerm(x, &x->terms[i])) return 0;
+    }
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return 0;
+
+    // room for the header, rewritten at the end
+    bool ok = fprintf(f, HEADER_FORMAT, TEXT_VERSION, 0, 0, 0L, 0L, 0u) > 0;
+    unsigned int crc = 0;
+    char line[TEXT_MAX_WORD + 48];
+    for (int i = 0; i < x->numTerms && ok; i++) {
+        struct term *t = &x->terms[i];
+        int len = snprintf(line, sizeof(line), "%s\t%d\t%d\t%d\n", t->word, t->count, t->last, t->length);
+        crc = crc32c(crc, line, len);
+        crc = crc32c(crc, t->bytes, t->length);
+        ok = fwrite(line, 1, len, f) == (size_t)len && fwrite(t->bytes, 1, t->length, f) == (size_t)t->length;
+    }
+    if (ok) {
+        rewind(f);
+        ok = fprintf(f, HEADER_FORMAT, TEXT_VERSION, x->numTerms, x->lastId, x->entries, x->stale, crc) > 0;
+    }
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/* loadTextIndex
+ * Syntax Specification:
+ * TextIndex loadTextIndex(const char *path);
+ *
+ * Semantic Specification:
+ * Reads the index file written by saveTextIndex, checking its checksum.
+ *
+ * Preconditions:
+ * - 'path' must be a valid path.
+ *
+ * Postconditions:
+ * - Returns the index, or NULL if the file is missing, damaged, of another
+ *   version, or memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+TextIndex loadTextIndex(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+
+    char header[128];
+    int version, numTerms, lastId;
+    long entries, stale, size = 0;
+    unsigned int crc;
+    if (fgets(header, sizeof(header), f) == NULL
+            || sscanf(header, "#PTI\t%d\t%d\t%d\t%ld\t%ld\t%x", &version, &numTerms, &lastId, &entries, &stale, &crc) != 6
+            || version != TEXT_VERSION) {
+        fclose(f);
+        return NULL;
+    }
+    long start = ftell(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f) - start;
+    fseek(f, start, SEEK_SET);
+    unsigned char *body = malloc(size > 0 ? size : 1);
+    TextIndex x = newTextIndex();
+    if (body == NULL || x == NULL || fread(body, 1, size, f) != (size_t)size || crc32c(0, body, size) != crc) {
+        fclose(f);
+        free(body);
+        freeTextIndex(x);
+        return NULL;
+    }
+    fclose(f);
+
+    long pos = 0;
+    bool ok = true;
+    for (int i = 0; i < numTerms && ok; i++) {
+        // the line of the word, then its bytes (which may look like anything)
+        char line[TEXT_MAX_WORD + 48], word[TEXT_MAX_WORD + 1];
+        unsigned char *end = memchr(body + pos, '\n', size - pos);
+        int count, last, length, len = (end != NULL) ? end - (body + pos) : 0;
+        ok = end != NULL && len < (int)sizeof(line);
+        if (ok) {
+            memcpy(line, body + pos, len);
+            line[len] = '\0';
+            ok = sscanf(line, "%24s\t%d\t%d\t%d", word, &count, &last, &length) == 4 && length >= 0
+                 && pos + len + 1 + length <= size;
+        }
+        int k = ok ? findTerm(x, word, true) : -1;
+        if (k == -1) break;
+
+        struct term *t = &x->terms[k];
+        pos += len + 1;
+        t->bytes = malloc(length > 0 ? length : 1);
+        if (t->bytes == NULL) break;
+        memcpy(t->bytes, body + pos, length);
+        t->length = t->size = length;
+        t->count = count;
+        t->last = last;
+        pos += length;
+    }
+    free(body);
+    if (x->numTerms != numTerms || pos != size) {
+        freeTextIndex(x);
+        return NULL;
+    }
+    x->lastId = lastId;
+    x->entries = entries;
+    x->stale = stale;
+    return x;
+}
@@ -0,0 +1,30 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Inverted index of the words of title, description and course of every task:
+// for each word, the ids of its tasks in increasing order, stored as the gaps
+// between them in variable-length bytes (7 bits per byte, high bit set on every
+// byte but the last). Words are made of letters and digits (any byte outside
+// ASCII counts as a letter), lowercase, of at least TEXT_MIN_WORD characters.
+// The index file is:
+//   #PTI <version> <words> <last id> <ids> <stale ids> <CRC32C of the rest>
+// then, for every word, a line "<word> <ids> <last id> <bytes>" and its bytes.
+#define TEXT_MIN_WORD 2
+#define TEXT_MAX_WORD 24
+
+// Forward declaration of the text index struct
+typedef struct textIndex *TextIndex;
+
+ //text index prototypes
+TextIndex newTextIndex(void);
+void freeTextIndex(TextIndex x);
+TextIndex loadTextIndex(const char *path);
+int saveTextIndex(TextIndex x, const char *path);
+
+void addTextTask(TextIndex x, Task t);
+void removeTextTask(TextIndex x, Task t);
+int getTextLastId(TextIndex x);
+bool isTextStale(TextIndex x);
+
+int searchText(TextIndex x, const char *text, int **ids);
+bool matchesText(Task t, const char *text);
@@ -0,0 +1,619 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "../crc/crc.h"
+#include "graph.h"
+
+#define HEADER_FORMAT "#PDG\t%d\t%010d\t%08x\n"
+#define GRAPH_MAX_LINE 64
+
+// The edges are the pairs (before, after) in order; the CSR arrays are built
+// from them. The arrays by id grow with the largest id seen.
+struct taskGraph {
+    int *edges;                 // edges[2 * i] must be finished before edges[2 * i + 1]
+    int numEdges;
+    int totEdges;
+    int *outStart;              // dependents of id: outTargets[outStart[id] .. outStart[id + 1] - 1]
+    int *outTargets;
+    int *inStart;               // prerequisites of id: inSources[inStart[id] .. inStart[id + 1] - 1]
+    int *inSources;
+    int numIds;                 // ids covered by the CSR arrays
+    Task *tasks;                // task in progress with the id, NULL if none
+    int *blocking;              // prerequisites of the id in progress
+    int *due;                   // deadline of the task in progress, in days (see dateToDays)
+    int *heapPos;               // position in the ready heap, -1 if not ready
+    int *heap;                  // ids of the ready tasks, earliest deadline first
+    int numReady;
+    int size;                   // ids covered by the arrays above
+    bool failed;                // a task could not be added: the ready view is incomplete
+};
+
+// Entry of the ready tasks to be sorted
+struct ready {
+    int due;
+    int priority;
+    int id;
+    Task t;
+};
+
+TaskGraph newTaskGraph(void) {
+    return calloc(1, sizeof(struct taskGraph));
+}
+
+void freeTaskGraph(TaskGraph g) {
+    if (g == NULL) return;
+    free(g->edges);
+    free(g->outStart);
+    free(g->outTargets);
+    free(g->inStart);
+    free(g->inSources);
+    free(g->tasks);
+    free(g->blocking);
+    free(g->due);
+    free(g->heapPos);
+    free(g->heap);
+    free(g);
+}
+
+// Grows the arrays by id to cover 'id'
+static bool reserveIds(TaskGraph g, int id) {
+    if (id < g->size) return true;
+    int size = g->size ? g->size : 64;
+    while (size <= id) size *= 2;
+
+    Task *tasks = realloc(g->tasks, size * sizeof(Task));
+    if (tasks != NULL) g->tasks = tasks;
+    int *blocking = realloc(g->blocking, size * sizeof(int));
+    if (blocking != NULL) g->blocking = blocking;
+    int *due = realloc(g->due, size * sizeof(int));
+    if (due != NULL) g->due = due;
+    int *heapPos = realloc(g->heapPos, size * sizeof(int));
+    if (heapPos != NULL) g->heapPos = heapPos;
+    int *heap = realloc(g->heap, size * sizeof(int));
+    if (heap != NULL) g->heap = heap;
+    if (tasks == NULL || blocking == NULL || due == NULL || heapPos == NULL || heap == NULL) return false;
+
+    for (int i = g->size; i < size; i++) {
+        g->tasks[i] = NULL;
+        g->blocking[i] = g->due[i] = 0;
+        g->heapPos[i] = -1;
+    }
+    g->size = size;
+    return true;
+}
+
+/* buildCsr
+ * Syntax Specification:
+ * static bool buildCsr(TaskGraph g);
+ *
+ * Semantic Specification:
+ * Builds the CSR arrays of the dependents and of the prerequisites from the
+ * edges, in O(ids + edges). The dependents are the second column of the edges,
+ * already in order; the prerequisites are placed by counting.
+ *
+ * Preconditions:
+ * - 'g' must be valid, with the edges in order and the ids reserved.
+ *
+ * Postconditions:
+ * - Returns false if memory is not available; the old arrays are kept.
+ *
+ * Side Effects:
+ * - Allocates and frees memory.
+ */
+static bool buildCsr(TaskGraph g) {
+    int n = g->size, m = g->numEdges;
+    int *outStart = calloc(n + 1, sizeof(int)), *inStart = calloc(n + 1, sizeof(int));
+    int *outTargets = malloc((m ? m : 1) * sizeof(int)), *inSources = malloc((m ? m : 1) * sizeof(int));
+    if (outStart == NULL || inStart == NULL || outTargets == NULL || inSources == NULL) {
+        free(outStart);
+        free(inStart);
+        free(outTargets);
+        free(inSources);
+        return false;
+    }
+
+    for (int i = 0; i < m; i++) {
+        outStart[g->edges[2 * i] + 1]++;
+        inStart[g->edges[2 * i + 1] + 1]++;
+        outTargets[i] = g->edges[2 * i + 1];
+    }
+    for (int id = 0; id < n; id++) {
+        outStart[id + 1] += outStart[id];
+        inStart[id + 1] += inStart[id];
+    }
+    // inStart[id] is used as the next free slot, then moved back
+    for (int i = 0; i < m; i++) inSources[inStart[g->edges[2 * i + 1]]++] = g->edges[2 * i];
+    for (int id = n; id > 0; id--) inStart[id] = inStart[id - 1];
+    inStart[0] = 0;
+
+    free(g->outStart);
+    free(g->inStart);
+    free(g->outTargets);
+    free(g->inSources);
+    g->outStart = outStart;
+    g->inStart = inStart;
+    g->outTargets = outTargets;
+    g->inSources = inSources;
+    g->numIds = n;
+    return true;
+}
+
+// Position of the edge in the pairs, or where it would go
+static int findEdge(TaskGraph g, int before, int after, bool *found) {
+    int lo = 0, hi = g->numEdges;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2, b = g->edges[2 * mid], a = g->edges[2 * mid + 1];
+        if (b < before || (b == before && a < after)) lo = mid + 1;
+            else hi = mid;
+    }
+    *found = lo < g->numEdges && g->edges[2 * lo] == before && g->edges[2 * lo + 1] == after;
+    return lo;
+}
+
+// Whether the ready task 'a' comes before 'b': earliest deadline, then highest priority, then id
+static bool comesFirst(TaskGraph g, int a, int b) {
+    if (g->due[a] != g->due[b]) return g->due[a] < g->due[b];
+    int pa = getPriority(g->tasks[a]), pb = getPriority(g->tasks[b]);
+    if (pa != pb) return pa > pb;
+    return a < b;
+}
+
+static void place(TaskGraph g, int pos, int id) {
+    g->heap[pos] = id;
+    g->heapPos[id] = pos;
+}
+
+static void siftUp(TaskGraph g, int pos) {
+    int id = g->heap[pos];
+    while (pos > 0 && comesFirst(g, id, g->heap[(pos - 1) / 2])) {
+        place(g, pos, g->heap[(pos - 1) / 2]);
+        pos = (pos - 1) / 2;
+    }
+    place(g, pos, id);
+}
+
+static void siftDown(TaskGraph g, int pos) {
+    int id = g->heap[pos];
+    while (2 * pos + 1 < g->numReady) {
+        int child = 2 * pos + 1;
+        if (child + 1 < g->numReady && comesFirst(g, g->heap[child + 1], g->heap[child])) child++;
+        if (!comesFirst(g, g->heap[child], id)) break;
+        place(g, pos, g->heap[child]);
+        pos = child;
+    }
+    place(g, pos, id);
+}
+
+static void pushReady(TaskGraph g, int id) {
+    place(g, g->numReady++, id);
+    siftUp(g, g->numReady - 1);
+}
+
+static void removeReady(TaskGraph g, int id) {
+    int pos = g->heapPos[id], last = g->heap[--g->numReady];
+    g->heapPos[id] = -1;
+    if (pos == g->numReady) return;
+    place(g, pos, last);
+    siftUp(g, pos);
+    siftDown(g, g->heapPos[last]);
+}
+
+// One more prerequisite of 'id' is in progress
+static void block(TaskGraph g, int id) {
+    if (g->blocking[id]++ == 0 && g->heapPos[id] >= 0) removeReady(g, id);
+}
+
+// One less prerequisite of 'id' is in progress
+static void unblock(TaskGraph g, int id) {
+    if (--g->blocking[id] == 0 && g->tasks[id] != NULL) pushReady(g, id);
+}
+
+/* activateTask, deactivateTask
+ * Syntax Specification:
+ * void activateTask(TaskGraph g, Task t);
+ * void deactivateTask(TaskGraph g, Task t);
+ *
+ * Semantic Specification:
+ * A task enters, or leaves, the tasks in progress: its dependents are blocked,
+ * or released into the ready view, in O(dependents · log(ready)). The task is
+ * in the ready view while none of its prerequisites is in progress.
+ * deactivateTask must be called before the deadline or the priority change,
+ * and activateTask after, since they order the ready view.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'g' may be NULL (nothing is done).
+ * - activateTask: 't' must not be active.
+ *
+ * Postconditions:
+ * - The task is (no longer) active. If activateTask runs out of memory the
+ *   ready view is marked incomplete and getReadyTasks fails.
+ *
+ * Side Effects:
+ * - activateTask may allocate memory.
+ */
+void activateTask(TaskGraph g, Task t) {
+    if (g == NULL || t == NULL || g->failed) return;
+    int id = getId(t);
+    if (!reserveIds(g, id)) {
+        g->failed = true;
+        return;
+    }
+
+    g->tasks[id] = t;
+    g->due[id] = dateToDays(getDeadline(t));
+    if (id < g->numIds) {
+        for (int i = g->outStart[id]; i < g->outStart[id + 1]; i++) block(g, g->outTargets[i]);
+    }
+    if (g->blocking[id] == 0) pushReady(g, id);
+}
+
+void deactivateTask(TaskGraph g, Task t) {
+    if (g == NULL || t == NULL || g->failed) return;
+    int id = getId(t);
+    if (id >= g->size || g->tasks[id] != t) return;
+
+    if (g->heapPos[id] >= 0) removeReady(g, id);
+    g->tasks[id] = NULL;
+    if (id < g->numIds) {
+        for (int i = g->outStart[id]; i < g->outStart[id + 1]; i++) unblock(g, g->outTargets[i]);
+    }
+}
+
+// Whether 'to' can be reached from 'from' following the dependents; -1 if memory is not available
+static int reaches(TaskGraph g, int from, int to) {
+    if (from >= g->numIds) return 0;
+    bool *seen = calloc(g->numIds, sizeof(bool));
+    int *stack = malloc((g->numEdges + 1) * sizeof(int));
+    if (seen == NULL || stack == NULL) {
+        free(seen);
+        free(stack);
+        return -1;
+    }
+
+    int found = 0, top = 0;
+    stack[top++] = from;
+    seen[from] = true;
+    while (top > 0 && !found) {
+        int id = stack[--top];
+        for (int i = g->outStart[id]; i < g->outStart[id + 1]; i++) {
+            int next = g->outTargets[i];
+            if (next == to) found = 1;
+            if (seen[next]) continue;
+            seen[next] = true;
+            stack[top++] = next;
+        }
+    }
+    free(seen);
+    free(stack);
+    return found;
+}
+
+/* addPrerequisite
+ * Syntax Specification:
+ * int addPrerequisite(TaskGraph g, int before, int after);
+ *
+ * Semantic Specification:
+ * Task 'before' must be finished before task 'after'. The edge is rejected if
+ * 'after' already comes before 'before' (the tasks would wait for each other);
+ * the check visits the dependents of 'after', and the CSR arrays are rebuilt.
+ *
+ * Preconditions:
+ * - 'g' must be valid, 'before' and 'after' positive ids.
+ *
+ * Postconditions:
+ * - Returns 1 if the edge was added, 0 if it was already there, GRAPH_ECYCLE or
+ *   GRAPH_ENOMEM (the graph is unchanged).
+ *
+ * Side Effects:
+ * - Allocates memory; 'after' leaves the ready view if 'before' is in progress.
+ */
+int addPrerequisite(TaskGraph g, int before, int after) {
+    if (g->failed) return GRAPH_ENOMEM;
+    if (before == after) return GRAPH_ECYCLE;
+    if (!reserveIds(g, (before > after) ? before : after)) return GRAPH_ENOMEM;
+
+    bool found;
+    int pos = findEdge(g, before, after, &found);
+    if (found) return 0;
+    int cycle = reaches(g, after, before);
+    if (cycle != 0) return (cycle > 0) ? GRAPH_ECYCLE : GRAPH_ENOMEM;
+
+    if (g->numEdges == g->totEdges) {
+        int tot = g->totEdges ? g->totEdges * 2 : 32;
+        int *edges = realloc(g->edges, 2 * tot * sizeof(int));
+        if (edges == NULL) return GRAPH_ENOMEM;
+        g->edges = edges;
+        g->totEdges = tot;
+    }
+    memmove(&g->edges[2 * pos + 2], &g->edges[2 * pos], 2 * (g->numEdges - pos) * sizeof(int));
+    g->edges[2 * pos] = before;
+    g->edges[2 * pos + 1] = after;
+    g->numEdges++;
+    if (!buildCsr(g)) {
+        g->numEdges--;
+        memmove(&g->edges[2 * pos], &g->edges[2 * pos + 2], 2 * (g->numEdges - pos) * sizeof(int));
+        return GRAPH_ENOMEM;
+    }
+
+    if (g->tasks[before] != NULL) block(g, after);
+    return 1;
+}
+
+// Removes an edge, returns false if it was not there or memory is not available
+bool removePrerequisite(TaskGraph g, int before, int after) {
+    bool found;
+    int pos = findEdge(g, before, after, &found);
+    if (!found || g->failed) return false;
+
+    g->numEdges--;
+    memmove(&g->edges[2 * pos], &g->edges[2 * pos + 2], 2 * (g->numEdges - pos) * sizeof(int));
+    if (!buildCsr(g)) {
+        memmove(&g->edges[2 * pos + 2], &g->edges[2 * pos], 2 * (g->numEdges - pos) * sizeof(int));
+        g->edges[2 * pos] = before;
+        g->edges[2 * pos + 1] = after;
+        g->numEdges++;
+        return false;
+    }
+
+    if (g->tasks[before] != NULL) unblock(g, after);
+    return true;
+}
+
+// Removes the edges of the tasks not in progress, once they can no longer come back
+void pruneInactive(TaskGraph g) {
+    if (g == NULL || g->failed) return;
+    int kept = 0;
+    for (int i = 0; i < g->numEdges; i++) {
+        int before = g->edges[2 * i], after = g->edges[2 * i + 1];
+        if (g->tasks[before] == NULL || g->tasks[after] == NULL) continue;
+        g->edges[2 * kept] = before;
+        g->edges[2 * kept + 1] = after;
+        kept++;
+    }
+    for (int id = 0; id < g->size; id++) {
+        if (g->tasks[id] == NULL) g->blocking[id] = 0;
+    }
+    g->numEdges = kept;
+    if (!buildCsr(g)) g->failed = true;
+}
+
+// Prerequisites, or dependents, of a task: owned by 'g' and valid until the next change of the edges
+int getPrerequisites(TaskGraph g, int id, const int **ids) {
+    if (id < 0 || id >= g->numIds) return 0;
+    *ids = &g->inSources[g->inStart[id]];
+    return g->inStart[id + 1] - g->inStart[id];
+}
+
+int getDependents(TaskGraph g, int id, const int **ids) {
+    if (id < 0 || id >= g->numIds) return 0;
+    *ids = &g->outTargets[g->outStart[id]];
+    return g->outStart[id + 1] - g->outStart[id];
+}
+
+bool isReady(TaskGraph g, int id) {
+    return id >= 0 && id < g->size && g->heapPos[id] >= 0;
+}
+
+static int compareReady(const void *a, const void *b) {
+    const struct ready *x = a, *y = b;
+    if (x->due != y->due) return (x->due < y->due) ? -1 : 1;
+    if (x->priority != y->priority) return (x->priority > y->priority) ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/* getReadyTasks
+ * Syntax Specification:
+ * int getReadyTasks(TaskGraph g, Task *result, int max);
+ *
+ * Semantic Specification:
+ * The first 'max' ready tasks by earliest deadline, then highest priority. The
+ * first one is the top of the heap; more than one are sorted from a copy.
+ *
+ * Preconditions:
+ * - 'g' must be valid, 'result' must have room for 'max' tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks written, or -1 if the ready view is incomplete
+ *   or memory is not available.
+ *
+ * Side Effects:
+ * - Allocates temporary memory.
+ */
+int getReadyTasks(TaskGraph g, Task *result, int max) {
+    if (g->failed) return -1;
+    int numel = (max < g->numReady) ? max : g->numReady;
+    if (numel <= 1) {
+        if (numel == 1) result[0] = g->tasks[g->heap[0]];
+        return numel;
+    }
+
+    struct ready *ready = malloc(g->numReady * sizeof(struct ready));
+    if (ready == NULL) return -1;
+    for (int i = 0; i < g->numReady; i++) {
+        int id = g->heap[i];
+        ready[i] = (struct ready){ g->due[id], getPriority(g->tasks[id]), id, g->tasks[id] };
+    }
+    qsort(ready, g->numReady, sizeof(struct ready), compareReady);
+    for (int i = 0; i < numel; i++) result[i] = ready[i].t;
+    free(ready);
+    return numel;
+}
+
+/* saveTaskGraph
+ * Syntax Specification:
+ * bool saveTaskGraph(TaskGraph g, const char *path);
+ *
+ * Semantic Specification:
+ * Writes the edges on file (see graph.h); the header is written last, with the
+ * checksum of the records.
+ *
+ * Preconditions:
+ * - 'g' must be valid, 'path' a writable path.
+ *
+ * Postconditions:
+ * - Returns true if the file was written.
+ *
+ * Side Effects:
+ * - Writes to file.
+ */
+bool saveTaskGraph(TaskGraph g, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return false;
+
+    bool ok = fprintf(f, HEADER_FORMAT, GRAPH_VERSION, 0, 0u) > 0;
+    unsigned int crc = 0;
+    for (int i = 0; i < g->numEdges && ok; i++) {
+        char line[GRAPH_MAX_LINE];
+        int len = snprintf(line, sizeof(line), "%d\t%d", g->edges[2 * i], g->edges[2 * i + 1]);
+        crc = crc32c(crc, line, len);
+        ok = fprintf(f, "%s\n", line) > 0;
+    }
+    if (ok) ok = fseek(f, 0, SEEK_SET) == 0 && fprintf(f, HEADER_FORMAT, GRAPH_VERSION, g->numEdges, crc) > 0;
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+static int compareEdges(const void *a, const void *b) {
+    const int *x = a, *y = b;
+    if (x[0] != y[0]) return (x[0] > y[0]) - (x[0] < y[0]);
+    return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+/* dropCycles
+ * Syntax Specification:
+ * static int dropCycles(TaskGraph g);
+ *
+ * Semantic Specification:
+ * Removes the edges between tasks left on a cycle by a damaged file: the tasks
+ * whose prerequisites can all be finished are taken in topological order
+ * (Kahn), and the edges among the others are dropped. O(ids + edges).
+ *
+ * Preconditions:
+ * - 'g' must be valid, with the CSR arrays built.
+ *
+ * Postconditions:
+ * - Returns the number of edges dropped, or -1 if memory is not available.
+ *
+ * Side Effects:
+ * - May rebuild the CSR arrays.
+ */
+static int dropCycles(TaskGraph g) {
+    int n = g->numIds;
+    int *waiting = malloc((n ? n : 1) * sizeof(int)), *queue = malloc((n ? n : 1) * sizeof(int));
+    if (waiting == NULL || queue == NULL) {
+        free(waiting);
+        free(queue);
+        return -1;
+    }
+
+    int head = 0, tail = 0;
+    for (int id = 0; id < n; id++) {
+        waiting[id] = g->inStart[id + 1] - g->inStart[id];
+        if (waiting[id] == 0) queue[tail++] = id;
+    }
+    while (head < tail) {
+        int id = queue[head++];
+        for (int i = g->outStart[id]; i < g->outStart[id + 1]; i++) {
+            if (--waiting[g->outTargets[i]] == 0) queue[tail++] = g->outTargets[i];
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < g->numEdges; i++) {
+        if (waiting[g->edges[2 * i]] > 0 && waiting[g->edges[2 * i + 1]] > 0) continue;
+        g->edges[2 * kept] = g->edges[2 * i];
+        g->edges[2 * kept + 1] = g->edges[2 * i + 1];
+        kept++;
+    }
+    free(waiting);
+    free(queue);
+
+    int dropped = g->numEdges - kept;
+    g->numEdges = kept;
+    if (dropped > 0 && !buildCsr(g)) return -1;
+    return dropped;
+}
+
+/* loadTaskGraph
+ * Syntax Specification:
+ * TaskGraph loadTaskGraph(const char *path);
+ *
+ * Semantic Specification:
+ * Reads the edges written by saveTaskGraph; no task is active yet. A missing
+ * file means no edges; the records of a damaged file that can still be read
+ * are kept, except the ones on a cycle, and a warning is printed.
+ *
+ * Preconditions:
+ * - 'path' must be a valid path.
+ *
+ * Postconditions:
+ * - Returns the graph, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+TaskGraph loadTaskGraph(const char *path) {
+    TaskGraph g = newTaskGraph();
+    if (g == NULL) return NULL;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return g;
+
+    char line[GRAPH_MAX_LINE];
+    int version, count = -1, maxId = 0;
+    unsigned int crc = 0, computed = 0;
+    bool ok = fgets(line, sizeof(line), f) != NULL &&
+              sscanf(line, "#PDG\t%d\t%d\t%x", &version, &count, &crc) == 3 && version == GRAPH_VERSION;
+    // a damaged record is skipped, the others are still read
+    while (fgets(line, sizeof(line), f) != NULL) {
+        int len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        computed = crc32c(computed, line, len);
+
+        int before, after;
+        char extra;
+        if (sscanf(line, "%d\t%d%c", &before, &after, &extra) != 2 || before <= 0 || after <= 0 || before == after) {
+            ok = false;
+            continue;
+        }
+        if (g->numEdges == g->totEdges) {
+            int tot = g->totEdges ? g->totEdges * 2 : 32;
+            int *edges = realloc(g->edges, 2 * tot * sizeof(int));
+            if (edges == NULL) {
+                fclose(f);
+                freeTaskGraph(g);
+                return NULL;
+            }
+            g->edges = edges;
+            g->totEdges = tot;
+        }
+        g->edges[2 * g->numEdges] = before;
+        g->edges[2 * g->numEdges + 1] = after;
+        g->numEdges++;
+        if (before > maxId) maxId = before;
+        if (after > maxId) maxId = after;
+    }
+    fclose(f);
+    int read = g->numEdges;
+
+    // the records are written in order: sorting only matters for a damaged file
+    qsort(g->edges, g->numEdges, 2 * sizeof(int), compareEdges);
+    int kept = 0;
+    for (int i = 0; i < g->numEdges; i++) {
+        if (kept > 0 && g->edges[2 * kept - 2] == g->edges[2 * i] && g->edges[2 * kept - 1] == g->edges[2 * i + 1]) continue;
+        g->edges[2 * kept] = g->edges[2 * i];
+        g->edges[2 * kept + 1] = g->edges[2 * i + 1];
+        kept++;
+    }
+    g->numEdges = kept;
+    if (!reserveIds(g, maxId) || !buildCsr(g) || dropCycles(g) < 0) {
+        freeTaskGraph(g);
+        return NULL;
+    }
+
+    if (!ok || read != count || computed != crc || g->numEdges != read) {
+        fprintf(stderr, "\nWarning: the file of the task prerequisites is damaged, %d prerequisites were read.\n", g->numEdges);
+    }
+    return g;
+}
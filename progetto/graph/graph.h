@@ -0,0 +1,36 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Prerequisites between tasks ("finish A before B") and the tasks ready to be
+// worked on. The edges are kept as CSR arrays (the dependents, and the
+// prerequisites, of every id are contiguous) rebuilt at every change of the
+// edges. A prerequisite blocks its dependents while it is in progress; the
+// tasks in progress with no blocking prerequisites form the ready view, a heap
+// by earliest deadline. Layout of the file:
+//   #PDG <version> <count> <CRC32C of the records>
+//   one record per line: <id of the prerequisite> <id of the dependent>
+#define GRAPH_VERSION 1
+
+// Results of addPrerequisite
+#define GRAPH_ECYCLE -1
+#define GRAPH_ENOMEM -2
+
+// Forward declaration of the task graph struct
+typedef struct taskGraph *TaskGraph;
+
+ //task graph prototypes
+TaskGraph newTaskGraph(void);
+void freeTaskGraph(TaskGraph g);
+TaskGraph loadTaskGraph(const char *path);
+bool saveTaskGraph(TaskGraph g, const char *path);
+
+int addPrerequisite(TaskGraph g, int before, int after);
+bool removePrerequisite(TaskGraph g, int before, int after);
+void pruneInactive(TaskGraph g);
+int getPrerequisites(TaskGraph g, int id, const int **ids);
+int getDependents(TaskGraph g, int id, const int **ids);
+
+void activateTask(TaskGraph g, Task t);
+void deactivateTask(TaskGraph g, Task t);
+bool isReady(TaskGraph g, int id);
+int getReadyTasks(TaskGraph g, Task *result, int max);
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "import.h"
+#include "../task/task.h"
+#include "../planner/planner.h"
+#include "../char/char.h"
+
+// Rows are given to the planner in batches, with one heap rebuild per batch
+#define IMPORT_BATCH 4096
+#define MAX_ROW 1024
+#define FIELDS 6
+
+/* splitRow
+ * Syntax Specification:
+ * static int splitRow(char *line, char sep, char **fields, int max);
+ *
+ * Semantic Specification:
+ * Splits a row in place on 'sep'. With ',' fields may be enclosed in double
+ * quotes, where a doubled quote stands for a quote character.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string without the line terminator.
+ * - 'fields' must have space for 'max' pointers.
+ *
+ * Postconditions:
+ * - Returns the number of fields found (it can be greater than 'max').
+ *
+ * Side Effects:
+ * - Modifies 'line'.
+ */
+static int splitRow(char *line, char sep, char **fields, int max) {
+    int n = 0;
+    char *in = line;
+
+    while (1) {
+        char *out = in, *start = in;
+        if (sep == ',' && *in == '"') {
+            in++;
+            while (*in != '\0') {
+                if (*in == '"' && in[1] == '"') {
+                    *out++ = '"';
+                    in += 2;
+                } else if (*in == '"') {
+                    in++;
+                    break;
+                } else {
+                    *out++ = *in++;
+                }
+            }
+        }
+        while (*in != '\0' && *in != sep) *out++ = *in++;
+
+        bool last = (*in == '\0');
+        *out = '\0';
+        if (n < max) fields[n] = start;
+        n++;
+        if (last) break;
+        in++;
+    }
+    return n;
+}
+
+// True if a field has a control character: a tab or line break (possible inside
+// a quoted CSV field) would split the record of the task on the data files
+static bool hasControl(const char *field) {
+    for (; *field != '\0'; field++) {
+        if ((unsigned char) *field < 0x20 || *field == 0x7f) return true;
+    }
+    return false;
+}
+
+/* parseRow
+ * Syntax Specification:
+ * static bool parseRow(char *line, char sep, struct taskFields *t, const char **reason);
+ *
+ * Semantic Specification:
+ * Validates a row "title, description, course, estimated time, deadline, priority"
+ * and fills the fields of the corresponding task.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string without the line terminator.
+ *
+ * Postconditions:
+ * - Returns true with the strings of '*t' pointing into 'line', or false with
+ *   '*reason' describing why the row was rejected.
+ *
+ * Side Effects:
+ * - Modifies 'line'.
+ */
+static bool parseRow(char *line, char sep, struct taskFields *t, const char **reason) {
+    char *f[FIELDS];
+    int n = splitRow(line, sep, f, FIELDS);
+    if (n != FIELDS) {
+        *reason = "expected 6 fields (title, description, course, time, deadline, priority)";
+        return false;
+    }
+
+    int len = strlen(f[0]);
+    if (len == 0 || len > 20) {
+        *reason = "title must have 1 to 20 characters";
+        return false;
+    }
+    len = strlen(f[1]);
+    if (len == 0 || len > 255) {
+        *reason = "description must have 1 to 255 characters";
+        return false;
+    }
+    len = strlen(f[2]);
+    if (len == 0 || len > 50) {
+        *reason = "course must have 1 to 50 characters";
+        return false;
+    }
+    if (hasControl(f[0]) || hasControl(f[1]) || hasControl(f[2])) {
+        *reason = "title, description and course cannot contain tabs or line breaks";
+        return false;
+    }
+
+    len = strlen(f[3]);
+    if (len == 0 || len > 9 || !isOnlyDigits(f[3], len)) {
+        *reason = "estimated time must be a non-negative number of minutes";
+        return false;
+    }
+    if (!isValidDate(f[4])) {
+        *reason = "deadline is not a valid ddmmyyyy date from today on";
+        return false;
+    }
+    if (strcmp(f[5], "low") != 0 && strcmp(f[5], "medium") != 0 && strcmp(f[5], "high") != 0) {
+        *reason = "priority must be low, medium or high";
+        return false;
+    }
+
+    *t = (struct taskFields){ f[0], f[1], f[2], atoi(f[3]), f[4], f[5] };
+    return true;
+}
+
+/* addBatch
+ * Syntax Specification:
+ * static int addBatch(AddTasks add, void *ctx, struct taskFields *f, int *ids, char **lines,
+ *                     const int *rows, int n, int *rejected);
+ *
+ * Semantic Specification:
+ * Gives a batch of rows to 'add', reports the rows it rejected and frees the
+ * lines the fields point into.
+ *
+ * Preconditions:
+ * - 'f', 'ids', 'lines' and 'rows' must have 'n' elements.
+ *
+ * Postconditions:
+ * - Returns the number of tasks added, or -1 if 'add' added none of them.
+ *
+ * Side Effects:
+ * - Prints the rejected rows, frees the lines.
+ */
+static int addBatch(AddTasks add, void *ctx, struct taskFields *f, int *ids, char **lines,
+                    const int *rows, int n, int *rejected) {
+    int added = add(ctx, f, n, ids);
+    for (int i = 0; i < n && added >= 0; i++) {
+        if (ids[i] >= 0) continue;
+        printf("\nRow %d rejected: the task was not added", rows[i]);
+        (*rejected)++;
+    }
+    for (int i = 0; i < n; i++) free(lines[i]);
+    return (added >= 0) ? added : -1;
+}
+
+/* importFile
+ * Syntax Specification:
+ * int importFile(const char *filename, AddTasks add, void *ctx, int *rejected);
+ *
+ * Semantic Specification:
+ * Streams a TSV or CSV file (the separator is detected from the first row) and
+ * gives every valid row to 'add' as the fields of a new task, in batches of
+ * IMPORT_BATCH rows. A first row starting with "title" is treated as a header.
+ * Rejected rows are reported with their reason.
+ *
+ * Preconditions:
+ * - 'add' must be a valid function, 'rejected' must not be NULL.
+ * - The global variable 'today' must be initialized.
+ *
+ * Postconditions:
+ * - Returns the number of imported tasks, or -1 if the file cannot be opened.
+ * - '*rejected' contains the number of rejected rows.
+ *
+ * Side Effects:
+ * - Reads from file, prints the rejected rows.
+ * - Calls 'add', allocates temporary memory.
+ */
+int importFile(const char *filename, AddTasks add, void *ctx, int *rejected) {
+    *rejected = 0;
+    FILE *f = fopen(filename, "r");
+    if (f == NULL) {
+        printf("\nError: unable to open '%s'.\n", filename);
+        return -1;
+    }
+
+    struct taskFields *batch = malloc(IMPORT_BATCH * sizeof(struct taskFields));
+    char **lines = malloc(IMPORT_BATCH * sizeof(char *));
+    int *ids = malloc(IMPORT_BATCH * sizeof(int)), *rows = malloc(IMPORT_BATCH * sizeof(int));
+    if (batch == NULL || lines == NULL || ids == NULL || rows == NULL) {
+        free(batch);
+        free(lines);
+        free(ids);
+        free(rows);
+        fclose(f);
+        printf("\nMemory allocation error.\n");
+        return -1;
+    }
+
+    char line[MAX_ROW + 2];
+    char sep = 0;
+    int imported = 0, numel = 0, row = 0;
+    while (fgets(line, sizeof(line), f)) {
+        row++;
+        int len = strcspn(line, "\r\n");
+        if (line[len] == '\0' && !feof(f)) {
+            int c;
+            while ((c = fgetc(f)) != '\n' && c != EOF);
+            printf("\nRow %d rejected: row longer than %d characters", row, MAX_ROW);
+            (*rejected)++;
+            continue;
+        }
+        line[len] = '\0';
+        if (len == 0) continue;
+
+        if (sep == 0) {
+            sep = (strchr(line, '\t') != NULL) ? '\t' : ',';
+            if (strncmp(line, "title", 5) == 0) continue;
+        }
+
+        // the fields point into the copy of the line until the batch is added
+        const char *reason = "memory allocation failed";
+        char *copy = malloc(len + 1);
+        if (copy != NULL) memcpy(copy, line, len + 1);
+        if (copy == NULL || !parseRow(copy, sep, &batch[numel], &reason)) {
+            free(copy);
+            printf("\nRow %d rejected: %s", row, reason);
+            (*rejected)++;
+            continue;
+        }
+
+        lines[numel] = copy;
+        rows[numel++] = row;
+        if (numel == IMPORT_BATCH) {
+            int added = addBatch(add, ctx, batch, ids, lines, rows, numel, rejected);
+            numel = 0;
+            if (added < 0) break;
+            imported += added;
+        }
+    }
+
+    if (numel > 0) {
+        int added = addBatch(add, ctx, batch, ids, lines, rows, numel, rejected);
+        if (added > 0) imported += added;
+    }
+
+    free(batch);
+    free(lines);
+    free(ids);
+    free(rows);
+    fclose(f);
+    return imported;
+}
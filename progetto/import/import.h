@@ -0,0 +1,10 @@
+// Fields of a new task, see planner.h
+struct taskFields;
+
+// Adds a batch of rows read from the file: ids[i] is set to the id of the task of
+// the i-th row, or to a negative value if it was rejected. Returns the number of
+// tasks added, or a negative value if none could be added (the import stops)
+typedef int (*AddTasks)(void *ctx, const struct taskFields *f, int n, int *ids);
+
+ //import prototypes
+int importFile(const char *filename, AddTasks add, void *ctx, int *rejected);
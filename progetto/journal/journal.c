@@ -0,0 +1,821 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "journal.h"
+#include "../datafile/datafile.h"
+#include "../crc/crc.h"
+
+static const char *collectionNames[JOURNAL_COLLECTIONS] = { "progress", "completed", "expired" };
+
+// Copy of the collections written by the checkpoint thread
+struct snapshot {
+    Journal j;
+    int slot;
+    unsigned int seq;   // last change included
+    int lastId;
+    int mask;           // bit i set if collection i is in the checkpoint
+    Task *items[JOURNAL_COLLECTIONS];
+    int numel[JOURNAL_COLLECTIONS];
+    bool ok;
+};
+
+struct journal {
+    FILE *f;                // opened on the first change
+    char path[256];
+    char oldPath[260];      // changes covered by the checkpoint being written
+    char base[256];
+    unsigned int seq;       // sequence number of the last change
+    int pending;            // changes since the last checkpoint
+    time_t lastCheckpoint;
+    int slot;               // slot of the next checkpoint
+    pthread_t thread;
+    bool running;
+    struct snapshot snap;
+    int batching;           // open batches: between beginBatch and endBatch the changes are grouped
+    char *batch;            // records of the batch, each one "\x1e<op><payload>"
+    int batchLen;
+    int batchTot;
+    int batchCount;
+};
+
+/* slotFile
+ * Syntax Specification:
+ * static void slotFile(Journal j, int slot, int collection, char *name);
+ *
+ * Semantic Specification:
+ * Builds the name of a file of a checkpoint slot: the manifest if 'collection'
+ * is -1, otherwise the data file of the collection.
+ *
+ * Preconditions:
+ * - 'name' must have 300 bytes of space.
+ *
+ * Postconditions:
+ * - 'name' contains the file name.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void slotFile(Journal j, int slot, int collection, char *name) {
+    if (collection < 0) snprintf(name, 300, "%s%d.ckp", j->base, slot);
+    else snprintf(name, 300, "%s%d_%s.txt", j->base, slot, collectionNames[collection]);
+}
+
+static bool fileExists(const char *name) {
+    FILE *f = fopen(name, "r");
+    if (f == NULL) return false;
+    fclose(f);
+    return true;
+}
+
+/* entryCrc
+ * Syntax Specification:
+ * static unsigned int entryCrc(unsigned int seq, const char *op, const char *payload);
+ *
+ * Semantic Specification:
+ * Computes the checksum of a journal line, so that a line torn by a crash is recognized.
+ *
+ * Preconditions:
+ * - 'op' and 'payload' must be null-terminated strings.
+ *
+ * Postconditions:
+ * - Returns the CRC32C of the sequence number, the op and the payload.
+ *
+ * Side Effects:
+ * - None.
+ */
+static unsigned int entryCrc(unsigned int seq, const char *op, const char *payload) {
+    char number[12];
+    int len = snprintf(number, sizeof(number), "%u", seq);
+    unsigned int crc = crc32c(0, number, len);
+    crc = crc32c(crc, op, strlen(op));
+    return crc32c(crc, payload, strlen(payload));
+}
+
+/* openJournal
+ * Syntax Specification:
+ * Journal openJournal(const char *path, const char *checkpointBase);
+ *
+ * Semantic Specification:
+ * Prepares the journal of the session. No file is created until the first change.
+ *
+ * Preconditions:
+ * - 'path' and 'checkpointBase' must be valid file names.
+ *
+ * Postconditions:
+ * - Returns a new Journal, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+Journal openJournal(const char *path, const char *checkpointBase) {
+    Journal j = malloc(sizeof(struct journal));
+    if (j == NULL) return NULL;
+
+    j->f = NULL;
+    snprintf(j->path, sizeof(j->path), "%s", path);
+    snprintf(j->oldPath, sizeof(j->oldPath), "%s.old", path);
+    snprintf(j->base, sizeof(j->base), "%s", checkpointBase);
+    j->seq = 0;
+    j->pending = 0;
+    j->lastCheckpoint = time(NULL);
+    j->slot = 0;
+    j->running = false;
+    j->batching = 0;
+    j->batch = NULL;
+    j->batchLen = j->batchTot = j->batchCount = 0;
+    return j;
+}
+
+/* waitCheckpoint
+ * Syntax Specification:
+ * static void waitCheckpoint(Journal j);
+ *
+ * Semantic Specification:
+ * Waits for the checkpoint thread, if any. A failed checkpoint leaves its slot
+ * to be written again, so the last valid checkpoint is never overwritten.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal.
+ *
+ * Postconditions:
+ * - No checkpoint is being written.
+ *
+ * Side Effects:
+ * - Blocks until the thread ends.
+ */
+static void waitCheckpoint(Journal j) {
+    if (!j->running) return;
+    pthread_join(j->thread, NULL);
+    j->running = false;
+    if (j->snap.ok) j->slot = j->snap.slot ^ 1;
+}
+
+/* closeJournal
+ * Syntax Specification:
+ * void closeJournal(Journal j);
+ *
+ * Semantic Specification:
+ * Waits for the checkpoint in progress and releases the journal. The files are
+ * left on disk: use discardJournal once the data files are saved.
+ *
+ * Preconditions:
+ * - 'j' must be a Journal returned by openJournal, or NULL.
+ *
+ * Postconditions:
+ * - The journal is freed.
+ *
+ * Side Effects:
+ * - Closes files, frees memory.
+ */
+void closeJournal(Journal j) {
+    if (j == NULL) return;
+    waitCheckpoint(j);
+    if (j->f != NULL) fclose(j->f);
+    free(j->batch);
+    free(j);
+}
+
+/* appendBatch
+ * Syntax Specification:
+ * static int appendBatch(Journal j, const char *op, const char *payload);
+ *
+ * Semantic Specification:
+ * Adds a change to the batch being built; it is written with the batch by endBatch.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal inside a batch.
+ *
+ * Postconditions:
+ * - Returns 1 if the change was added, 0 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static int appendBatch(Journal j, const char *op, const char *payload) {
+    int len = 1 + strlen(op) + strlen(payload);
+    if (j->batchLen + len + 1 > j->batchTot) {
+        int tot = j->batchTot ? j->batchTot : 4096;
+        while (tot < j->batchLen + len + 1) tot *= 2;
+        char *batch = realloc(j->batch, tot);
+        if (batch == NULL) return 0;
+        j->batch = batch;
+        j->batchTot = tot;
+    }
+    j->batchLen += snprintf(j->batch + j->batchLen, len + 1, "%c%s%s", BATCH_SEPARATOR, op, payload);
+    j->batchCount++;
+    return 1;
+}
+
+/* writeEntry
+ * Syntax Specification:
+ * static int writeEntry(Journal j, const char *op, const char *payload);
+ *
+ * Semantic Specification:
+ * Appends a change to the journal. The line reaches the file with commitJournal.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal, 'op' and 'payload' null-terminated strings.
+ *
+ * Postconditions:
+ * - Returns 1 if the line was written, 0 otherwise.
+ *
+ * Side Effects:
+ * - Creates the journal file if needed, writes into it.
+ */
+static int writeEntry(Journal j, const char *op, const char *payload) {
+    if (j->batching) return appendBatch(j, op, payload);
+    if (j->f == NULL) {
+        j->f = fopen(j->path, "a");
+        if (j->f == NULL) {
+            fprintf(stderr, "\nError: unable to open the journal.\n");
+            return 0;
+        }
+    }
+    j->seq++;
+    j->pending++;
+    return fprintf(j->f, "%u\t%s\t%08x\t%s\n", j->seq, op, entryCrc(j->seq, op, payload), payload) > 0;
+}
+
+/* logTask, logTaskId
+ * Syntax Specification:
+ * int logTask(Journal j, const char *op, Task t);
+ * int logTaskId(Journal j, const char *op, int id);
+ *
+ * Semantic Specification:
+ * Record a change of a collection, with the whole task (add or replace) or with
+ * its id only (remove, clear).
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal (NULL is ignored), 'op' one of the ops in journal.h.
+ *
+ * Postconditions:
+ * - Return 1 if the change was recorded, 0 otherwise.
+ *
+ * Side Effects:
+ * - Writes into the journal.
+ */
+int logTask(Journal j, const char *op, Task t) {
+    char line[DATA_MAX_LINE];
+    if (j == NULL || t == NULL || sPrintTask(t, line, sizeof(line)) < 0) return 0;
+    return writeEntry(j, op, line);
+}
+
+int logTaskId(Journal j, const char *op, int id) {
+    char number[12];
+    if (j == NULL) return 0;
+    snprintf(number, sizeof(number), "%d", id);
+    return writeEntry(j, op, number);
+}
+
+/* beginBatch, endBatch
+ * Syntax Specification:
+ * void beginBatch(Journal j);
+ * int endBatch(Journal j);
+ *
+ * Semantic Specification:
+ * The changes logged between the two calls are written as one batch entry
+ * "<sequence> B* <CRC> <count><records>", with a single sequence number and a
+ * single checksum: after a crash the batch is replayed whole or not at all.
+ * Batches can be nested: the changes of an inner batch are part of the
+ * outermost one, written by its endBatch.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal (NULL is ignored); every beginBatch is matched by an endBatch.
+ *
+ * Postconditions:
+ * - endBatch returns 1 if the batch was written (or was empty), 0 otherwise.
+ *
+ * Side Effects:
+ * - endBatch writes into the journal; each change still counts towards the checkpoint.
+ */
+void beginBatch(Journal j) {
+    if (j == NULL || j->batching++ > 0) return;
+    j->batchLen = 0;
+    j->batchCount = 0;
+}
+
+int endBatch(Journal j) {
+    if (j == NULL || j->batching == 0) return 0;
+    if (--j->batching > 0 || j->batchCount == 0) return 1;
+
+    char *payload = malloc(j->batchLen + 12);
+    if (payload == NULL) return 0;
+    snprintf(payload, j->batchLen + 12, "%d%s", j->batchCount, j->batch);
+    int ok = writeEntry(j, "B*", payload);
+    if (ok) j->pending += j->batchCount - 1;
+    free(payload);
+    return ok;
+}
+
+/* commitJournal
+ * Syntax Specification:
+ * bool commitJournal(Journal j);
+ *
+ * Semantic Specification:
+ * Makes the changes logged so far durable, then tells whether a checkpoint is due:
+ * every CHECKPOINT_OPS changes or CHECKPOINT_SECONDS seconds, so that the journal
+ * to replay after a crash stays short.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal (NULL is ignored).
+ *
+ * Postconditions:
+ * - Returns true if the caller should call startCheckpoint.
+ *
+ * Side Effects:
+ * - Flushes the journal file.
+ */
+bool commitJournal(Journal j) {
+    if (j == NULL || j->f == NULL) return false;
+    if (fflush(j->f) != 0) fprintf(stderr, "\nError: unable to write the journal.\n");
+
+    if (j->pending == 0) return false;
+    return j->pending >= CHECKPOINT_OPS || difftime(time(NULL), j->lastCheckpoint) >= CHECKPOINT_SECONDS;
+}
+
+/* writeSnapshot
+ * Syntax Specification:
+ * static void *writeSnapshot(void *arg);
+ *
+ * Semantic Specification:
+ * Body of the checkpoint thread: writes the data files of the slot, then its
+ * manifest, which makes the checkpoint valid, and finally drops the changes it covers.
+ *
+ * Preconditions:
+ * - 'arg' must point to the snapshot of the journal.
+ *
+ * Postconditions:
+ * - 'ok' tells whether the checkpoint is valid.
+ *
+ * Side Effects:
+ * - Writes and removes files, frees the copied tasks.
+ */
+static void *writeSnapshot(void *arg) {
+    struct snapshot *s = arg;
+    char name[300];
+
+    // a slot without manifest is never used, even if the writing stops halfway
+    slotFile(s->j, s->slot, -1, name);
+    remove(name);
+
+    s->ok = true;
+    for (int c = 0; c < JOURNAL_COLLECTIONS; c++) {
+        if (!(s->mask & (1 << c))) continue;
+        slotFile(s->j, s->slot, c, name);
+        DataWriter w = beginDataFile(name, s->numel[c], s->lastId);
+        for (int i = 0; i < s->numel[c] && w != NULL; i++) writeRecord(w, s->items[c][i]);
+        s->ok = endDataFile(w) && s->ok;
+
+        for (int i = 0; i < s->numel[c]; i++) freeTask(s->items[c][i]);
+        free(s->items[c]);
+    }
+
+    if (s->ok) {
+        char line[64];
+        int len = snprintf(line, sizeof(line), "%u\t%d\t%d", s->seq, s->mask, s->lastId);
+        slotFile(s->j, s->slot, -1, name);
+        FILE *f = fopen(name, "w");
+        s->ok = f != NULL && fprintf(f, "#CKP\t%s\t%08x\n", line, crc32c(0, line, len)) > 0;
+        if (f != NULL && fclose(f) != 0) s->ok = false;
+    }
+    if (s->ok) remove(s->j->oldPath);
+    return NULL;
+}
+
+/* rotateJournal
+ * Syntax Specification:
+ * static void rotateJournal(Journal j);
+ *
+ * Semantic Specification:
+ * Moves the changes logged so far to the old journal, where they stay until a
+ * checkpoint covering them is valid. If a previous checkpoint failed, they are
+ * appended to the changes it did not cover.
+ *
+ * Preconditions:
+ * - No checkpoint is being written.
+ *
+ * Postconditions:
+ * - The next change starts a new journal file.
+ *
+ * Side Effects:
+ * - Renames, copies and removes files.
+ */
+static void rotateJournal(Journal j) {
+    if (j->f != NULL) {
+        fclose(j->f);
+        j->f = NULL;
+    }
+    if (!fileExists(j->oldPath)) {
+        rename(j->path, j->oldPath);
+        return;
+    }
+
+    FILE *in = fopen(j->path, "r");
+    FILE *out = fopen(j->oldPath, "a");
+    if (in != NULL && out != NULL) {
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) fwrite(buffer, 1, n, out);
+    }
+    if (in != NULL) fclose(in);
+    if (out != NULL && fclose(out) == 0) remove(j->path);
+}
+
+/* startCheckpoint
+ * Syntax Specification:
+ * int startCheckpoint(Journal j, Task **items, int *numel, int mask);
+ *
+ * Semantic Specification:
+ * Starts writing a checkpoint of the collections selected by 'mask' in a
+ * background thread, so the interactive loop is not blocked. The collections
+ * not in the mask must be unchanged since the data files were last saved.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal.
+ * - 'items[i]' must be a malloc'ed array of 'numel[i]' copies of the tasks of
+ *   collection i (see copyTask), for every i in 'mask'.
+ *
+ * Postconditions:
+ * - The arrays and the tasks are owned by the journal.
+ * - Returns 1 if the checkpoint was started, 0 otherwise.
+ *
+ * Side Effects:
+ * - Waits for the previous checkpoint, rotates the journal, creates a thread.
+ */
+int startCheckpoint(Journal j, Task **items, int *numel, int mask) {
+    if (j == NULL) return 0;
+    waitCheckpoint(j);
+    rotateJournal(j);
+
+    struct snapshot *s = &j->snap;
+    s->j = j;
+    s->slot = j->slot;
+    s->seq = j->seq;
+    s->lastId = getLastTaskId();
+    s->mask = mask;
+    for (int c = 0; c < JOURNAL_COLLECTIONS; c++) {
+        s->items[c] = (mask & (1 << c)) ? items[c] : NULL;
+        s->numel[c] = (mask & (1 << c)) ? numel[c] : 0;
+    }
+    j->pending = 0;
+    j->lastCheckpoint = time(NULL);
+
+    j->running = pthread_create(&j->thread, NULL, writeSnapshot, s) == 0;
+    if (!j->running) {
+        writeSnapshot(s);
+        if (s->ok) j->slot = s->slot ^ 1;
+    }
+    return 1;
+}
+
+/* discardJournal
+ * Syntax Specification:
+ * void discardJournal(Journal j);
+ *
+ * Semantic Specification:
+ * Removes the journal and every checkpoint, once the data files contain all the changes.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal (NULL is ignored).
+ *
+ * Postconditions:
+ * - There is nothing left to recover.
+ *
+ * Side Effects:
+ * - Waits for the checkpoint in progress, removes files.
+ */
+void discardJournal(Journal j) {
+    if (j == NULL) return;
+    waitCheckpoint(j);
+    if (j->f != NULL) {
+        fclose(j->f);
+        j->f = NULL;
+    }
+
+    char name[300];
+    for (int slot = 0; slot < 2; slot++) {
+        slotFile(j, slot, -1, name);
+        remove(name);
+        for (int c = 0; c < JOURNAL_COLLECTIONS; c++) {
+            slotFile(j, slot, c, name);
+            remove(name);
+        }
+    }
+    remove(j->oldPath);
+    remove(j->path);
+    j->pending = 0;
+    j->slot = 0;
+}
+
+/* needsRecovery
+ * Syntax Specification:
+ * bool needsRecovery(Journal j);
+ *
+ * Semantic Specification:
+ * Tells whether the previous session ended without saving: its journal or
+ * checkpoints are still on disk.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal.
+ *
+ * Postconditions:
+ * - Returns true if loadCheckpoint and replayJournal have to be called.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool needsRecovery(Journal j) {
+    char name[300];
+    if (j == NULL) return false;
+    for (int slot = 0; slot < 2; slot++) {
+        slotFile(j, slot, -1, name);
+        if (fileExists(name)) return true;
+    }
+    return fileExists(j->path) || fileExists(j->oldPath);
+}
+
+/* readManifest
+ * Syntax Specification:
+ * static bool readManifest(Journal j, int slot, unsigned int *seq, int *mask, int *lastId);
+ *
+ * Semantic Specification:
+ * Reads and verifies the manifest of a checkpoint slot.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal.
+ *
+ * Postconditions:
+ * - Returns true if the manifest exists and its checksum matches.
+ *
+ * Side Effects:
+ * - Reads from file.
+ */
+static bool readManifest(Journal j, int slot, unsigned int *seq, int *mask, int *lastId) {
+    char name[300], line[64];
+    unsigned int crc;
+    slotFile(j, slot, -1, name);
+    FILE *f = fopen(name, "r");
+    if (f == NULL) return false;
+
+    bool ok = fscanf(f, "#CKP\t%u\t%d\t%d\t%x", seq, mask, lastId, &crc) == 4;
+    fclose(f);
+    if (!ok) return false;
+    int len = snprintf(line, sizeof(line), "%u\t%d\t%d", *seq, *mask, *lastId);
+    return crc32c(0, line, len) == crc;
+}
+
+/* readSlot
+ * Syntax Specification:
+ * static bool readSlot(Journal j, int slot, int mask, Task **items, int *numel);
+ *
+ * Semantic Specification:
+ * Reads the data files of a checkpoint slot; the slot is valid only if every
+ * file passes the integrity check.
+ *
+ * Preconditions:
+ * - 'mask' must come from the manifest of the slot.
+ *
+ * Postconditions:
+ * - Returns true and fills 'items' and 'numel' if the slot is valid; otherwise
+ *   nothing is allocated.
+ *
+ * Side Effects:
+ * - Reads from files, allocates memory.
+ */
+static bool readSlot(Journal j, int slot, int mask, Task **items, int *numel) {
+    char name[300];
+    bool ok = true;
+    int c;
+    for (c = 0; c < JOURNAL_COLLECTIONS && ok; c++) {
+        items[c] = NULL;
+        numel[c] = 0;
+        if (!(mask & (1 << c))) continue;
+
+        slotFile(j, slot, c, name);
+        FILE *f = fopen(name, "r");
+        DataReader r = (f != NULL) ? openDataFile(f) : NULL;
+        if (r == NULL) {
+            if (f != NULL) fclose(f);
+            ok = false;
+            break;
+        }
+        int count = getRecordCount(r);
+        items[c] = malloc((count > 0 ? count : 1) * sizeof(Task));
+        Task t;
+        while ((t = readRecord(r)) != NULL) {
+            if (items[c] != NULL && numel[c] < count) items[c][numel[c]++] = t;
+            else freeTask(t);
+        }
+        ok = closeDataFile(r) && items[c] != NULL;
+    }
+
+    if (!ok) {
+        for (int k = 0; k < c && k < JOURNAL_COLLECTIONS; k++) {
+            for (int i = 0; i < numel[k]; i++) freeTask(items[k][i]);
+            free(items[k]);
+            items[k] = NULL;
+            numel[k] = 0;
+        }
+    }
+    return ok;
+}
+
+/* loadCheckpoint
+ * Syntax Specification:
+ * int loadCheckpoint(Journal j, Task **items, int *numel);
+ *
+ * Semantic Specification:
+ * Reads the newest valid checkpoint. The changes it covers are skipped by replayJournal.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal, 'items' and 'numel' arrays of JOURNAL_COLLECTIONS elements.
+ *
+ * Postconditions:
+ * - Returns the mask of the collections read: for each of them 'items[i]' is a new
+ *   array of 'numel[i]' tasks owned by the caller. Returns 0 if no checkpoint is valid.
+ *
+ * Side Effects:
+ * - Reads from files, allocates memory, reserves the task ids.
+ */
+int loadCheckpoint(Journal j, Task **items, int *numel) {
+    unsigned int seq[2];
+    int mask[2], lastId[2];
+    bool valid[2];
+    for (int slot = 0; slot < 2; slot++) {
+        valid[slot] = readManifest(j, slot, &seq[slot], &mask[slot], &lastId[slot]);
+    }
+
+    int order[2] = { 0, 1 };
+    if (valid[1] && (!valid[0] || seq[1] > seq[0])) {
+        order[0] = 1;
+        order[1] = 0;
+    }
+    for (int k = 0; k < 2; k++) {
+        int slot = order[k];
+        if (!valid[slot] || !readSlot(j, slot, mask[slot], items, numel)) continue;
+
+        reserveTaskIds(lastId[slot]);
+        j->seq = seq[slot];
+        j->slot = slot ^ 1;
+        return mask[slot];
+    }
+    return 0;
+}
+
+/* readEntry
+ * Syntax Specification:
+ * static bool readEntry(FILE *f, char **line, int *size);
+ *
+ * Semantic Specification:
+ * Reads a whole line of the journal, however long (a batch is one line).
+ *
+ * Preconditions:
+ * - '*line' must be NULL or a buffer of '*size' bytes allocated by malloc.
+ *
+ * Postconditions:
+ * - Returns false at the end of the file; otherwise '*line' holds the line
+ *   without its terminator.
+ *
+ * Side Effects:
+ * - Reads from file, may reallocate the buffer.
+ */
+static bool readEntry(FILE *f, char **line, int *size) {
+    int len = 0;
+    while (1) {
+        if (*size - len < 2) {
+            int tot = *size ? *size * 2 : DATA_MAX_LINE + 32;
+            char *buffer = realloc(*line, tot);
+            if (buffer == NULL) return false;
+            *line = buffer;
+            *size = tot;
+        }
+        if (fgets(*line + len, *size - len, f) == NULL) break;
+        len += strlen(*line + len);
+        if ((*line)[len - 1] == '\n') break;
+    }
+    if (len == 0) return false;
+    (*line)[strcspn(*line, "\r\n")] = '\0';
+    return true;
+}
+
+/* replayRecord
+ * Syntax Specification:
+ * static bool replayRecord(const char *op, const char *payload, ReplayFunction apply, void *ctx);
+ *
+ * Semantic Specification:
+ * Applies one change read from the journal.
+ *
+ * Preconditions:
+ * - 'op' must be one of the ops in journal.h, 'payload' its payload.
+ *
+ * Postconditions:
+ * - Returns false if the task of the change cannot be read.
+ *
+ * Side Effects:
+ * - Allocates the task, calls 'apply'.
+ */
+static bool replayRecord(const char *op, const char *payload, ReplayFunction apply, void *ctx) {
+    Task t = NULL;
+    if (op[1] == '+' || op[1] == '=') {
+        t = assignTaskId(sReadTask(payload));
+        if (t == NULL) return false;
+    }
+    apply(ctx, op, t, (t != NULL) ? getId(t) : atoi(payload));
+    return true;
+}
+
+/* replayFile
+ * Syntax Specification:
+ * static bool replayFile(Journal j, const char *name, ReplayFunction apply, void *ctx, int *count);
+ *
+ * Semantic Specification:
+ * Applies the changes of a journal file newer than the checkpoint, in order;
+ * a batch entry applies all its changes.
+ *
+ * Preconditions:
+ * - 'j->seq' must be the sequence number of the last change already applied.
+ *
+ * Postconditions:
+ * - Returns false at the first damaged line: later changes cannot be trusted.
+ *
+ * Side Effects:
+ * - Reads from file, calls 'apply'.
+ */
+static bool replayFile(Journal j, const char *name, ReplayFunction apply, void *ctx, int *count) {
+    FILE *f = fopen(name, "r");
+    if (f == NULL) return true;
+
+    char *line = NULL, op[3];
+    int size = 0;
+    unsigned int seq, crc;
+    int offset;
+    bool ok = true;
+    while (readEntry(f, &line, &size)) {
+        if (sscanf(line, "%u\t%2s\t%x\t%n", &seq, op, &crc, &offset) != 3) {
+            ok = false;
+            break;
+        }
+        char *payload = line + offset;
+        if (entryCrc(seq, op, payload) != crc) {
+            ok = false;
+            break;
+        }
+        if (seq <= j->seq) continue;
+
+        if (op[0] != 'B') {
+            ok = replayRecord(op, payload, apply, ctx);
+            if (ok) (*count)++;
+        } else {
+            // "<count>" then the records, each one "\x1e<op><payload>"
+            int records = atoi(payload);
+            char *record = strchr(payload, BATCH_SEPARATOR);
+            for (int i = 0; i < records && ok; i++) {
+                if (record == NULL || strlen(record) < 3) {
+                    ok = false;
+                    break;
+                }
+                char *next = strchr(record + 1, BATCH_SEPARATOR);
+                if (next != NULL) *next = '\0';
+                char recordOp[3] = { record[1], record[2], '\0' };
+                ok = replayRecord(recordOp, record + 3, apply, ctx);
+                if (ok) (*count)++;
+                record = next;
+                if (next != NULL) *next = BATCH_SEPARATOR;
+            }
+        }
+        if (!ok) break;
+        j->seq = seq;
+    }
+    free(line);
+    fclose(f);
+    return ok;
+}
+
+/* replayJournal
+ * Syntax Specification:
+ * int replayJournal(Journal j, ReplayFunction apply, void *ctx);
+ *
+ * Semantic Specification:
+ * Applies the changes logged after the checkpoint read by loadCheckpoint (or all
+ * of them, without checkpoint), first those of the old journal. The replay stops
+ * at the first line damaged by the crash.
+ *
+ * Preconditions:
+ * - 'j' must be a valid Journal, 'apply' a valid function.
+ *
+ * Postconditions:
+ * - Returns the number of changes applied.
+ *
+ * Side Effects:
+ * - Reads from files, calls 'apply'.
+ */
+int replayJournal(Journal j, ReplayFunction apply, void *ctx) {
+    int count = 0;
+    if (replayFile(j, j->oldPath, apply, ctx, &count)) {
+        replayFile(j, j->path, apply, ctx, &count);
+    }
+    return count;
+}
@@ -0,0 +1,39 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Journal of the changes made since the last checkpoint, one line per change:
+//   <sequence> <op> <CRC32C of sequence, op and payload> <payload>
+// The op is the collection (P in progress, C completed, E expired, H history)
+// followed by the action (+ add or replace, = replace, - remove, 0 clear);
+// the payload is a task line (+ and =) or a task id (-).
+// A batch is a single entry with op B* and payload <count> followed by its
+// changes, each one written as BATCH_SEPARATOR <op> <payload>.
+// Checkpoints are written by a background thread in two alternating slots:
+//   <base><slot>_<collection>.txt  data files of the collections changed since the last save
+//   <base><slot>.ckp               manifest written last: #CKP <sequence> <mask> <last id> <CRC>
+#define JOURNAL_COLLECTIONS 3
+#define CHECKPOINT_OPS 256     // changes between two checkpoints
+#define CHECKPOINT_SECONDS 60  // seconds between two checkpoints, if anything changed
+#define BATCH_SEPARATOR '\x1e'  // separates the changes of a batch entry
+
+// Forward declaration of the journal struct
+typedef struct journal *Journal;
+
+// Called by replayJournal for every change: 't' is owned by the callee (NULL for - and 0)
+typedef void (*ReplayFunction)(void *ctx, const char *op, Task t, int id);
+
+ //journal prototypes
+Journal openJournal(const char *path, const char *checkpointBase);
+void closeJournal(Journal j);
+
+int logTask(Journal j, const char *op, Task t);
+int logTaskId(Journal j, const char *op, int id);
+void beginBatch(Journal j);
+int endBatch(Journal j);
+bool commitJournal(Journal j);
+int startCheckpoint(Journal j, Task **items, int *numel, int mask);
+void discardJournal(Journal j);
+
+bool needsRecovery(Journal j);
+int loadCheckpoint(Journal j, Task **items, int *numel);
+int replayJournal(Journal j, ReplayFunction apply, void *ctx);
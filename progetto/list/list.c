@@ -3,6 +3,7 @@
 #include <string.h>
 #include "list.h"
 #include "../task/task.h"
+#include "../datafile/datafile.h"
 
 struct node {
     Task value;
@@ -67,7 +68,7 @@ int emptyList(list l) {
  */
 Task getValue(list l) {
     if (l == NULL) {
-        printf("\nError: list is empty or non-existent\n");
+        fprintf(stderr, "\nError: list is empty or non-existent\n");
         return NULL;
     }
     return l->value;
@@ -91,7 +92,7 @@ Task getValue(list l) {
  */
 struct node *getNext(list l) {
     if (l == NULL) {
-        printf("\nError: list is empty or non-existent\n");
+        fprintf(stderr, "\nError: list is empty or non-existent\n");
         return NULL;
     }
     return l->next;
@@ -120,7 +121,7 @@ list consList(Task val, list l) {
         new_node->next = l;
         l = new_node;
     } else {
-        printf("Memory allocation error\n");
+        fprintf(stderr, "Memory allocation error\n");
     }
     return l;
 }
@@ -191,6 +192,32 @@ Task getByLTitle(list l, char *title) {
     return NULL;
 }
 
+/* getByLId
+ * Syntax Specification:
+ * Task getByLId(list l, int id);
+ *
+ * Semantic Specification:
+ * Searches the list for a task by its id.
+ *
+ * Preconditions:
+ * - 'l' must be valid.
+ *
+ * Postconditions:
+ * - Returns the matching Task or NULL.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task getByLId(list l, int id) {
+    while (l != NULL) {
+        if (getId(l->value) == id) {
+            return l->value;
+        }
+        l = l->next;
+    }
+    return NULL;
+}
+
 /* printList
  * Syntax Specification:
  * void printList(list l);
@@ -251,7 +278,7 @@ list rmvList(list l, char *title) {
         if (now != NULL) temp = now->next;
     }
 
-    printf("\nElement not found");
+    fprintf(stderr, "\nElement not found");
     return l;
 }
 
@@ -273,7 +300,7 @@ list rmvList(list l, char *title) {
  */
 Task popL(list *l, Task target) {
     if (l == NULL || target == NULL) {
-        printf("\nError: list or task is NULL\n");
+        fprintf(stderr, "\nError: list or task is NULL\n");
         return NULL;
     }
 
@@ -300,10 +327,11 @@ Task popL(list *l, Task target) {
  * int saveOnFileList(list l, char *filename);
  *
  * Semantic Specification:
- * Saves the task list to a file.
+ * Saves the task list to a file, with header and checksums. An empty list
+ * produces a file with the header only.
  *
  * Preconditions:
- * - 'l' and 'filename' must be valid.
+ * - 'filename' must be valid.
  *
  * Postconditions:
  * - Returns 1 if success, 0 on error.
@@ -312,65 +340,63 @@ Task popL(list *l, Task target) {
  * - File I/O operations.
  */
 int saveOnFileList(list l, const char *filename) {
-    if (l == NULL || filename == NULL) {
-        printf("\nError: list or filename is NULL\n");
+    if (filename == NULL) {
+        fprintf(stderr, "\nError: list or filename is NULL\n");
         return 0;
     }
 
-    FILE *file = fopen(filename, "w");
-    if (file == NULL) {
-        printf("\nError opening file\n");
-        return 0;
-    }
+    int count = 0;
+    for (list temp = l; temp != NULL; temp = temp->next) count++;
+
+    DataWriter w = beginDataFile(filename, count, getLastTaskId());
+    if (w == NULL) return 0;
 
     while (l != NULL) {
-        fPrintTask(l->value, file);
+        writeRecord(w, l->value);
         l = l->next;
     }
-    fclose(file);
-
-    file = fopen(filename, "r");
-    if (file == NULL) {
-        printf("\nTemporary file error.\n");
-        return 0;
-    }
-
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fclose(file);
-
-    return (size > 0) ? 1 : (printf("\nFile was not updated correctly\n"), 0);
+    return endDataFile(w);
 }
 
 /* scanFileList
  * Syntax Specification:
- * list scanFileList(list l, FILE *f);
+ * list scanFileList(list l, FILE *f, bool *damaged);
  *
  * Semantic Specification:
- * Reads tasks from a file and constructs a list.
+ * Reads tasks from a file and constructs a list, verifying the block checksums.
+ * The records of the damaged blocks are dropped, the others are still read.
  *
  * Preconditions:
  * - 'f' must be a valid file pointer.
  *
  * Postconditions:
  * - Returns the populated list.
+ * - '*damaged' (if 'damaged' is not NULL) tells whether the file failed the integrity check.
  *
  * Side Effects:
  * - File I/O operations, memory allocation.
  */
-list scanFileList(list l, FILE *f) {
+list scanFileList(list l, FILE *f, bool *damaged) {
+    if (damaged != NULL) *damaged = false;
     if (f == NULL) {
-        printf("\nRead from file failed.\n");
+        fprintf(stderr, "\nRead from file failed.\n");
         return NULL;
     }
 
+    DataReader r = openDataFile(f);
+    if (r == NULL) {
+        fclose(f);
+        return l;
+    }
+
     Task item;
     while (1) {
-        item = fReadTask(f);
+        item = readRecord(r);
         if (item == NULL) break;
         l = consList(item, l);
     }
-    fclose(f);
+    bool valid = closeDataFile(r);
+    if (damaged != NULL) *damaged = !valid;
     return l;
 }
 
@@ -12,6 +12,7 @@ typedef struct node *list;
  Task getValue(list l);
  struct node *getNext(list l);
  Task getByLTitle(list l, char *c);
+ Task getByLId(list l, int id);
 
  list tailList(list l);
  Task popL (list *l, Task target);
@@ -19,6 +20,6 @@ typedef struct node *list;
  
  void printList(list);
  int saveOnFileList(list l, const char *c);
- list scanFileList(list l, FILE *f);
+ list scanFileList(list l, FILE *f, bool *damaged);
  
  
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "loader.h"
+#include "../task/task.h"
+#include "../datafile/datafile.h"
+#include "../crc/crc.h"
+
+// Files smaller than MIN_CHUNK_SIZE are parsed by the calling thread only
+#define MIN_CHUNK_SIZE 65536
+#define MAX_CHUNKS 8
+
+// A slice of the file buffer, always starting at the beginning of a line.
+// In files with header a chunk also ends right after a block checksum line,
+// so every chunk can verify its own blocks.
+struct chunk {
+    char *start;
+    char *end;
+    bool checked;
+    bool valid;
+    Task *items;
+    int numel;
+};
+
+/* readWholeFile
+ * Syntax Specification:
+ * static char *readWholeFile(const char *filename, long *size);
+ *
+ * Semantic Specification:
+ * Reads the entire content of a file into a null-terminated buffer.
+ *
+ * Preconditions:
+ * - 'filename' and 'size' must not be NULL.
+ *
+ * Postconditions:
+ * - Returns the buffer and stores its length in 'size', or NULL on error.
+ *
+ * Side Effects:
+ * - Reads from file.
+ * - Allocates memory.
+ */
+static char *readWholeFile(const char *filename, long *size) {
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) return NULL;
+
+    if (fseek(f, 0, SEEK_END) != 0 || (*size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return NULL;
+    }
+
+    char *buffer = malloc(*size + 1);
+    if (buffer == NULL) {
+        fclose(f);
+        return NULL;
+    }
+
+    *size = fread(buffer, 1, *size, f);
+    buffer[*size] = '\0';
+    fclose(f);
+    return buffer;
+}
+
+/* parseChunk
+ * Syntax Specification:
+ * static void *parseChunk(void *arg);
+ *
+ * Semantic Specification:
+ * Thread routine: parses every line of a chunk into a Task array. In files with
+ * header, the tasks of a block are kept only if the block checksum matches;
+ * in files without header, lines that do not match the task format are skipped.
+ *
+ * Preconditions:
+ * - 'arg' must point to a struct chunk whose 'end' is a line boundary.
+ *
+ * Postconditions:
+ * - 'items' and 'numel' of the chunk hold the parsed tasks in file order.
+ * - 'valid' is false if some block was damaged.
+ *
+ * Side Effects:
+ * - Overwrites the line terminators of the chunk.
+ * - Allocates memory.
+ */
+static void *parseChunk(void *arg) {
+    struct chunk *c = arg;
+    int tot = 64, blockStart = 0, count, lastId;
+    unsigned int blockCrc = 0, expected;
+    c->numel = 0;
+    c->valid = true;
+    c->items = malloc(tot * sizeof(Task));
+    if (c->items == NULL) {
+        c->valid = false;
+        return NULL;
+    }
+
+    char *line = c->start;
+    while (line < c->end) {
+        char *stop = memchr(line, '\n', c->end - line);
+        if (stop == NULL) stop = c->end;
+        *stop = '\0';
+        if (stop > line && stop[-1] == '\r') stop[-1] = '\0';
+        char *next = stop + 1;
+
+        if (c->checked && isBlockLine(line, &expected)) {
+            if (expected != blockCrc) {
+                for (int i = blockStart; i < c->numel; i++) freeTask(c->items[i]);
+                c->numel = blockStart;
+                c->valid = false;
+            }
+            blockStart = c->numel;
+            blockCrc = 0;
+            line = next;
+            continue;
+        }
+        if (c->checked && isHeaderLine(line, &count, &expected, &lastId)) {
+            line = next;
+            continue;
+        }
+
+        if (c->checked) blockCrc = crc32c(blockCrc, line, strlen(line));
+        Task t = sReadTask(line);
+        if (t == NULL) {
+            if (c->checked) c->valid = false;
+        } else {
+            if (c->numel == tot) {
+                tot *= 2;
+                Task *temp = realloc(c->items, tot * sizeof(Task));
+                if (temp == NULL) {
+                    freeTask(t);
+                    c->valid = false;
+                    break;
+                }
+                c->items = temp;
+            }
+            c->items[c->numel++] = t;
+        }
+        line = next;
+    }
+
+    // records after the last checksum line: the file was truncated
+    if (c->checked && c->numel > blockStart) {
+        for (int i = blockStart; i < c->numel; i++) freeTask(c->items[i]);
+        c->numel = blockStart;
+        c->valid = false;
+    }
+    return NULL;
+}
+
+/* nextBoundary
+ * Syntax Specification:
+ * static char *nextBoundary(char *from, char *end, bool checked);
+ *
+ * Semantic Specification:
+ * Finds where a chunk starting before 'from' can end: after the next newline,
+ * or after the next block checksum line in files with header.
+ *
+ * Preconditions:
+ * - 'from' and 'end' must point into the same buffer, 'from' <= 'end'.
+ *
+ * Postconditions:
+ * - Returns a position in (from, end], or 'end'.
+ *
+ * Side Effects:
+ * - None.
+ */
+static char *nextBoundary(char *from, char *end, bool checked) {
+    char *stop = memchr(from, '\n', end - from);
+    if (stop == NULL) return end;
+    stop++;
+
+    while (checked && stop < end) {
+        char *nl = memchr(stop, '\n', end - stop);
+        char *lineEnd = (nl != NULL) ? nl + 1 : end;
+        if (strncmp(stop, "#B\t", 3) == 0) return lineEnd;
+        stop = lineEnd;
+    }
+    return stop;
+}
+
+/* loadTasks
+ * Syntax Specification:
+ * int loadTasks(const char *filename, Task **items, int *lastId, bool *damaged);
+ *
+ * Semantic Specification:
+ * Reads all the tasks of a data file into an array. Large files are split on
+ * line boundaries (block boundaries for files with header) and the chunks are
+ * parsed in parallel, one thread each. Each chunk verifies its block checksums
+ * and the total is compared with the record count of the header.
+ *
+ * Preconditions:
+ * - 'filename' and 'items' must not be NULL.
+ *
+ * Postconditions:
+ * - '*items' is a new array with the tasks in file order and '*lastId' the id
+ *   counter saved in the header. The ids are not registered yet (see assignTaskId),
+ *   since more files can be loaded concurrently.
+ * - '*damaged' (if 'damaged' is not NULL) tells whether the file failed the integrity check.
+ * - Returns the number of tasks read, or -1 if the file cannot be read.
+ *
+ * Side Effects:
+ * - Reads from file.
+ * - Creates threads and allocates memory.
+ */
+int loadTasks(const char *filename, Task **items, int *lastId, bool *damaged) {
+    long size = 0;
+    *lastId = 0;
+    if (damaged != NULL) *damaged = false;
+    char *buffer = readWholeFile(filename, &size);
+    if (buffer == NULL) return -1;
+
+    int count = -1;
+    unsigned int crc;
+    bool checked = isHeaderLine(buffer, &count, &crc, lastId);
+    // header of a newer version: its records may not match the task format
+    bool newer = !checked && strncmp(buffer, "#PSD\t", 5) == 0;
+    if (newer) size = 0;
+
+    int nChunks = size / MIN_CHUNK_SIZE;
+    if (nChunks < 1) nChunks = 1;
+    if (nChunks > MAX_CHUNKS) nChunks = MAX_CHUNKS;
+
+    // every chunk ends right after a newline, so no line is split in two
+    struct chunk chunks[MAX_CHUNKS];
+    char *start = buffer, *end = buffer + size;
+    for (int i = 0; i < nChunks; i++) {
+        char *stop = end;
+        if (i < nChunks - 1 && buffer + (size / nChunks) * (i + 1) > start) {
+            stop = nextBoundary(buffer + (size / nChunks) * (i + 1) - 1, end, checked);
+        }
+        chunks[i].start = start;
+        chunks[i].end = stop;
+        chunks[i].checked = checked;
+        start = stop;
+    }
+
+    pthread_t threads[MAX_CHUNKS];
+    bool started[MAX_CHUNKS];
+    for (int i = 1; i < nChunks; i++) {
+        started[i] = pthread_create(&threads[i], NULL, parseChunk, &chunks[i]) == 0;
+        if (!started[i]) parseChunk(&chunks[i]);
+    }
+    parseChunk(&chunks[0]);
+    for (int i = 1; i < nChunks; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+
+    int numel = 0;
+    bool valid = true;
+    for (int i = 0; i < nChunks; i++) {
+        numel += chunks[i].numel;
+        valid = valid && chunks[i].valid;
+    }
+    // the CRC of the whole file is not recomputed here: the block checksums cover every record
+    if (newer || (checked && numel != count)) valid = false;
+    if (damaged != NULL) *damaged = !valid;
+
+    *items = malloc((numel > 0 ? numel : 1) * sizeof(Task));
+    int k = 0;
+    for (int i = 0; i < nChunks; i++) {
+        for (int j = 0; j < chunks[i].numel; j++) {
+            if (*items != NULL) (*items)[k++] = chunks[i].items[j];
+            else freeTask(chunks[i].items[j]);
+        }
+        free(chunks[i].items);
+    }
+    free(buffer);
+
+    return (*items != NULL) ? k : -1;
+}
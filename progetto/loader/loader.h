@@ -0,0 +1,4 @@
+#include "../task/task.h"
+
+ //loader prototypes
+int loadTasks(const char *filename, Task **items, int *lastId, bool *damaged);
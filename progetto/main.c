@@ -1,8 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "./planner/planner.h"
+#include "./menu/menu.h"
+#include "./batch/batch.h"
+
+int batchMode(char *date, const char *filename);
+
+int main(int argc, char *argv[]) {
+    // progetto --batch ddmmyyyy [file]: commands from the file (or stdin) instead of the menu
+    if (argc >= 2 && strcmp(argv[1], "--batch") == 0) return batchMode(argc > 2 ? argv[2] : NULL, argc > 3 ? argv[3] : NULL);
 
-int main(void) {
     //for testing pourpose use getCurrentDateML() to set manualy the date
     today = getCurrentDateML();
     Planner planner = openPlanner();
@@ -26,6 +34,17 @@ int main(void) {
         printf("6. Clear the history\n");
         printf("7. View your progress\n");
         printf("8. View your weekly report\n");
+        printf("9. Import tasks from file\n");
+        printf("10. Export the planner (JSON/CSV)\n");
+        printf("11. View the course overview\n");
+        printf("12. Plan your study days\n");
+        printf("13. View the upcoming deadlines\n");
+        printf("14. Search the tasks\n");
+        printf("15. Search the tasks by words\n");
+        printf("16. Manage the recurring tasks\n");
+        printf("17. Plan the order of the tasks\n");
+        printf("18. Undo or redo the last changes\n");
+        printf("19. Track your study time\n");
         printf("0. Close the planner\n");
         printf("\n\n\t      -----------------------\n\n");
         printf("Choose an option: ");
@@ -41,7 +60,23 @@ int main(void) {
             case 6: deleteHistory(planner); break;
             case 7: showTaskProgress(planner); break;
             case 8: weeklyReport(planner); break;
-            case 0: closePlanner(planner); break;
+            case 9: importTasks(planner); break;
+            case 10: exportPlanner(planner); break;
+            case 11: showCourseOverview(planner); break;
+            case 12: showStudyPlan(planner); break;
+            case 13: showDueTasks(planner); break;
+            case 14: searchTasks(planner); break;
+            case 15: searchWords(planner); break;
+            case 16: recurringTasks(planner); break;
+            case 17: taskDependencies(planner); break;
+            case 18: undoChanges(planner); break;
+            case 19: studySessions(planner); break;
+            case 0: {
+                closePlanner(planner);
+                clearScreen();
+                printf("\n--- Study session ended ---\n");
+                break;
+            }
             default: printf("Invalid choice. retry\n");
         }
     } while (choice != 0);
@@ -49,3 +84,33 @@ int main(void) {
     return 0;
 }
 
+// Applies the commands of the file (stdin if NULL) on the given date, with one open and one close;
+// the errors that stop it are result lines of line 0, on stdout like the others
+int batchMode(char *date, const char *filename) {
+    if (date == NULL) {
+        printf("error\t0\tusage: progetto --batch ddmmyyyy [file]\n");
+        return 2;
+    }
+    // 'today' is still NULL: only the format of the date is checked
+    if (!isValidDate(date)) {
+        printf("error\t0\tthe date must be ddmmyyyy\n");
+        return 2;
+    }
+    FILE *in = (filename != NULL) ? fopen(filename, "r") : stdin;
+    if (in == NULL) {
+        printf("error\t0\tunable to open '%s'\n", filename);
+        return 2;
+    }
+
+    today = date;
+    Planner planner = openPlanner();
+    if (planner == NULL) {
+        printf("error\t0\tunable to open the planner\n");
+        if (in != stdin) fclose(in);
+        return 2;
+    }
+    int errors = runBatch(planner, in, stdout);
+    closePlanner(planner);
+    if (in != stdin) fclose(in);
+    return errors > 0;
+}
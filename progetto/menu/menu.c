@@ -0,0 +1,854 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../planner/planner.h"
+#include "menu.h"
+
+// Interactive front end of the planner API: the functions ask the fields on the
+// terminal, then leave every change to the API
+
+// Tasks shown by searchTasks and searchWords
+#define SEARCH_SHOWN 50
+
+// Titles suggested when the one entered is not found
+#define TITLES_SHOWN 9
+
+// Ready tasks shown by taskDependencies
+#define READY_SHOWN 10
+
+// Tasks in progress shown by studySessions
+#define STUDY_SHOWN 20
+
+/* readPriority
+ * Syntax Specification:
+ * static void readPriority(const char *prompt, const char *error, char *pTxt);
+ *
+ * Semantic Specification:
+ * Asks the priority until it is "low", "medium" or "high".
+ *
+ * Preconditions:
+ * - 'pTxt' must have room for 7 characters.
+ *
+ * Postconditions:
+ * - 'pTxt' holds a valid priority.
+ *
+ * Side Effects:
+ * - User interaction.
+ */
+static void readPriority(const char *prompt, const char *error, char *pTxt) {
+    while (1) {
+        printf("%s", prompt);
+        read(6, pTxt);
+
+        if ((strcmp(pTxt, "low") == 0) || (strcmp(pTxt, "medium") == 0) || (strcmp(pTxt, "high") == 0)) break;
+        printf("%s", error);
+        memset(pTxt, '\0', 7);
+    }
+}
+
+/* readDeadline
+ * Syntax Specification:
+ * static void readDeadline(const char *prompt, const char *error, char *deadline, bool clear);
+ *
+ * Semantic Specification:
+ * Asks the deadline until it is a valid date, not past.
+ *
+ * Preconditions:
+ * - 'deadline' must have room for 9 characters.
+ *
+ * Postconditions:
+ * - 'deadline' holds a valid date.
+ *
+ * Side Effects:
+ * - User interaction; if 'clear' the input buffer is cleared before every request.
+ */
+static void readDeadline(const char *prompt, const char *error, char *deadline, bool clear) {
+    strcpy(deadline, "00000000");
+    while (!isValidDate(deadline)) {
+        if (clear) clearBuffer();
+        printf("%s", prompt);
+        read(8, deadline);
+        if (!isValidDate(deadline)) {
+            printf("%s", error);
+        }
+    }
+}
+
+/* insert
+ * Syntax Specification:
+ * int insert(Planner p);
+ *
+ * Semantic Specification:
+ * Asks the fields of a new task and adds it to the in-progress queue with plannerAddTask.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was added, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction, modifies the in-progress queue.
+ */
+int insert(Planner p) {
+    if (p == NULL) {
+        printf("\nPlanner not initialized.\n");
+        return 0;
+    }
+
+    char title[21], description[256], course[51], deadline[9], pTxt[7];
+    struct taskFields f = { title, description, course, 0, deadline, pTxt };
+
+    clearBuffer();
+    printf("\nEnter title (max 20): ");
+    read(20, title);
+    printf("\nEnter description (max 255): ");
+    read(255, description);
+    printf("\nEnter course name (max 50): ");
+    read(50, course);
+
+    do {
+        printf("\nEnter estimated time (in minutes): ");
+        scanf("%d", &f.estimatedTime);
+        if (f.estimatedTime < 0) printf("\nError: estimated time cannot be negative.");
+    } while (f.estimatedTime < 0);
+
+    readDeadline("\nEnter deadline (format ddmmyyyy): ", "\n!! Invalid date !! Try again !!", deadline, true);
+    readPriority("\nEnter priority level (low/medium/high): ", "\n!! Error, try again !!", pTxt);
+
+    int id = plannerAddTask(p, &f);
+    if (id > 0) {
+        clearScreen();
+        printf("\nNew data added:\n");
+        printTaskDetails(plannerGetTask(p, id));
+        printf("\n\nTask successfully added to the in-progress queue.\n");
+    } else {
+        printf("\n\nError: task insertion into the in-progress queue failed (%s).\n", plannerError(id));
+    }
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return id > 0;
+}
+
+/* pickSuggestion
+ * Syntax Specification:
+ * static int pickSuggestion(Planner p, char *title, unsigned int states);
+ *
+ * Semantic Specification:
+ * Called when no task has the title entered: shows the titles of the collections
+ * in 'states' starting with it or a few typos away (see plannerSuggestTitles) and
+ * lets the user pick one of them.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'title' must have room for 21 characters.
+ *
+ * Postconditions:
+ * - Returns the id of the task picked, with its title in 'title', or PLANNER_ENOTFOUND.
+ *
+ * Side Effects:
+ * - User interaction; loads the history if needed.
+ */
+static int pickSuggestion(Planner p, char *title, unsigned int states) {
+    if (title[0] == '\0') return PLANNER_ENOTFOUND;
+    Task tasks[TITLES_SHOWN];
+    int numel = plannerSuggestTitles(p, title, states, tasks, TITLES_SHOWN);
+    if (numel <= 0) return PLANNER_ENOTFOUND;
+
+    printf("\nNo task with title '%s'. Did you mean:\n", title);
+    for (int i = 0; i < numel; i++) printf("%d. %s\n", i + 1, getTitle(tasks[i]));
+    int choice;
+    do {
+        printf("\nChoose a task (0 for none): ");
+        if (scanf("%d", &choice) != 1) choice = 0;
+    } while (choice < 0 || choice > numel);
+    clearBuffer();
+    if (choice == 0) return PLANNER_ENOTFOUND;
+
+    strcpy(title, getTitle(tasks[choice - 1]));
+    return getId(tasks[choice - 1]);
+}
+
+/* selectTask
+ * Syntax Specification:
+ * static int selectTask(Planner p, const char *action, char *title);
+ *
+ * Semantic Specification:
+ * Asks the title of a task in progress and shows it, until the user confirms it.
+ * A title not found can be replaced by one of the suggestions.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'title' must have room for 21 characters.
+ *
+ * Postconditions:
+ * - Returns the id of the task, or PLANNER_ENOTFOUND; 'title' holds the title entered.
+ *
+ * Side Effects:
+ * - User interaction.
+ */
+static int selectTask(Planner p, const char *action, char *title) {
+    char ans;
+    int id;
+    do {
+        clearBuffer();
+        printf("\nEnter the title of the task to %s: ", action);
+        read(20, title);
+        id = plannerFindTask(p, title);
+        if (id < 0) id = pickSuggestion(p, title, QUERY_PROGRESS);
+        printf("\nThe selected task is: \n\n");
+        printTaskDetails(plannerGetTask(p, id));
+        printf("\n\nWould you pick another task? (y/n) ");
+        scanf("%c", &ans);
+    } while (ans != 'n');
+    return id;
+}
+
+/* modifyTask
+ * Syntax Specification:
+ * Planner modifyTask(Planner p);
+ *
+ * Semantic Specification:
+ * Asks a task in progress, then changes one field at a time with plannerUpdate
+ * until the user returns to the main menu. A completion of 100% completes the task.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 'p', or NULL if the planner does not exist.
+ *
+ * Side Effects:
+ * - User interaction, modifies the task.
+ */
+Planner modifyTask(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return NULL;
+    }
+
+    char title[21];
+    int choice;
+    int id = selectTask(p, "modify", title);
+
+    do {
+        clearScreen();
+        printf("\n\n\t      --- Modification Menu ---\n\n");
+        printf("1. Change title\n");
+        printf("2. Change description\n");
+        printf("3. Change course\n");
+        printf("4. Change estimated time\n");
+        printf("5. Change deadline\n");
+        printf("6. Change priority\n");
+        printf("7. Change completion percentage\n");
+        printf("8. See the changes made\n");
+        printf("0. Return to main menu\n");
+        printf("Choose an option: ");
+        scanf("%d", &choice);
+
+        struct taskPatch patch = { 0 };
+        char newDescription[256], newCourse[51], newDeadline[9], pTxt[7];
+        const char *done = NULL;
+        switch (choice) {
+            case 1: {
+                clearBuffer(); 
+                printf("\nEnter the new title (max 20): ");
+                read(20, title);
+                patch.fields = PATCH_TITLE;
+                patch.title = title;
+                done = "Title successfully changed to '%s'.";
+                break;
+            }
+            case 2: {
+                clearBuffer(); 
+                printf("\nEnter the new description (max 255): ");
+                read(255, newDescription);
+                patch.fields = PATCH_DESCRIPTION;
+                patch.description = newDescription;
+                done = "Description successfully changed for task '%s'.";
+                break;
+            }
+            case 3: {
+                clearBuffer(); 
+                printf("\nEnter the new course (max 50): ");
+                read(50, newCourse);
+                patch.fields = PATCH_COURSE;
+                patch.course = newCourse;
+                done = "Course successfully changed for task '%s'.";
+                break;
+            }
+            case 4: {
+                clearBuffer();
+                int newEstimatedTime = 0;
+                do {
+                    if (newEstimatedTime < 0) printf("\nError: estimated time cannot be negative.");
+                    printf("\nEnter the new estimated time (in minutes): ");
+                    scanf("%d", &newEstimatedTime);
+                } while (newEstimatedTime < 0);
+                patch.fields = PATCH_TIME;
+                patch.estimatedTime = newEstimatedTime;
+                done = "Estimated time successfully changed for task '%s'.";
+                break;
+            }
+            case 5: {
+                clearBuffer(); 
+                readDeadline("\nEnter the new deadline (format ddmmyyyy): ", "\n!! Invalid date !! Please try again !!",
+                             newDeadline, false);
+                patch.fields = PATCH_DEADLINE;
+                patch.deadline = newDeadline;
+                done = "Deadline successfully changed for task '%s'.";
+                break;
+            }
+            case 6: {
+                clearBuffer(); 
+                readPriority("\nEnter priority level (low/medium/high): ", "\n!! Error: Invalid input, please try again !!", pTxt);
+                patch.fields = PATCH_PRIORITY;
+                patch.priority = pTxt;
+                done = "Priority successfully changed for task '%s'.";
+                break;
+            }
+            case 7: {
+                clearBuffer(); 
+                float newPerc;
+                do {
+                    printf("\nEnter the new completion percentage (0-100): ");
+                    scanf("%f", &newPerc);
+                    if (newPerc < 0 || newPerc > 100) {
+                        printf("\nError: The percentage must be between 0 and 100.\n");
+                    }
+                } while (newPerc < 0 || newPerc > 100);
+
+                patch.fields = PATCH_COMPLETION;
+                patch.completion = newPerc;
+                if (newPerc == 100.0) {
+                    printf("\nGreat job, the task is complete\n");
+                    done = "Task '%s' successfully completed.";
+                } else {
+                    done = "Completion percentage successfully changed for task '%s'.";
+                }
+                break;
+            }
+            case 8: {
+                printTaskDetails(plannerGetTask(p, id));
+                printf("\n\nPress x to continue...\n");
+                while (getchar() != 'x');
+                break;}
+            case 0: break;
+            default: printf("Invalid choice, please try again.\n");
+        }
+
+        if (patch.fields != 0) {
+            int result = plannerUpdate(p, id, &patch);
+            if (result > 0) {
+                printf("\n");
+                printf(done, title);
+                printf("\n");
+            } else {
+                printf("\nError: %s.\n", plannerError(result));
+            }
+        }
+    } while (choice != 0);
+
+    return p;
+}
+
+/* deleteTask
+ * Syntax Specification:
+ * int deleteTask(Planner p);
+ *
+ * Semantic Specification:
+ * Asks a task in progress and deletes it with plannerDelete.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was deleted, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction, modifies the in-progress queue.
+ */
+int deleteTask(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    char title[21];
+    int id = selectTask(p, "delete", title);
+    return plannerDelete(p, id) > 0;
+}
+
+/* restoreExpiredTask
+ * Syntax Specification:
+ * int restoreExpiredTask(Planner p);
+ *
+ * Semantic Specification:
+ * Asks an expired task with its new priority and deadline, and moves it back to
+ * the in-progress queue with plannerRestore.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was restored, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction, modifies the Planner collections.
+ */
+int restoreExpiredTask(Planner p) {
+    if (p == NULL) {
+        printf("\nError: the queue or the list is empty or non-existent\n");
+        return 0;
+    }
+    char title[21];
+    clearBuffer();
+    printf("\nEnter the title of the task to restore: ");
+    read(20, title);
+
+    clearScreen();
+    printf("\n\n      --- Restore Expired Task ---\n\n");
+    int id = plannerFindExpired(p, title);
+    if (id < 0) id = pickSuggestion(p, title, QUERY_EXPIRED);
+    if (id < 0) {
+        printf("\nTask with title '%s' not found in the expired list.\n", title);
+        return 0;
+    }
+
+    char pTxt[7], newDeadline[9];
+    readPriority("\nEnter the priority level (low/medium/high): ", "\n!! Error: invalid input, please try again !!", pTxt);
+    readDeadline("\nEnter the new deadline (format ddmmyyyy): ", "\n!! Invalid date !! Please try again !!", newDeadline, false);
+
+    int result = plannerRestore(p, id, newDeadline, pTxt);
+    if (result > 0) printf("\nTask '%s' successfully restored.\n", title);
+    else printf("\nError: %s.\n", plannerError(result));
+    return result > 0;
+}
+
+/* searchTasks
+ * Syntax Specification:
+ * int searchTasks(Planner p);
+ *
+ * Semantic Specification:
+ * Asks a course, a priority and a number of days (each one may be left out) and
+ * shows the tasks satisfying all of them found by plannerQuery, by deadline.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the search was done, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction; loads the history if the search includes it.
+ */
+int searchTasks(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    char course[51], pTxt[7], from[9], to[9], ans;
+    int days = -1, n;
+    struct taskQuery q = { 0 };
+    q.states = QUERY_PROGRESS;
+    q.sort = QUERY_SORT_DEADLINE;
+
+    clearBuffer();
+    printf("\nEnter the course (empty for any): ");
+    if (read(50, course) > 0) {
+        q.filters |= QUERY_COURSE;
+        q.course = course;
+    }
+    do {
+        printf("\nEnter the priority level (low/medium/high, empty for any): ");
+        n = read(6, pTxt);
+    } while (n > 0 && strcmp(pTxt, "low") != 0 && strcmp(pTxt, "medium") != 0 && strcmp(pTxt, "high") != 0);
+    if (n > 0) {
+        q.filters |= QUERY_PRIORITY;
+        q.minPriority = q.maxPriority = (pTxt[0] == 'l') ? 1 : (pTxt[0] == 'm') ? 2 : 3;
+    }
+    while (days < 0) {
+        printf("\nDue within how many days? (0 for any): ");
+        scanf("%d", &days);
+    }
+    if (days > 0) {
+        q.filters |= QUERY_DEADLINE;
+        strcpy(from, today);
+        daysToDate(dateToDays(today) + days, to);
+        q.deadlineFrom = from;
+        q.deadlineTo = to;
+    }
+    printf("\nInclude the completed and expired tasks? (y/n) ");
+    scanf(" %c", &ans);
+    if (ans == 'y') q.states = 0;
+
+    Task *tasks;
+    int numel = plannerQuery(p, &q, &tasks);
+    clearScreen();
+    printf("\n\n\t      --- Search results ---\n\n");
+    if (numel < 0) {
+        printf("\nError: %s.\n", plannerError(numel));
+    } else if (numel == 0) {
+        printf("\nNo task found.\n");
+    } else {
+        for (int i = 0; i < numel && i < SEARCH_SHOWN; i++) printTask(tasks[i]);
+        if (numel > SEARCH_SHOWN) printf("\n... and %d more.\n", numel - SEARCH_SHOWN);
+        printf("\n%d tasks found.\n", numel);
+    }
+    free(tasks);
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return numel >= 0;
+}
+
+/* searchWords
+ * Syntax Specification:
+ * int searchWords(Planner p);
+ *
+ * Semantic Specification:
+ * Asks some words and shows the tasks (in progress, completed or expired) having
+ * all of them in their title, description or course, found by plannerSearchText.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the search was done, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction; loads the history and the text index if needed.
+ */
+int searchWords(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    char words[101];
+    clearBuffer();
+    do {
+        printf("\nEnter the words to search: ");
+    } while (read(100, words) == 0);
+
+    Task *tasks;
+    int numel = plannerSearchText(p, words, &tasks);
+    clearScreen();
+    printf("\n\n\t      --- Search results ---\n\n");
+    if (numel < 0) {
+        printf("\nError: %s.\n", plannerError(numel));
+    } else if (numel == 0) {
+        printf("\nNo task found.\n");
+    } else {
+        for (int i = 0; i < numel && i < SEARCH_SHOWN; i++) printTask(tasks[i]);
+        if (numel > SEARCH_SHOWN) printf("\n... and %d more.\n", numel - SEARCH_SHOWN);
+        printf("\n%d tasks found.\n", numel);
+    }
+    free(tasks);
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return numel >= 0;
+}
+
+/* insertRecurring
+ * Syntax Specification:
+ * static int insertRecurring(Planner p);
+ *
+ * Semantic Specification:
+ * Asks the fields of a recurring task, the days between two occurrences and the
+ * last deadline, and adds it with plannerAddRecurring.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the recurring task was added, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction; may add the first occurrences to the in-progress queue.
+ */
+static int insertRecurring(Planner p) {
+    char title[21], description[256], course[51], deadline[9], until[9], pTxt[7];
+    struct taskFields f = { title, description, course, 0, deadline, pTxt };
+    int every;
+
+    clearBuffer();
+    printf("\nEnter title (max 20): ");
+    read(20, title);
+    printf("\nEnter description (max 255): ");
+    read(255, description);
+    printf("\nEnter course name (max 50): ");
+    read(50, course);
+
+    do {
+        printf("\nEnter estimated time (in minutes): ");
+        scanf("%d", &f.estimatedTime);
+        if (f.estimatedTime < 0) printf("\nError: estimated time cannot be negative.");
+    } while (f.estimatedTime < 0);
+
+    readDeadline("\nEnter the first deadline (format ddmmyyyy): ", "\n!! Invalid date !! Try again !!", deadline, true);
+    readPriority("\nEnter priority level (low/medium/high): ", "\n!! Error, try again !!", pTxt);
+    do {
+        printf("\nRepeat every how many days? (7 for every week): ");
+        scanf("%d", &every);
+    } while (every <= 0);
+    do {
+        readDeadline("\nEnter the last deadline (format ddmmyyyy): ", "\n!! Invalid date !! Try again !!", until, true);
+    } while (compareDates(until, deadline) < 0);
+
+    int id = plannerAddRecurring(p, &f, every, until);
+    if (id > 0) printf("\nRecurring task '%s' added.\n", title);
+        else printf("\nError: %s.\n", plannerError(id));
+    return id > 0;
+}
+
+/* recurringTasks
+ * Syntax Specification:
+ * int recurringTasks(Planner p);
+ *
+ * Semantic Specification:
+ * Shows the recurring tasks with their next deadline, and lets the user add new
+ * ones or stop them, until the user returns to the main menu.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1, or 0 if the planner does not exist.
+ *
+ * Side Effects:
+ * - User interaction, modifies the recurring tasks.
+ */
+int recurringTasks(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    int choice;
+    do {
+        clearScreen();
+        printf("\n\n\t      --- Recurring tasks ---\n\n");
+        struct recurrence *rules;
+        int numel = plannerGetRecurring(p, &rules);
+        if (numel <= 0) printf("No recurring task.\n");
+        for (int i = 0; i < numel; i++) {
+            char next[9], until[9];
+            daysToDate(rules[i].next, next);
+            daysToDate(rules[i].until, until);
+            printf("%d. %s (%s) every %d days, next deadline ", rules[i].id, rules[i].title, rules[i].course, rules[i].every);
+            printDate(next);
+            printf(", until ");
+            printDate(until);
+            printf("\n");
+        }
+        printf("\n1. Add a recurring task\n");
+        printf("2. Stop a recurring task\n");
+        printf("0. Return to main menu\n");
+        printf("Choose an option: ");
+        scanf("%d", &choice);
+
+        if (choice == 1) {
+            insertRecurring(p);
+        } else if (choice == 2) {
+            int id;
+            printf("\nEnter the number of the recurring task to stop: ");
+            scanf("%d", &id);
+            int result = plannerStopRecurring(p, id);
+            if (result > 0) printf("\nRecurring task stopped: the tasks already in progress are kept.\n");
+                else printf("\nError: %s.\n", plannerError(result));
+        }
+        if (choice == 1 || choice == 2) {
+            printf("\n\nPress x to continue...\n");
+            while (getchar() != 'x');
+        }
+    } while (choice != 0);
+    return 1;
+}
+
+// Asks the title of a task in progress, with the suggestions if it is not found
+static int readTaskId(Planner p, const char *prompt, char *title) {
+    clearBuffer();
+    printf("%s", prompt);
+    read(20, title);
+    int id = plannerFindTask(p, title);
+    return (id >= 0) ? id : pickSuggestion(p, title, QUERY_PROGRESS);
+}
+
+/* taskDependencies
+ * Syntax Specification:
+ * int taskDependencies(Planner p);
+ *
+ * Semantic Specification:
+ * Shows the ready tasks (see plannerReadyTasks), the first being the next one
+ * to work on, and lets the user add or remove prerequisites between the tasks
+ * in progress, until the user returns to the main menu.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1, or 0 if the planner does not exist.
+ *
+ * Side Effects:
+ * - User interaction, modifies the prerequisites.
+ */
+int taskDependencies(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    int choice;
+    do {
+        clearScreen();
+        printf("\n\n\t      --- Ready tasks ---\n\n");
+        Task ready[READY_SHOWN];
+        int numel = plannerReadyTasks(p, ready, READY_SHOWN);
+        if (numel < 0) printf("Error: %s.\n", plannerError(numel));
+            else if (numel == 0) printf("No task is ready.\n");
+        for (int i = 0; i < numel; i++) {
+            printf("%d. %s (%s), deadline ", i + 1, getTitle(ready[i]), getCourse(ready[i]));
+            printDate(getDeadline(ready[i]));
+            printf("\n");
+        }
+        printf("\n1. Add a prerequisite\n");
+        printf("2. Remove a prerequisite\n");
+        printf("0. Return to main menu\n");
+        printf("Choose an option: ");
+        scanf("%d", &choice);
+
+        if (choice == 1 || choice == 2) {
+            char title[21], first[21];
+            int id = readTaskId(p, "\nEnter the title of the task that waits: ", title);
+            int prerequisite = (id >= 0) ? readTaskId(p, "\nEnter the title of the task to finish first: ", first) : id;
+            int result = PLANNER_ENOTFOUND;
+            if (prerequisite >= 0) {
+                result = (choice == 1) ? plannerAddPrerequisite(p, id, prerequisite) : plannerRemovePrerequisite(p, id, prerequisite);
+            }
+            if (result > 0 && choice == 1) printf("\n'%s' now waits for '%s'.\n", title, first);
+                else if (result > 0) printf("\n'%s' no longer waits for '%s'.\n", title, first);
+                else printf("\nError: %s.\n", plannerError(result));
+            printf("\n\nPress x to continue...\n");
+            while (getchar() != 'x');
+        }
+    } while (choice != 0);
+    return 1;
+}
+
+/* undoChanges
+ * Syntax Specification:
+ * int undoChanges(Planner p);
+ *
+ * Semantic Specification:
+ * Lets the user undo the last changes of the session, and redo the ones undone,
+ * until the user returns to the main menu.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1, or 0 if the planner does not exist.
+ *
+ * Side Effects:
+ * - User interaction, modifies the Planner collections.
+ */
+int undoChanges(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    int choice;
+    do {
+        clearScreen();
+        printf("\n\n\t      --- Undo ---\n\n");
+        printf("1. Undo the last change\n");
+        printf("2. Redo the last change undone\n");
+        printf("0. Return to main menu\n");
+        printf("Choose an option: ");
+        scanf("%d", &choice);
+
+        if (choice == 1 || choice == 2) {
+            int result = (choice == 1) ? plannerUndo(p) : plannerRedo(p);
+            if (result > 0) printf("\n%s: %d tasks changed.\n", (choice == 1) ? "Undone" : "Redone", result);
+                else if (result == PLANNER_ENOTFOUND) printf("\nNothing to %s.\n", (choice == 1) ? "undo" : "redo");
+                else printf("\nError: %s.\n", plannerError(result));
+            printf("\n\nPress x to continue...\n");
+            while (getchar() != 'x');
+        }
+    } while (choice != 0);
+    return 1;
+}
+
+/* studySessions
+ * Syntax Specification:
+ * int studySessions(Planner p);
+ *
+ * Semantic Specification:
+ * Shows the minutes spent on the tasks in progress next to their estimated
+ * time, by deadline, and lets the user start or stop a study session on a task,
+ * or add the minutes of one that was not timed, until the user returns to the
+ * main menu.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1, or 0 if the planner does not exist.
+ *
+ * Side Effects:
+ * - User interaction, writes the time log.
+ */
+int studySessions(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist.\n");
+        return 0;
+    }
+
+    int choice;
+    do {
+        clearScreen();
+        printf("\n\n\t      --- Study time ---\n\n");
+        struct taskQuery q = { 0 };
+        q.states = QUERY_PROGRESS;
+        q.sort = QUERY_SORT_DEADLINE;
+        Task *tasks;
+        int numel = plannerQuery(p, &q, &tasks);
+        if (numel < 0) printf("Error: %s.\n", plannerError(numel));
+            else if (numel == 0) printf("No task in progress.\n");
+        for (int i = 0; i < numel && i < STUDY_SHOWN; i++) {
+            struct taskTime t;
+            if (plannerStudyTime(p, getId(tasks[i]), &t) < 0) break;
+            printf("%s (%s): %ld of %d minutes estimated, %d sessions%s\n", getTitle(tasks[i]), getCourse(tasks[i]),
+                   t.minutes, getExdTime(tasks[i]), t.sessions, t.started ? ", studying now" : "");
+        }
+        if (numel > STUDY_SHOWN) printf("\n... and %d more.\n", numel - STUDY_SHOWN);
+        free(tasks);
+        printf("\n1. Start studying a task\n");
+        printf("2. Stop studying a task\n");
+        printf("3. Add the minutes of a past session\n");
+        printf("0. Return to main menu\n");
+        printf("Choose an option: ");
+        scanf("%d", &choice);
+
+        if (choice >= 1 && choice <= 3) {
+            char title[21];
+            int minutes = 0, result = readTaskId(p, "\nEnter the title of the task: ", title);
+            if (result >= 0 && choice == 1) {
+                result = plannerStartStudy(p, result);
+            } else if (result >= 0 && choice == 2) {
+                result = plannerStopStudy(p, result, &minutes);
+            } else if (result >= 0) {
+                printf("\nEnter the minutes studied: ");
+                scanf("%d", &minutes);
+                result = plannerLogStudy(p, result, minutes);
+            }
+            if (result > 0 && choice == 1) printf("\nStudying '%s': stop the session when you are done.\n", title);
+                else if (result > 0) printf("\n%d minutes added to '%s'.\n", minutes, title);
+                else printf("\nError: %s.\n", plannerError(result));
+            printf("\n\nPress x to continue...\n");
+            while (getchar() != 'x');
+        }
+    } while (choice != 0);
+    return 1;
+}
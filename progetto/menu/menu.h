@@ -0,0 +1,14 @@
+// Forward declaration of the planner struct
+typedef struct planner *Planner;
+
+ //menu prototypes
+int insert(Planner p);
+Planner modifyTask(Planner p);
+int deleteTask(Planner p);
+int restoreExpiredTask(Planner p);
+int searchTasks(Planner p);
+int searchWords(Planner p);
+int recurringTasks(Planner p);
+int taskDependencies(Planner p);
+int undoChanges(Planner p);
+int studySessions(Planner p);
@@ -3,13 +3,71 @@
 #include <stdlib.h>
 #include "pQueue.h"
 #include "../task/task.h"
+#include "../datafile/datafile.h"
 
+// The heap is kept in 'arr'; 'pos' maps the id of every task to its position in
+// 'arr', so that a task is found by id in O(1). The array grows with the largest id.
 struct PQ {
     int tot;
     Task *arr;
     int numel;
+    int *pos;                   // position of the task with the id, -1 if not in the queue
+    int posSize;                // ids covered by 'pos'
+    bool failed;                // an id could not be placed in 'pos': lookups scan 'arr'
 };
 
+// Grows 'pos' to cover 'id'
+static bool reserveIds(pQueue q, int id) {
+    if (id < q->posSize) return true;
+    int size = q->posSize ? q->posSize : 64;
+    while (size <= id) size *= 2;
+
+    int *pos = realloc(q->pos, size * sizeof(int));
+    if (pos == NULL) return false;
+    for (int i = q->posSize; i < size; i++) pos[i] = -1;
+    q->pos = pos;
+    q->posSize = size;
+    return true;
+}
+
+// Puts a task at a position of the heap, keeping 'pos' up to date
+static void place(pQueue q, int i, Task t) {
+    int id = getId(t);
+    q->arr[i] = t;
+    if (id > 0 && reserveIds(q, id)) q->pos[id] = i;
+    else q->failed = true;
+}
+
+// Drops a task leaving the queue from 'pos'
+static void forget(pQueue q, Task t) {
+    int id = getId(t);
+    if (id > 0 && id < q->posSize) q->pos[id] = -1;
+}
+
+// Position of the task with the id, -1 if it is not in the queue
+static int findId(pQueue q, int id) {
+    if (id > 0 && id < q->posSize) {
+        int i = q->pos[id];
+        if (i >= 0 && i < q->numel && getId(q->arr[i]) == id) return i;
+    }
+    if (!q->failed) return -1;
+    for (int i = 0; i < q->numel; i++) {
+        if (getId(q->arr[i]) == id) return i;
+    }
+    return -1;
+}
+
+// Removes the task at 'index' from the heap (it is not freed)
+static void removeAt(pQueue q, int index) {
+    forget(q, q->arr[index]);
+    q->numel--;
+    if (index < q->numel) {
+        // the moved task can be greater than the parent of its new position, too
+        place(q, index, q->arr[q->numel]);
+        repairHeap(q, &index, 1);
+    }
+}
+
 /* newPQ
  * Syntax Specification:
  * pQueue newPQ();
@@ -31,6 +89,9 @@ pQueue newPQ() {
     if (q == NULL) return NULL;
     q->numel = 0;
     q->tot = 8;
+    q->pos = NULL;
+    q->posSize = 0;
+    q->failed = false;
     q->arr = malloc(sizeof(Task) * 8);
     for (int i = 0; i < 8; i++)
         q->arr[i] = NULL;
@@ -76,7 +137,7 @@ int emptyPQ(pQueue q) {
  */
 int getSize(pQueue q) {
     if (q == NULL) {
-        printf("\nError: queue is null or empty\n");
+        fprintf(stderr, "\nError: queue is null or empty\n");
         return -1;
     }
     return q->numel;
@@ -102,7 +163,7 @@ int getSize(pQueue q) {
 
 Task getByIndex(pQueue q, int index) {
     if (q == NULL || index < 0 || index >= q->numel) {
-        printf("\nError: queue is null or index out of bounds\n");
+        fprintf(stderr, "\nError: queue is null or index out of bounds\n");
         return NULL;
     }
     return q->arr[index];
@@ -132,9 +193,7 @@ Task getMax(pQueue q) {
 int deleteMax(pQueue q) {
     if (!q || q->numel == 0) return 0;
 
-    q->arr[0] = q->arr[q->numel - 1];
-    q->numel--;
-    scendi(q, 0);
+    removeAt(q, 0);
     return 1;
 }
 
@@ -178,8 +237,8 @@ static void scendi(pQueue q, int pos) {
         }
 
         Task temp = q->arr[pos];
-        q->arr[pos] = q->arr[max];
-        q->arr[max] = temp;
+        place(q, pos, q->arr[max]);
+        place(q, max, temp);
 
         pos = max;
     }
@@ -205,19 +264,95 @@ static void scendi(pQueue q, int pos) {
  */
 int enqueue(pQueue q, Task key) {
     if (q->numel == q->tot) {
-        q->tot += 8;
-        Task *temp = realloc(q->arr, q->tot * sizeof(Task));
+        Task *temp = realloc(q->arr, (q->tot + 8) * sizeof(Task));
         if (!temp) {
             fprintf(stderr, "Realloc error\n");
             return 0;
         }
         q->arr = temp;
+        q->tot += 8;
     }
-    q->arr[q->numel++] = key;
+    place(q, q->numel++, key);
     sali(q);
     return 1;
 }
 
+/* reservePQ
+ * Syntax Specification:
+ * int reservePQ(pQueue q, int size);
+ *
+ * Semantic Specification:
+ * Makes room for at least 'size' elements, so that the following insertions do not reallocate.
+ *
+ * Preconditions:
+ * - 'q' must be a valid priority queue.
+ *
+ * Postconditions:
+ * - Returns 1 if the queue can hold 'size' elements, 0 otherwise.
+ *
+ * Side Effects:
+ * - May allocate new memory.
+ */
+int reservePQ(pQueue q, int size) {
+    if (q == NULL) return 0;
+    if (size <= q->tot) return 1;
+
+    Task *temp = realloc(q->arr, size * sizeof(Task));
+    if (!temp) {
+        fprintf(stderr, "Realloc error\n");
+        return 0;
+    }
+    q->arr = temp;
+    q->tot = size;
+    return 1;
+}
+
+/* enqueueMany
+ * Syntax Specification:
+ * int enqueueMany(pQueue q, Task *items, int n);
+ *
+ * Semantic Specification:
+ * Adds a batch of Tasks to the priority queue, then restores the heap order
+ * once for the whole batch instead of once per task (see repairHeap).
+ *
+ * Preconditions:
+ * - 'q' must be a valid priority queue.
+ * - 'items' must contain 'n' valid Tasks.
+ *
+ * Postconditions:
+ * - All the Tasks are in the queue and the heap is valid.
+ * - Returns 1 on success, 0 if memory is not available (the queue is unchanged).
+ *
+ * Side Effects:
+ * - Modifies the queue, may allocate new memory.
+ */
+int enqueueMany(pQueue q, Task *items, int n) {
+    if (q == NULL || items == NULL || n <= 0) return n == 0;
+
+    if (q->numel + n > q->tot) {
+        int tot = q->tot;
+        while (tot < q->numel + n) tot *= 2;
+        Task *temp = realloc(q->arr, tot * sizeof(Task));
+        if (!temp) {
+            fprintf(stderr, "Realloc error\n");
+            return 0;
+        }
+        q->arr = temp;
+        q->tot = tot;
+    }
+
+    int *changed = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) place(q, q->numel + i, items[i]);
+    for (int i = 0; i < n && changed != NULL; i++) changed[i] = q->numel + i;
+    q->numel += n;
+
+    // one repair for the whole batch: without memory for the positions, a full rebuild
+    if (changed != NULL) repairHeap(q, changed, n);
+    else for (int i = q->numel / 2 - 1; i >= 0; i--) scendi(q, i);
+    free(changed);
+    return 1;
+}
+
 /* sali
  * Syntax Specification:
  * static void sali(pQueue q);
@@ -240,13 +375,82 @@ static void sali(pQueue q) {
 
     while (pos > 0 && getPriority(q->arr[pos]) > getPriority(q->arr[parent])) {
         Task temp = q->arr[pos];
-        q->arr[pos] = q->arr[parent];
-        q->arr[parent] = temp;
+        place(q, pos, q->arr[parent]);
+        place(q, parent, temp);
 
         pos = parent;
         parent = (pos - 1) / 2;
     }
 }
+
+/* compareDescending
+ * Syntax Specification:
+ * static int compareDescending(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Orders positions of the heap from the last to the first.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to ints.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareDescending(const void *a, const void *b) {
+    return *(const int *)b - *(const int *)a;
+}
+
+/* repairHeap
+ * Syntax Specification:
+ * static void repairHeap(pQueue q, const int *changed, int n);
+ *
+ * Semantic Specification:
+ * Restores the heap after the elements at the 'changed' positions were replaced
+ * or appended. When the positions are few, only they and their ancestors are
+ * sifted down, from the last to the first: every other subtree holds no changed
+ * position and is still a heap. Otherwise the whole array is rebuilt bottom-up,
+ * which costs O(numel) however many positions changed.
+ *
+ * Preconditions:
+ * - 'q' must be a heap except at the 'changed' positions (all < numel).
+ *
+ * Postconditions:
+ * - 'q' is a valid heap.
+ *
+ * Side Effects:
+ * - Modifies the internal array, allocates temporary memory.
+ */
+static void repairHeap(pQueue q, const int *changed, int n) {
+    if (n <= 0 || q->numel <= 1) return;
+
+    int depth = 1;
+    while ((1 << depth) <= q->numel) depth++;
+
+    // a sift down of every changed path costs about n * depth^2 comparisons, the rebuild 2 * numel
+    int *nodes = NULL;
+    if ((long long)n * depth * depth < 2LL * q->numel) nodes = malloc((size_t)n * depth * sizeof(int));
+    if (nodes == NULL) {
+        for (int i = q->numel / 2 - 1; i >= 0; i--) scendi(q, i);
+        return;
+    }
+
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        for (int pos = changed[i]; ; pos = (pos - 1) / 2) {
+            nodes[count++] = pos;
+            if (pos == 0) break;
+        }
+    }
+    qsort(nodes, count, sizeof(int), compareDescending);
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && nodes[i] == nodes[i - 1]) continue;
+        if (nodes[i] < q->numel) scendi(q, nodes[i]);
+    }
+    free(nodes);
+}
 /* freePQ
  * Syntax Specification:
  * void freePQ(pQueue q);
@@ -271,6 +475,7 @@ void freePQ(pQueue q) {
     }
 
     free(q->arr);
+    free(q->pos);
     free(q);
 }
 
@@ -306,10 +511,12 @@ void printQueue(pQueue q) {
 
 /* scanFileQueue
  * Syntax Specification:
- * pQueue scanFileQueue(pQueue q, FILE *f);
+ * pQueue scanFileQueue(pQueue q, FILE *f, bool *damaged);
  *
  * Semantic Specification:
  * Reads tasks from the specified file and inserts them into the given priority queue.
+ * The queue is sized once from the record count of the header, and the block
+ * checksums are verified while reading: the records of the damaged blocks are dropped.
  *
  * Preconditions:
  * - f must point to a readable file.
@@ -317,6 +524,7 @@ void printQueue(pQueue q) {
  *
  * Postconditions:
  * - The queue q is populated with tasks read from the file.
+ * - '*damaged' (if 'damaged' is not NULL) tells whether the file failed the integrity check.
  * - The file is closed after reading.
  *
  * Side Effects:
@@ -324,20 +532,29 @@ void printQueue(pQueue q) {
  * - Enqueues tasks.
  * - Closes the file.
  */
-pQueue scanFileQueue(pQueue q, FILE *f) {
+pQueue scanFileQueue(pQueue q, FILE *f, bool *damaged) {
+    if (damaged != NULL) *damaged = false;
     if (f == NULL) {
-        printf("\nFile read failed.\n");
+        fprintf(stderr, "\nFile read failed.\n");
         return NULL;
     }
 
+    DataReader r = openDataFile(f);
+    if (r == NULL) {
+        fclose(f);
+        return NULL;
+    }
+    reservePQ(q, q->numel + getRecordCount(r));
+
     Task item;
     while (1) {
-        item = fReadTask(f);
+        item = readRecord(r);
         if (item == NULL) break;
         enqueue(q, item);
     }
 
-    fclose(f);
+    bool valid = closeDataFile(r);
+    if (damaged != NULL) *damaged = !valid;
     return q;
 }
 
@@ -367,19 +584,42 @@ Task getByPQTitle(pQueue q, char *title) {
     return NULL;
 }
 
+/* getByPQId
+ * Syntax Specification:
+ * Task getByPQId(pQueue q, int id);
+ *
+ * Semantic Specification:
+ * Finds the task with the given id in the priority queue, in O(1) through the
+ * positions by id.
+ *
+ * Preconditions:
+ * - q must be a valid priority queue.
+ *
+ * Postconditions:
+ * - Returns the task with the given id, or NULL if not found.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task getByPQId(pQueue q, int id) {
+    int i = findId(q, id);
+    return (i >= 0) ? q->arr[i] : NULL;
+}
+
 /* saveOnFileQueue
  * Syntax Specification:
  * int saveOnFileQueue(pQueue q, char *filename);
  *
  * Semantic Specification:
- * Writes the contents of the priority queue to a file. Returns 1 if successful, 0 otherwise.
+ * Writes the contents of the priority queue to a file, with header and checksums.
+ * Returns 1 if successful, 0 otherwise.
  *
  * Preconditions:
  * - q and filename must not be NULL.
  *
  * Postconditions:
  * - A file is created or overwritten with the queue data.
- * - Returns 1 if the file was successfully written and verified; otherwise 0.
+ * - Returns 1 if every record and the header were written; otherwise 0.
  *
  * Side Effects:
  * - Writes to a file.
@@ -387,32 +627,17 @@ Task getByPQTitle(pQueue q, char *title) {
  */
 int saveOnFileQueue(pQueue q, const char *filename) {
     if (q == NULL || filename == NULL) {
-        printf("\nError: queue or filename is NULL\n");
+        fprintf(stderr, "\nError: queue or filename is NULL\n");
         return 0;
     }
 
-    FILE *temp = fopen(filename, "w");
-    if (temp == NULL) {
-        printf("\nFile open error\n");
-        return 0;
-    }
+    DataWriter w = beginDataFile(filename, q->numel, getLastTaskId());
+    if (w == NULL) return 0;
 
     for (int i = 0; i < q->numel; i++) {
-        fPrintTask(q->arr[i], temp);
+        writeRecord(w, q->arr[i]);
     }
-    fclose(temp);
-
-    FILE *check = fopen(filename, "r");
-    if (check == NULL) {
-        printf("\nTemporary file error.\n");
-        return 0;
-    }
-
-    fseek(check, 0, SEEK_END);
-    long size = ftell(check);
-    fclose(check);
-
-    return (size > 0) ? 1 : (printf("\nFile was not updated\n"), 0);
+    return endDataFile(w);
 }
 
 /* getIndexByTask
@@ -421,6 +646,7 @@ int saveOnFileQueue(pQueue q, const char *filename) {
  *
  * Semantic Specification:
  * Returns the index of the given task in the priority queue, or -1 if the task is not found.
+ * The task is found by its id, in O(1).
  *
  * Preconditions:
  * - q and t must not be NULL.
@@ -433,16 +659,12 @@ int saveOnFileQueue(pQueue q, const char *filename) {
  */
 int getIndexByTask(pQueue q, Task t) {
     if (q == NULL || t == NULL) {
-        printf("\nError: queue or task is NULL\n");
+        fprintf(stderr, "\nError: queue or task is NULL\n");
         return -1;
     }
 
-    for (int i = 0; i < q->numel; i++) {
-        if (q->arr[i] == t) {
-            return i;
-        }
-    }
-    return -1;
+    int i = findId(q, getId(t));
+    return (i >= 0 && q->arr[i] == t) ? i : -1;
 }
 
 /* deleteByIndex
@@ -467,14 +689,13 @@ int getIndexByTask(pQueue q, Task t) {
  */
 int deleteByIndex(pQueue q, int index) {
     if (q == NULL || index < 0 || index >= q->numel) {
-        printf("\nError: queue is NULL or index out of bounds\n");
+        fprintf(stderr, "\nError: queue is NULL or index out of bounds\n");
         return 0;
     }
 
-    free(q->arr[index]);
-    q->arr[index] = q->arr[q->numel - 1];
-    q->numel--;
-    scendi(q, index);
+    Task t = q->arr[index];
+    removeAt(q, index);
+    free(t);
     return 1;
 }
 
@@ -498,21 +719,115 @@ int deleteByIndex(pQueue q, int index) {
  */
 Task pop(pQueue q, Task target) {
     if (q == NULL || target == NULL) {
-        printf("Error: queue or task is NULL\n");
+        fprintf(stderr, "Error: queue or task is NULL\n");
         return NULL;
     }
 
     int index = getIndexByTask(q, target);
     if (index == -1) {
-        printf("Error: task not found in queue\n");
+        fprintf(stderr, "Error: task not found in queue\n");
         return NULL;
     }
 
     Task taskToReturn = q->arr[index];
-    q->arr[index] = q->arr[q->numel - 1];
-    q->numel--;
-    scendi(q, index);
-
+    removeAt(q, index);
     return taskToReturn;
 }
 
+/* updatePQ
+ * Syntax Specification:
+ * int updatePQ(pQueue q, Task t);
+ *
+ * Semantic Specification:
+ * Restores the heap after the priority of a task in the queue changed: only the
+ * task and its ancestors are sifted (see repairHeap), O(log n) after the O(1) lookup.
+ *
+ * Preconditions:
+ * - q and t must not be NULL.
+ *
+ * Postconditions:
+ * - Returns 1 if the task is in the queue, 0 otherwise.
+ *
+ * Side Effects:
+ * - Modifies the queue.
+ */
+int updatePQ(pQueue q, Task t) {
+    int index = getIndexByTask(q, t);
+    if (index == -1) return 0;
+    repairHeap(q, &index, 1);
+    return 1;
+}
+
+/* compareAscending
+ * Syntax Specification:
+ * static int compareAscending(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Orders positions of the heap from the first to the last.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to ints.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareAscending(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+/* popMany
+ * Syntax Specification:
+ * int popMany(pQueue q, Task *targets, int n);
+ *
+ * Semantic Specification:
+ * Removes a batch of tasks from the queue (they are not freed). The tasks are
+ * found by id in O(1) each, the holes are filled with the last tasks of the
+ * array and the heap is repaired once for the whole batch.
+ *
+ * Preconditions:
+ * - 'q' must be a valid priority queue, 'targets' must contain 'n' Tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks removed (the targets not in the queue are
+ *   ignored), or -1 if memory is not available (the queue is unchanged).
+ *
+ * Side Effects:
+ * - Modifies the queue, allocates temporary memory.
+ */
+int popMany(pQueue q, Task *targets, int n) {
+    if (q == NULL || targets == NULL || n <= 0) return 0;
+
+    int *holes = malloc(n * sizeof(int));
+    if (holes == NULL) return -1;
+
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        int index = (targets[i] != NULL) ? getIndexByTask(q, targets[i]) : -1;
+        if (index < 0) continue;
+        // a task given twice is removed once
+        forget(q, targets[i]);
+        holes[k++] = index;
+    }
+    qsort(holes, k, sizeof(int), compareAscending);
+
+    // holes are in increasing order: each one takes the last task that is not removed
+    int lo = 0, hi = k - 1, last = q->numel - 1, changed = 0;
+    while (lo <= hi) {
+        if (holes[hi] == last) {
+            hi--;
+            last--;
+            continue;
+        }
+        place(q, holes[lo], q->arr[last--]);
+        // the positions filled so far are reused as the list of changed positions
+        holes[changed++] = holes[lo++];
+    }
+    q->numel = last + 1;
+    repairHeap(q, holes, changed);
+
+    free(holes);
+    return k;
+}
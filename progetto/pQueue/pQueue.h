@@ -12,16 +12,22 @@ int deleteMax(pQueue);
 
 static void scendi(pQueue, int);
 static void sali(pQueue);
+static void repairHeap(pQueue, const int *, int);
 
 int enqueue(pQueue, Task);
+int enqueueMany(pQueue, Task *, int);
+int reservePQ(pQueue, int);
 
 void printQueue(pQueue);
-pQueue scanFileQueue(pQueue, FILE *);
+pQueue scanFileQueue(pQueue, FILE *, bool *);
 int saveOnFileQueue(pQueue, const char *);
 
 int getSize(pQueue);
 Task getByIndex(pQueue, int);
 Task getByPQTitle(pQueue, char *);
+Task getByPQId(pQueue, int);
 int getIndexByTask(pQueue, Task);
 Task pop(pQueue, Task);
+int updatePQ(pQueue, Task);
+int popMany(pQueue, Task *, int);
 int deleteByIndex(pQueue q, int index);
\ No newline at end of file
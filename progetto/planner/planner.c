@@ -2,15 +2,78 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
 #include "../char/char.h"
 #include "../list/list.h"
 #include "../pQueue/pQueue.h"
+#include "../loader/loader.h"
+#include "../datafile/datafile.h"
+#include "../report/report.h"
+#include "../import/import.h"
+#include "../export/export.h"
+#include "../journal/journal.h"
+#include "../stats/stats.h"
+#include "../analytics/analytics.h"
+#include "../scheduler/scheduler.h"
+#include "../progress/progress.h"
+#include "../due/due.h"
+#include "../fulltext/fulltext.h"
+#include "../titles/titles.h"
+#include "../graph/graph.h"
+#include "../undo/undo.h"
 #include "planner.h"
 
+// Indexes of the collections, shared by 'paths', the generation counters and the journal
+enum { PROGRESS, COMPLETED, EXPIRED, REPORT, REPORT_INDEX, JOURNAL, CHECKPOINT, TEXT_INDEX, RECURRING, DEPENDS, ARCHIVE_COMPLETED, ARCHIVE_EXPIRED,
+       TIME_LOG, TIME_TOTALS, WEEK_STATS };
+
+// Days of the study plan and late tasks shown by showStudyPlan
+#define PLAN_DAYS_SHOWN 7
+#define PLAN_LATE_SHOWN 10
+
+// Edits allowed to the titles suggested by plannerSuggestTitles
+#define TITLE_DISTANCE 2
+
+// Days ahead in which the occurrences of the recurring tasks become tasks in progress
+#define RECURRING_DAYS 7
+
+// Weeks whose counters are kept: the one of the Monday report and the current one
+#define WEEK_CACHE 2
+
+// Read of a history file on a thread of its own, started by openPlanner
+struct historyLoad {
+    pthread_t thread;
+    bool running;                    // started and not joined yet
+    const char *filename;
+    Task *items;                     // tasks in file order, ids not registered yet
+    int numel;                       // -1 if the file cannot be read
+    int lastId;
+    bool damaged;
+};
+
 struct planner {
     pQueue inProgress;
     list completed;
     list expired;
+    unsigned int generation[3];      // bumped on every change of a collection
+    unsigned int savedGeneration[3]; // generation last written on file
+    bool loaded[3];                  // history lists are read from file on first access
+    bool damaged[3];                 // file failed the integrity check and could not be set aside
+    struct historyLoad history[3];   // background reads of the completed and expired files
+    ReportIndex reports;             // report date -> position in the report file
+    Journal journal;                 // changes not saved yet, for crash recovery
+    WeekStats week[WEEK_CACHE];      // counters of the last weeks used, most recent first
+    Analytics courses;               // rollups per course, built on first use
+    Schedule plan;                   // study plan of the tasks in progress, built on first use
+    DueView due;                     // tasks in progress by deadline day, built on first use
+    QueryIndex index;                // fields of every task for plannerQuery, built on first use
+    TextIndex text;                  // words of every task, read from file on first use
+    TitleIndex titles;               // titles of every task for the suggestions, built on first use
+    Recurring recurring;             // definitions of the recurring tasks, read at the opening
+    TaskGraph deps;                  // prerequisites and ready tasks, read from file on first use
+    UndoLog undo;                    // changes of the session that can be undone
+    TimeLog time;                    // minutes spent on the tasks, totals read from file on first use
 };
 const char **paths;
 
@@ -22,7 +85,18 @@ const char **getFilePath(){
             "./Data/progress.txt",
             "./Data/completed.txt",
             "./Data/expired.txt",
-            "./Data/report.txt"
+            "./Data/report.txt",
+            "./Data/report.idx",
+            "./Data/journal.log",
+            "./Data/checkpoint",
+            "./Data/text.idx",
+            "./Data/recurring.txt",
+            "./Data/depends.txt",
+            "./Data/completed.bak",
+            "./Data/expired.bak",
+            "./Data/timelog.txt",
+            "./Data/timelog.idx",
+            "./Data/week.txt"
         };
         return data_files;
     }
@@ -32,7 +106,18 @@ const char **getFilePath(){
             "./test/output/progress.txt",
             "./test/output/completed.txt",
             "./test/output/expired.txt",
-            "./test/output/report.txt"
+            "./test/output/report.txt",
+            "./test/output/report.idx",
+            "./test/output/journal.log",
+            "./test/output/checkpoint",
+            "./test/output/text.idx",
+            "./test/output/recurring.txt",
+            "./test/output/depends.txt",
+            "./test/output/completed.bak",
+            "./test/output/expired.bak",
+            "./test/output/timelog.txt",
+            "./test/output/timelog.idx",
+            "./test/output/week.txt"
         };
         return data_files;
     }
@@ -40,544 +125,3390 @@ const char **getFilePath(){
     return NULL;
 }
 
-/* checkExpired
+/* touch
+ * Syntax Specification:
+ * static void touch(Planner p, int collection);
+ *
+ * Semantic Specification:
+ * Marks a collection of the planner (PROGRESS, COMPLETED or EXPIRED) as modified.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - The generation of the collection is incremented, so it will be saved on close.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void touch(Planner p, int collection) {
+    p->generation[collection]++;
+}
+
+/* isDirty
+ * Syntax Specification:
+ * static bool isDirty(Planner p, int collection);
+ *
+ * Semantic Specification:
+ * Checks whether a collection changed since it was last loaded or saved.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns true if the collection has to be written on file.
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool isDirty(Planner p, int collection) {
+    return p->generation[collection] != p->savedGeneration[collection];
+}
+
+/* takeCheckpoint
+ * Syntax Specification:
+ * static void takeCheckpoint(Planner p);
+ *
+ * Semantic Specification:
+ * Copies the collections changed since the last save and hands them to the
+ * journal, which writes the checkpoint in the background.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - A checkpoint of the current state is being written.
+ *
+ * Side Effects:
+ * - Allocates memory, starts a thread.
+ */
+static void takeCheckpoint(Planner p) {
+    Task *items[JOURNAL_COLLECTIONS];
+    int numel[JOURNAL_COLLECTIONS], mask = 0;
+
+    for (int c = PROGRESS; c <= EXPIRED; c++) {
+        items[c] = NULL;
+        numel[c] = 0;
+        if (!isDirty(p, c)) continue;
+
+        int size = 0;
+        list l = (c == COMPLETED) ? p->completed : p->expired;
+        if (c == PROGRESS) size = getSize(p->inProgress);
+        else for (list temp = l; temp != NULL; temp = getNext(temp)) size++;
+
+        items[c] = malloc((size > 0 ? size : 1) * sizeof(Task));
+        if (items[c] == NULL) {
+            for (int k = PROGRESS; k < c; k++) {
+                for (int i = 0; i < numel[k]; i++) freeTask(items[k][i]);
+                free(items[k]);
+            }
+            return;
+        }
+        // same order as saveOnFileQueue and saveOnFileList
+        if (c == PROGRESS) {
+            for (int i = 0; i < size; i++) items[c][numel[c]++] = copyTask(getByIndex(p->inProgress, i));
+        } else {
+            for (; l != NULL; l = getNext(l)) items[c][numel[c]++] = copyTask(getValue(l));
+        }
+        mask |= 1 << c;
+    }
+    startCheckpoint(p->journal, items, numel, mask);
+}
+
+/* commit
+ * Syntax Specification:
+ * static void commit(Planner p);
+ *
+ * Semantic Specification:
+ * Ends a change of the planner: the journal lines logged for it are made durable
+ * and a checkpoint is started when due.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - The change survives a crash of the process.
+ *
+ * Side Effects:
+ * - Writes into the journal, may start a checkpoint.
+ */
+static void commit(Planner p) {
+    if (commitJournal(p->journal)) takeCheckpoint(p);
+}
+
+/* setAsideDamaged
+ * Syntax Specification:
+ * static void setAsideDamaged(Planner p, int collection);
+ *
+ * Semantic Specification:
+ * Called when a data file fails the integrity check: the records of its damaged
+ * blocks were dropped, so the file is renamed "<name>.bad" before a save can
+ * overwrite the only copy of them.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'collection' an index of 'paths'.
+ *
+ * Postconditions:
+ * - The file is kept as "<name>.bad". If it cannot be renamed and 'collection'
+ *   is PROGRESS, COMPLETED or EXPIRED, the collection is never saved.
+ *
+ * Side Effects:
+ * - Renames or removes files, prints a warning.
+ */
+static void setAsideDamaged(Planner p, int collection) {
+    char bad[FILENAME_MAX];
+    snprintf(bad, sizeof(bad), "%s.bad", paths[collection]);
+    // an older damaged copy is replaced (rename does not overwrite on every system)
+    remove(bad);
+    if (rename(paths[collection], bad) == 0) {
+        fprintf(stderr, "\nWarning: '%s' failed the integrity check and was kept as '%s'.\n", paths[collection], bad);
+        return;
+    }
+    if (collection <= EXPIRED) p->damaged[collection] = true;
+    fprintf(stderr, "\nWarning: '%s' failed the integrity check and will not be overwritten.\n", paths[collection]);
+}
+
+static void *runHistoryLoad(void *arg) {
+    struct historyLoad *h = arg;
+    h->numel = loadTasks(h->filename, &h->items, &h->lastId, &h->damaged);
+    return NULL;
+}
+
+// Starts reading a history list on a thread of its own; if no thread can be created
+// the list is read by loadHistory when needed
+static void startHistoryLoad(Planner p, int collection) {
+    struct historyLoad *h = &(p->history[collection]);
+    h->filename = paths[collection];
+    h->items = NULL;
+    h->running = pthread_create(&h->thread, NULL, runHistoryLoad, h) == 0;
+}
+
+/* joinHistoryLoad
+ * Syntax Specification:
+ * static bool joinHistoryLoad(Planner p, int collection, bool keep);
+ *
+ * Semantic Specification:
+ * Waits for the background read of the completed or expired list. If 'keep'
+ * is true its tasks get their ids and are put in the list, in the order of
+ * scanFileList, and a damaged file is set aside; otherwise they are freed.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'collection' COMPLETED or EXPIRED.
+ *
+ * Postconditions:
+ * - Returns false if no read was running or the file could not be read.
+ *
+ * Side Effects:
+ * - Waits for a thread, modifies the list, frees memory.
+ */
+static bool joinHistoryLoad(Planner p, int collection, bool keep) {
+    struct historyLoad *h = &(p->history[collection]);
+    if (!h->running) return false;
+    pthread_join(h->thread, NULL);
+    h->running = false;
+    if (h->numel < 0) return false;
+
+    // ids are registered here, on the main thread: the counter is not thread safe
+    list *l = (collection == COMPLETED) ? &(p->completed) : &(p->expired);
+    if (keep) reserveTaskIds(h->lastId);
+    for (int i = 0; i < h->numel; i++) {
+        if (keep) *l = consList(assignTaskId(h->items[i]), *l);
+        else freeTask(h->items[i]);
+    }
+    free(h->items);
+    if (keep && h->damaged) setAsideDamaged(p, collection);
+    return true;
+}
+
+/* loadHistory
+ * Syntax Specification:
+ * static void loadHistory(Planner p, int collection);
+ *
+ * Semantic Specification:
+ * Hands over the completed or expired list the first time it is needed: the
+ * file is usually read already, in the background since the opening, otherwise
+ * it is read now. A damaged file is set aside (see setAsideDamaged).
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ * - 'collection' must be COMPLETED or EXPIRED.
+ *
+ * Postconditions:
+ * - The list is in memory; later calls do nothing.
+ *
+ * Side Effects:
+ * - May wait for the background read, or read from file.
+ * - Allocates memory.
+ */
+static void loadHistory(Planner p, int collection) {
+    if (p->loaded[collection]) return;
+
+    if (!joinHistoryLoad(p, collection, true)) {
+        bool damaged;
+        if (collection == COMPLETED) {
+            p->completed = scanFileList(p->completed, fopen(paths[COMPLETED], "r"), &damaged);
+        } else {
+            p->expired = scanFileList(p->expired, fopen(paths[EXPIRED], "r"), &damaged);
+        }
+        if (damaged) setAsideDamaged(p, collection);
+    }
+    p->loaded[collection] = true;
+}
+
+/* weekStats
+ * Syntax Specification:
+ * static WeekStats weekStats(Planner p, const char *monday);
+ *
+ * Semantic Specification:
+ * Returns the counters of the week starting on 'monday'. Those of the current week
+ * are read from the week file at open when it matches the history files, the others
+ * are built with a single visit of the collections the first time; then they are
+ * kept up to date by every change of state, so later reports and exports only read
+ * them. The counters of
+ * the last WEEK_CACHE weeks are kept: the Monday report (the week before) and the
+ * export (the current week) do not build each other's counters again.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'monday' a "ddmmyyyy" date.
+ *
+ * Postconditions:
+ * - Returns the counters, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Loads the history if needed, allocates memory, may free the counters of the
+ *   least recently used week.
+ */
+static WeekStats weekStats(Planner p, const char *monday) {
+    for (int i = 0; i < WEEK_CACHE; i++) {
+        if (p->week[i] == NULL || strcmp(getStatsMonday(p->week[i]), monday) != 0) continue;
+        WeekStats w = p->week[i];
+        memmove(&p->week[1], &p->week[0], i * sizeof(WeekStats));
+        p->week[0] = w;
+        return w;
+    }
+
+    freeWeekStats(p->week[WEEK_CACHE - 1]);
+    memmove(&p->week[1], &p->week[0], (WEEK_CACHE - 1) * sizeof(WeekStats));
+    p->week[0] = NULL;
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    WeekStats w = newWeekStats(monday);
+    if (w == NULL) return NULL;
+
+    for (int i = 0; i < getSize(p->inProgress); i++) trackTask(w, getByIndex(p->inProgress, i), STATS_PROGRESS);
+
+    // the lists start with the most recent task: they are tracked from the oldest one
+    for (int c = STATS_COMPLETED; c <= STATS_EXPIRED; c++) {
+        list l = (c == STATS_COMPLETED) ? p->completed : p->expired;
+        int size = 0;
+        for (list temp = l; temp != NULL; temp = getNext(temp)) size++;
+        Task *tasks = malloc((size > 0 ? size : 1) * sizeof(Task));
+        if (tasks == NULL) {
+            freeWeekStats(w);
+            return NULL;
+        }
+        for (int i = 0; l != NULL; l = getNext(l), i++) tasks[size - 1 - i] = getValue(l);
+        for (int i = 0; i < size; i++) trackTask(w, tasks[i], c);
+        free(tasks);
+    }
+    p->week[0] = w;
+    return w;
+}
+
+// Stamp of the history files for the week file: their header lines, "-" for a
+// missing file. False for a file without header, whose changes would go unnoticed
+static bool historyStamp(char *stamp, int size) {
+    int len = 0;
+    for (int c = COMPLETED; c <= EXPIRED; c++) {
+        char line[DATA_MAX_LINE] = "-\n";
+        FILE *f = fopen(paths[c], "r");
+        if (f != NULL) {
+            int count, lastId;
+            unsigned int crc;
+            bool header = fgets(line, sizeof(line), f) != NULL && isHeaderLine(line, &count, &crc, &lastId);
+            fclose(f);
+            if (!header) return false;
+        }
+        len += snprintf(stamp + len, size - len, "%s", line);
+        if (len >= size) return false;
+    }
+    return true;
+}
+
+/* readWeekFile
+ * Syntax Specification:
+ * static void readWeekFile(Planner p);
+ *
+ * Semantic Specification:
+ * Called at the opening: if the history files did not change since the last
+ * session wrote the week file, the counters of its week are taken from it, so
+ * the Monday report and the export of that week do not visit the history.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with the in-progress queue loaded and no counters yet.
+ *
+ * Postconditions:
+ * - The counters of the week of the file are kept, if the file is valid.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static void readWeekFile(Planner p) {
+    char stamp[2 * DATA_MAX_LINE];
+    // a recovery that could not be saved leaves a history different from the files
+    if (isDirty(p, COMPLETED) || isDirty(p, EXPIRED) || !historyStamp(stamp, sizeof(stamp))) return;
+
+    int size = getSize(p->inProgress);
+    Task *progress = malloc((size > 0 ? size : 1) * sizeof(Task));
+    if (progress == NULL) return;
+    for (int i = 0; i < size; i++) progress[i] = getByIndex(p->inProgress, i);
+    p->week[0] = loadWeekFile(paths[WEEK_STATS], stamp, progress, size);
+    free(progress);
+}
+
+/* writeWeekFile
+ * Syntax Specification:
+ * static void writeWeekFile(Planner p);
+ *
+ * Semantic Specification:
+ * Called at the closing, after the collections are saved: the tasks completed
+ * or expired from the Monday of the current week on are written in the week
+ * file, with the stamp of the history files. Without the history in memory the
+ * file is left as it is: its stamp tells the next opening if it is still valid.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with no unsaved change.
+ *
+ * Postconditions:
+ * - The week file describes the current week, if the history was loaded.
+ *
+ * Side Effects:
+ * - Writes to file, allocates and frees memory.
+ */
+static void writeWeekFile(Planner p) {
+    char stamp[2 * DATA_MAX_LINE];
+    if (!p->loaded[COMPLETED] || !p->loaded[EXPIRED] || !historyStamp(stamp, sizeof(stamp))) return;
+
+    const char *monday = getPreviousMonday();
+    Task *all[3] = { NULL, NULL, NULL }, *tasks[3] = { NULL, NULL, NULL };
+    int numel[3] = { 0, 0, 0 };
+    bool ok = true;
+    for (int c = COMPLETED; c <= EXPIRED && ok; c++) {
+        // the arrays are indexed as the collections of the counters
+        int w = (c == COMPLETED) ? STATS_COMPLETED : STATS_EXPIRED;
+        list l = (c == COMPLETED) ? p->completed : p->expired;
+        int size = 0;
+        for (list temp = l; temp != NULL; temp = getNext(temp)) size++;
+        all[w] = malloc((size > 0 ? size : 1) * sizeof(Task));
+        ok = all[w] != NULL;
+        if (!ok) break;
+
+        // weekStats tracks the tasks in the order of the history file: the order of the
+        // list if it was written in this session, the reverse if it was only read
+        int first = size, last = 0;
+        bool written = p->savedGeneration[c] > 0;
+        for (; l != NULL; l = getNext(l)) {
+            Task t = getValue(l);
+            if (compareDates((c == COMPLETED) ? getCompletionDate(t) : getDeadline(t), monday) < 0) continue;
+            if (written) all[w][last++] = t;
+            else all[w][--first] = t;
+        }
+        tasks[w] = written ? all[w] : all[w] + first;
+        numel[w] = written ? last : size - first;
+    }
+    if (ok) saveWeekFile(paths[WEEK_STATS], monday, stamp, tasks, numel);
+    free(all[STATS_COMPLETED]);
+    free(all[STATS_EXPIRED]);
+}
+
+/* courseAnalytics
+ * Syntax Specification:
+ * static Analytics courseAnalytics(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the rollups per course of every collection. They are built with a single
+ * visit of the collections the first time, then kept up to date by every change.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the rollups, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Loads the history if needed, allocates memory.
+ */
+static Analytics courseAnalytics(Planner p) {
+    if (p->courses != NULL) return p->courses;
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    p->courses = newAnalytics();
+    if (p->courses == NULL) return NULL;
+
+    for (int i = 0; i < getSize(p->inProgress); i++) trackCourse(p->courses, getByIndex(p->inProgress, i), ANALYTICS_OPEN);
+    for (list l = p->completed; l != NULL; l = getNext(l)) trackCourse(p->courses, getValue(l), ANALYTICS_COMPLETED);
+    for (list l = p->expired; l != NULL; l = getNext(l)) trackCourse(p->courses, getValue(l), ANALYTICS_EXPIRED);
+    return p->courses;
+}
+
+/* queryIndex
+ * Syntax Specification:
+ * static QueryIndex queryIndex(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the index of the queries over every collection. It is built with a
+ * single visit of the collections the first time, then kept up to date by every change.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the index, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Loads the history if needed, allocates memory.
+ */
+static QueryIndex queryIndex(Planner p) {
+    if (p->index != NULL) return p->index;
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    p->index = newQueryIndex();
+    if (p->index == NULL) return NULL;
+
+    for (int i = 0; i < getSize(p->inProgress); i++) indexTask(p->index, getByIndex(p->inProgress, i), PROGRESS);
+    for (list l = p->completed; l != NULL; l = getNext(l)) indexTask(p->index, getValue(l), COMPLETED);
+    for (list l = p->expired; l != NULL; l = getNext(l)) indexTask(p->index, getValue(l), EXPIRED);
+    return p->index;
+}
+
+/* titleIndex
+ * Syntax Specification:
+ * static TitleIndex titleIndex(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the trie of the titles of every collection. It is built with a single
+ * visit of the collections the first time, then kept up to date by every change.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the index, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Loads the history if needed, allocates memory.
+ */
+static TitleIndex titleIndex(Planner p) {
+    if (p->titles != NULL) return p->titles;
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    p->titles = newTitleIndex();
+    if (p->titles == NULL) return NULL;
+
+    for (int i = 0; i < getSize(p->inProgress); i++) addTitle(p->titles, getByIndex(p->inProgress, i), PROGRESS);
+    for (list l = p->completed; l != NULL; l = getNext(l)) addTitle(p->titles, getValue(l), COMPLETED);
+    for (list l = p->expired; l != NULL; l = getNext(l)) addTitle(p->titles, getValue(l), EXPIRED);
+    return p->titles;
+}
+
+/* compareTaskIds
+ * Syntax Specification:
+ * static int compareTaskIds(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Order of the ids of two tasks.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to Tasks.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareTaskIds(const void *a, const void *b) {
+    int x = getId(*(const Task *)a), y = getId(*(const Task *)b);
+    return (x > y) - (x < y);
+}
+
+/* textIndex
+ * Syntax Specification:
+ * static TextIndex textIndex(Planner p, bool build);
+ *
+ * Semantic Specification:
+ * Returns the inverted index of the words of the tasks. The first time it is read
+ * from its file and only the tasks created after it was saved (whose ids are
+ * greater than the last one in the file) are added; if the file is missing or
+ * damaged the index is built, reading every task once, only when 'build' is true.
+ * It is then kept up to date by every change of a title, description or course.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the index, or NULL if there is no file and 'build' is false, or memory
+ *   is not available.
+ *
+ * Side Effects:
+ * - Reads from file, loads the history if needed, allocates memory.
+ */
+static TextIndex textIndex(Planner p, bool build) {
+    if (p->text != NULL) return p->text;
+
+    TextIndex x = loadTextIndex(paths[TEXT_INDEX]);
+    if (x == NULL && !build) return NULL;
+    if (x == NULL) x = newTextIndex();
+    if (x == NULL) return NULL;
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    int size = getSize(p->inProgress), numel = 0, last = getTextLastId(x);
+    for (list l = p->completed; l != NULL; l = getNext(l)) size++;
+    for (list l = p->expired; l != NULL; l = getNext(l)) size++;
+    Task *tasks = malloc((size > 0 ? size : 1) * sizeof(Task));
+    if (tasks == NULL) {
+        freeTextIndex(x);
+        return NULL;
+    }
+    for (int i = 0; i < getSize(p->inProgress); i++) {
+        if (getId(getByIndex(p->inProgress, i)) > last) tasks[numel++] = getByIndex(p->inProgress, i);
+    }
+    for (list l = p->completed; l != NULL; l = getNext(l)) if (getId(getValue(l)) > last) tasks[numel++] = getValue(l);
+    for (list l = p->expired; l != NULL; l = getNext(l)) if (getId(getValue(l)) > last) tasks[numel++] = getValue(l);
+    // in order of id, every id is appended to the lists of its words
+    qsort(tasks, numel, sizeof(Task), compareTaskIds);
+    for (int i = 0; i < numel; i++) addTextTask(x, tasks[i]);
+    free(tasks);
+    p->text = x;
+    return x;
+}
+
+/* taskGraph
+ * Syntax Specification:
+ * static TaskGraph taskGraph(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the prerequisites of the tasks and the ready view. The edges are read
+ * from their file the first time and every task in progress is activated, then
+ * the graph is kept up to date by every change of the in-progress queue.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the graph, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static TaskGraph taskGraph(Planner p) {
+    if (p->deps != NULL) return p->deps;
+
+    p->deps = loadTaskGraph(paths[DEPENDS]);
+    if (p->deps == NULL) return NULL;
+    for (int i = 0; i < getSize(p->inProgress); i++) activateTask(p->deps, getByIndex(p->inProgress, i));
+    return p->deps;
+}
+
+// Course of a task of any collection, for the sessions of the time log read again
+static const char *courseOfTask(void *ctx, int id) {
+    Planner p = ctx;
+    Task t = getByPQId(p->inProgress, id);
+    if (t == NULL) {
+        loadHistory(p, COMPLETED);
+        t = getByLId(p->completed, id);
+    }
+    if (t == NULL) {
+        loadHistory(p, EXPIRED);
+        t = getByLId(p->expired, id);
+    }
+    return (t != NULL) ? getCourse(t) : NULL;
+}
+
+/* timeLog
+ * Syntax Specification:
+ * static TimeLog timeLog(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the minutes spent on the tasks. Only the totals are read from file,
+ * the first time they are needed, with the sessions logged after they were
+ * saved: opening the planner never reads the log.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the time log, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static TimeLog timeLog(Planner p) {
+    if (p->time == NULL) p->time = loadTimeLog(paths[TIME_TOTALS], paths[TIME_LOG], courseOfTask, p);
+    return p->time;
+}
+
+/* track, untrack
+ * Syntax Specification:
+ * static void track(Planner p, Task t, int collection);
+ * static void untrack(Planner p, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Keep the weekly counters, the course rollups, the study plan, the view of
+ * the deadlines, the index of the queries and the ready tasks (when already
+ * built) up to date when a task enters or leaves a collection. untrack must be called before the
+ * fields of the task are changed.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'collection' STATS_PROGRESS, STATS_COMPLETED or
+ *   STATS_EXPIRED.
+ *
+ * Postconditions:
+ * - The counters include the task (or no longer do).
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static void track(Planner p, Task t, int collection) {
+    for (int i = 0; i < WEEK_CACHE; i++) trackTask(p->week[i], t, collection);
+    trackCourse(p->courses, t, collection);
+    indexTask(p->index, t, collection);
+    addTitle(p->titles, t, collection);
+    if (collection == STATS_PROGRESS) {
+        scheduleTask(p->plan, t);
+        trackDue(p->due, t);
+        activateTask(p->deps, t);
+    }
+}
+
+static void untrack(Planner p, Task t, int collection) {
+    for (int i = 0; i < WEEK_CACHE; i++) untrackTask(p->week[i], t, collection);
+    untrackCourse(p->courses, t, collection);
+    unindexTask(p->index, t);
+    removeTitle(p->titles, t);
+    if (collection == STATS_PROGRESS) {
+        unscheduleTask(p->plan, t);
+        untrackDue(p->due, t);
+        deactivateTask(p->deps, t);
+    }
+}
+
+// Copy of a task before a change that can be undone, NULL if changes are not recorded
+static Task snapshot(Planner p, Task t) {
+    return (p->undo != NULL) ? copyTask(t) : NULL;
+}
+
+// Records a step of the current action (see recordStep) and frees the copy taken before the change
+static bool record(Planner p, int op, Task before, Task t) {
+    bool kept = recordStep(p->undo, op, before, t);
+    if (before != NULL) freeTask(before);
+    return kept;
+}
+
+/* expireMany
+ * Syntax Specification:
+ * static void expireMany(Planner p, Task *tasks, int numel);
+ *
+ * Semantic Specification:
+ * Moves a batch of tasks in progress to the expired list: the queue is repaired
+ * once and the changes are logged as one batch.
+ *
+ * Preconditions:
+ * - 'tasks' must contain 'numel' tasks of the in-progress queue.
+ *
+ * Postconditions:
+ * - The tasks are expired.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections, prints the expired tasks.
+ */
+static void expireMany(Planner p, Task *tasks, int numel) {
+    loadHistory(p, EXPIRED);
+    for (int i = 0; i < numel; i++) untrack(p, tasks[i], STATS_PROGRESS);
+    popMany(p->inProgress, tasks, numel);
+
+    beginBatch(p->journal);
+    for (int i = 0; i < numel; i++) {
+        fprintf(stderr, "\nTask '%s' expired", getTitle(tasks[i]));
+        p->expired = consList(tasks[i], p->expired);
+        track(p, tasks[i], STATS_EXPIRED);
+        logTaskId(p->journal, "P-", getId(tasks[i]));
+        logTask(p->journal, "E+", tasks[i]);
+    }
+    endBatch(p->journal);
+    touch(p, PROGRESS);
+    touch(p, EXPIRED);
+    commit(p);
+}
+
+/* checkExpired
+ * Syntax Specification:
+ * bool checkExpired(Planner p);
+ *
+ * Semantic Specification:
+ * Checks if any tasks in the in-progress queue have expired and moves them to the expired list.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with a potentially non-empty in-progress queue.
+ * - The global variable 'today' must contain a valid date string.
+ *
+ * Postconditions:
+ * - Tasks that are past their deadline are moved from in-progress to expired.
+ * - Returns true if at least one task was expired.
+ *
+ * Side Effects:
+ * - Modifies the Planner's inProgress and expired lists.
+ * - Prints messages to the terminal.
+ */
+bool checkExpired(Planner p) {
+    if (emptyPQ(p->inProgress)) {
+        fprintf(stderr, "\nThe queue is empty or non-existent.\n");
+        return false;
+    }
+
+    int size = getSize(p->inProgress), numel = 0;
+    Task *expired = malloc(size * sizeof(Task));
+    if (expired == NULL) {
+        fprintf(stderr, "\nError: memory allocation for the deadline check failed.\n");
+        return false;
+    }
+    for (int i = 0; i < size; i++) {
+        Task t = getByIndex(p->inProgress, i);
+        if (compareDates(getDeadline(t), today) < 0) expired[numel++] = t;
+    }
+    if (numel > 0) expireMany(p, expired, numel);
+    free(expired);
+
+    if (emptyPQ(p->inProgress)) {
+        fprintf(stderr, "\nAll tasks have expired.\n");
+    } else {
+        fprintf(stderr, "\nDeadline check completed\n");
+    }
+    return numel > 0;
+}
+
+/* fprintCount
+ * Syntax Specification:
+ * static void fprintCount(FILE *f, int n, const char *state);
+ *
+ * Semantic Specification:
+ * Writes the closing line of a section of the weekly report.
+ *
+ * Preconditions:
+ * - 'f' must be writable.
+ *
+ * Postconditions:
+ * - "* There are <n|no> <state> task" is written.
+ *
+ * Side Effects:
+ * - Writes into the file.
+ */
+static void fprintCount(FILE *f, int n, const char *state) {
+    if (n > 0) fprintf(f, "* There are %d %s task", n, state);
+    else fprintf(f, "* There are no %s task", state);
+}
+
+// True if a history list is not empty. A list not loaded yet is the one on file,
+// so the record count of its header is enough (files without header are loaded)
+static bool hasHistory(Planner p, int collection) {
+    if (!p->loaded[collection]) {
+        FILE *f = fopen(paths[collection], "r");
+        if (f == NULL) return false;
+        char line[DATA_MAX_LINE];
+        int count, lastId;
+        unsigned int crc;
+        bool header = fgets(line, sizeof(line), f) != NULL && isHeaderLine(line, &count, &crc, &lastId);
+        fclose(f);
+        if (header) return count > 0;
+        loadHistory(p, collection);
+    }
+    return ((collection == COMPLETED) ? p->completed : p->expired) != NULL;
+}
+
+/* writeReport
+ * Syntax Specification:
+ * static void writeReport(Planner p, const char *date, Task **tasks, int *numel);
+ *
+ * Semantic Specification:
+ * Appends the weekly report generated on 'date' to the report file and records it
+ * in the report index. 'tasks[COMPLETED]' and 'tasks[EXPIRED]' are the tasks of
+ * the week, oldest first (they are listed newest first); 'tasks[PROGRESS]' are the
+ * tasks in progress on 'date'.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'date' a "ddmmyyyy" date not older than the last report.
+ *
+ * Postconditions:
+ * - The report is in the archive.
+ *
+ * Side Effects:
+ * - Writes to files, outputs messages in case of errors.
+ */
+static void writeReport(Planner p, const char *date, Task **tasks, int *numel) {
+    rotateReports(p->reports, date); // a new year starts a new report segment
+    FILE *reportFile = fopen(paths[REPORT], "a"); // Apertura in modalità append per non sovrascrivere il contenuto
+
+    if (reportFile == NULL) {
+        fprintf(stderr, "\nError: Unable to open report file.\n");
+        return;
+    }
+
+    fseek(reportFile, 0, SEEK_END);
+    long offset = ftell(reportFile);
+    fprintf(reportFile, "%s", date);
+    fprintf(reportFile, "\n$\n\n\t      --- Weekly Report ---\n\n");
+
+    if (hasHistory(p, COMPLETED)) {
+        fprintf(reportFile, "\n+ Completed tasks:\n");
+        for (int i = numel[COMPLETED] - 1; i >= 0; i--) {
+            Task t = tasks[COMPLETED][i];
+            fprintf(reportFile, "- %s (%s) Completed on: ", getTitle(t), getCourse(t));
+            fprintDate(reportFile, getCompletionDate(t));
+            fprintf(reportFile, "\n");
+        }
+        fprintCount(reportFile, numel[COMPLETED], "completed");
+    }
+
+    if (p->inProgress != NULL) {
+        fprintf(reportFile, "\n\n+ Tasks in progress:\n");
+        for (int i = 0; i < numel[PROGRESS]; i++) {
+            Task t = tasks[PROGRESS][i];
+            if (strcmp(getDeadline(t), date) == 0) {
+            fprintf(reportFile, "- %s (%s) ! Due today !\n", getTitle(t), getCourse(t));
+            } else {
+                fprintf(reportFile, "- %s (%s) Deadline: ", getTitle(t), getCourse(t));
+                fprintDate(reportFile, getDeadline(t));
+                fprintf(reportFile, "\n");
+            }
+        }
+        fprintCount(reportFile, numel[PROGRESS], "in progress");
+    }   
+
+    if (hasHistory(p, EXPIRED)) { 
+        fprintf(reportFile, "\n\n+ Expired tasks:\n");
+        for (int i = numel[EXPIRED] - 1; i >= 0; i--) {
+            Task t = tasks[EXPIRED][i];
+            fprintf(reportFile, "- %s (%s) Expired on: ", getTitle(t), getCourse(t));
+            fprintDate(reportFile, getDeadline(t));
+            fprintf(reportFile,"\n");
+        }
+        fprintCount(reportFile, numel[EXPIRED], "expired");
+    }
+
+    fprintf(reportFile, "\n\n\t      ---------------------\n\n$\n");
+    long length = ftell(reportFile) - offset;
+
+    fclose(reportFile); // Chiude il file dopo aver scritto il report
+    addReport(p->reports, date, offset, length);
+}
+
+/* generateWeeklyReport
+ * Syntax Specification:
+ * void generateWeeklyReport(Planner p, char *monday);
+ *
+ * Semantic Specification:
+ * Generates a weekly report file listing completed, in-progress, and expired tasks since the last Monday.
+ *
+ * Preconditions:
+ * - 'p' must be a valid pointer to a Planner.
+ * - The global variable 'today' must be initialized with a valid date.
+ *
+ * Postconditions:
+ * - Appends a formatted report to the "./Data/report.txt" file and records it in the report index.
+ *
+ * Side Effects:
+ * - Writes to a file.
+ * - Reads data from Planner and outputs messages in case of errors.
+ */
+void generateWeeklyReport(Planner p, char *monday) {
+    // the tasks of the week are kept by the counters: the history is not visited
+    WeekStats week = weekStats(p, monday);
+    int size = getSize(p->inProgress);
+    Task *tasks[3];
+    int numel[3];
+    tasks[PROGRESS] = malloc((size > 0 ? size : 1) * sizeof(Task));
+    if (week == NULL || tasks[PROGRESS] == NULL) {
+        fprintf(stderr, "\nError: memory allocation for the report failed.\n");
+        free(tasks[PROGRESS]);
+        return;
+    }
+
+    for (int i = 0; i < size; i++) tasks[PROGRESS][i] = getByIndex(p->inProgress, i);
+    numel[PROGRESS] = size;
+    numel[COMPLETED] = getWeekTasks(week, STATS_COMPLETED, &tasks[COMPLETED]);
+    numel[EXPIRED] = getWeekTasks(week, STATS_EXPIRED, &tasks[EXPIRED]);
+    writeReport(p, today, tasks, numel);
+    free(tasks[PROGRESS]);
+}
+
+// A task of the back-fill sweep, with one of its dates as number of days
+struct dated {
+    int day;
+    Task t;
+    int item;
+};
+
+static int compareDated(const void *a, const void *b) {
+    return ((const struct dated *)a)->day - ((const struct dated *)b)->day;
+}
+
+/* sweepReports
+ * Syntax Specification:
+ * static int sweepReports(Planner p, int first, int last);
+ *
+ * Semantic Specification:
+ * Generates the reports of the Mondays from 'first' to 'last' (days, see dateToDays)
+ * as they would have been generated on those days. Every task is sorted once by
+ * start, end, completion and deadline date, then a single sweep moves the week
+ * window forward, keeping the set of tasks in progress up to date; no collection
+ * is visited once per week. If 'first' is negative, the first Monday after the
+ * oldest task is used.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with every collection loaded.
+ *
+ * Postconditions:
+ * - Returns the number of reports generated, -1 if memory is not available.
+ *
+ * Side Effects:
+ * - Writes to files, allocates and frees memory.
+ */
+static int sweepReports(Planner p, int first, int last) {
+    int size = getSize(p->inProgress), numDone = 0, numExpired = 0, n = 0;
+    for (list l = p->completed; l != NULL; l = getNext(l)) numDone++;
+    for (list l = p->expired; l != NULL; l = getNext(l)) numExpired++;
+    int total = size + numDone + numExpired;
+    if (total == 0) return 0;
+
+    struct dated *byStart = malloc(total * sizeof(struct dated));
+    struct dated *byEnd = malloc(total * sizeof(struct dated));
+    struct dated *byDone = malloc((numDone > 0 ? numDone : 1) * sizeof(struct dated));
+    struct dated *byDeadline = malloc((numExpired > 0 ? numExpired : 1) * sizeof(struct dated));
+    Task *active = malloc(total * sizeof(Task));
+    int *activeItem = malloc(total * sizeof(int));
+    int *position = malloc(total * sizeof(int)); // index in 'active', -1 not started, -2 ended
+    Task *done = malloc((numDone > 0 ? numDone : 1) * sizeof(Task));
+    Task *expired = malloc((numExpired > 0 ? numExpired : 1) * sizeof(Task));
+    int generated = -1;
+    if (byStart == NULL || byEnd == NULL || byDone == NULL || byDeadline == NULL || active == NULL ||
+        activeItem == NULL || position == NULL || done == NULL || expired == NULL) goto end;
+
+    // a task is in progress from its start date until its deadline, or the day before its completion
+    list l = p->completed;
+    for (int i = 0; i < total; i++) {
+        Task t;
+        if (i < size) t = getByIndex(p->inProgress, i);
+        else {
+            if (i == size + numDone) l = p->expired;
+            t = getValue(l);
+            l = getNext(l);
+        }
+        int end = dateToDays(getDeadline(t));
+        if (i >= size && i < size + numDone) {
+            int completion = dateToDays(getCompletionDate(t));
+            if (completion - 1 < end) end = completion - 1;
+            byDone[n].day = completion;
+            byDone[n].t = t;
+            n++;
+        } else if (i >= size + numDone) {
+            byDeadline[i - size - numDone].day = end;
+            byDeadline[i - size - numDone].t = t;
+        }
+        byStart[i].day = dateToDays(getStartDate(t));
+        byStart[i].t = t;
+        byStart[i].item = i;
+        byEnd[i].day = end;
+        byEnd[i].t = t;
+        byEnd[i].item = i;
+        position[i] = -1;
+    }
+    qsort(byStart, total, sizeof(struct dated), compareDated);
+    qsort(byEnd, total, sizeof(struct dated), compareDated);
+    qsort(byDone, numDone, sizeof(struct dated), compareDated);
+    qsort(byDeadline, numExpired, sizeof(struct dated), compareDated);
+    for (int i = 0; i < numDone; i++) done[i] = byDone[i].t;
+    for (int i = 0; i < numExpired; i++) expired[i] = byDeadline[i].t;
+
+    if (first < 0) {
+        int oldest = byStart[0].day;
+        first = (last > oldest) ? last - ((last - oldest - 1) / 7) * 7 : last + 7;
+    }
+
+    int s = 0, e = 0, doneLo = 0, doneHi = 0, expLo = 0, expHi = 0, numActive = 0;
+    generated = 0;
+    for (int monday = first; monday <= last; monday += 7) {
+        while (s < total && byStart[s].day <= monday) {
+            int item = byStart[s].item;
+            if (position[item] == -1) {
+                active[numActive] = byStart[s].t;
+                activeItem[numActive] = item;
+                position[item] = numActive++;
+            }
+            s++;
+        }
+        while (e < total && byEnd[e].day < monday) {
+            int item = byEnd[e++].item;
+            int pos = position[item];
+            // a task ending before its start is never in progress
+            if (pos < 0) {
+                position[item] = -2;
+                continue;
+            }
+            active[pos] = active[--numActive];
+            activeItem[pos] = activeItem[numActive];
+            position[activeItem[pos]] = pos;
+            position[item] = -1;
+        }
+
+        // completed from the previous Monday to this one, expired from the previous Monday to yesterday
+        while (doneLo < numDone && byDone[doneLo].day < monday - 7) doneLo++;
+        while (doneHi < numDone && byDone[doneHi].day <= monday) doneHi++;
+        while (expLo < numExpired && byDeadline[expLo].day < monday - 7) expLo++;
+        while (expHi < numExpired && byDeadline[expHi].day < monday) expHi++;
+
+        Task *tasks[3] = { active, done + doneLo, expired + expLo };
+        int numel[3] = { numActive, doneHi - doneLo, expHi - expLo };
+        char date[9];
+        daysToDate(monday, date);
+        writeReport(p, date, tasks, numel);
+        generated++;
+    }
+
+end:
+    free(byStart);
+    free(byEnd);
+    free(byDone);
+    free(byDeadline);
+    free(active);
+    free(activeItem);
+    free(position);
+    free(done);
+    free(expired);
+    return generated;
+}
+
+/* backfillReports
+ * Syntax Specification:
+ * static void backfillReports(Planner p);
+ *
+ * Semantic Specification:
+ * Generates in one sweep the reports of the Mondays, before today, on which the
+ * planner was not opened: from the Monday after the last report in the index
+ * (or after the oldest task, if there are no reports) to the current week.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, the global 'today' initialized.
+ *
+ * Postconditions:
+ * - Every past week has its report.
+ *
+ * Side Effects:
+ * - Loads the history only if some report is missing, writes to files.
+ */
+static void backfillReports(Planner p) {
+    int now = dateToDays(today);
+    int last = dateToDays(getPreviousMonday());
+    if (last == now) last -= 7; // today's report is generated by startSession
+    char lastReport[9];
+    int first = -1;
+
+    if (getLastReportDate(p->reports, lastReport)) {
+        int from = dateToDays(lastReport);
+        if (from >= last) return;
+        first = last - ((last - from - 1) / 7) * 7;
+    }
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    int generated = sweepReports(p, first, last);
+    if (generated < 0) fprintf(stderr, "\nError: memory allocation for the missing reports failed.\n");
+    else if (generated > 0) fprintf(stderr, "\n%d missing weekly reports generated.\n", generated);
+}
+
+/* fprintReport
+ * Syntax Specification:
+ * static void fprintReport(FILE *f, const char *block);
+ *
+ * Semantic Specification:
+ * Writes the lines of a report block read from the report file.
+ *
+ * Preconditions:
+ * - 'block' must be a block returned by readReport, 'f' must be writable.
+ *
+ * Postconditions:
+ * - The lines of the report are written, without the markers of the block.
+ *
+ * Side Effects:
+ * - Writes into the file.
+ */
+static void fprintReport(FILE *f, const char *block) {
+    // the block is "date\n$\n<report>$\n": print only the lines between the two '$'
+    const char *line = strchr(block, '\n');
+    if (line != NULL) line = strchr(line + 1, '\n');
+    while (line != NULL && line[1] != '$' && line[1] != '\0') {
+        const char *next = strchr(line + 1, '\n');
+        if (next == NULL) break;
+        int len = next - (line + 1);
+        if (len > 0 && line[len] == '\r') len--;
+        fprintf(f, "%.*s\n", len, line + 1);
+        line = next;
+    }
+}
+
+/* searchReport
+ * Syntax Specification:
+ * bool searchReport(Planner p, const char *startDate, bool print);
+ *
+ * Semantic Specification:
+ * Looks up the weekly report generated on a given date through the report index
+ * and, if requested, displays it.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ * - 'startDate' must be a valid string representing a date in the format "ddmmyyyy".
+ *
+ * Postconditions:
+ * - Prints the matched report block to the screen if 'print' is true.
+ * - Returns true if a report is found, false otherwise.
+ *
+ * Side Effects:
+ * - Reads from file.
+ * - Outputs to the terminal.
+ */
+bool searchReport(Planner p, const char *startDate, bool print) {
+    if (!print) return hasReport(p->reports, startDate);
+
+    char *block = readReport(p->reports, startDate);
+    if (block == NULL) return false;
+
+    clearScreen();
+    printf("\nReport generated on date: ");
+    printDate(startDate);
+    printf("\n");
+    fprintReport(stdout, block);
+
+    free(block);
+    return true;
+}
+
+/* initPlanner
+ * Syntax Specification:
+ * static Planner initPlanner(void);
+ *
+ * Semantic Specification:
+ * Allocates an empty planner with all its collections marked as not loaded and clean.
+ *
+ * Preconditions:
+ * - None.
+ *
+ * Postconditions:
+ * - Returns a new Planner, or NULL in case of memory errors (nothing stays allocated).
+ *
+ * Side Effects:
+ * - Allocates memory.
+ * - Outputs error messages.
+ */
+static Planner initPlanner(void) {
+    Planner p = malloc(sizeof(struct planner));
+    if (p == NULL) {
+        fprintf(stderr, "Memory allocation error for planner.\n");
+        return NULL;
+    }
+
+    p->inProgress = newPQ();
+    p->completed = newList();
+    p->expired = newList();
+    paths = getFilePath();
+    p->reports = openReportIndex(paths[REPORT], paths[REPORT_INDEX]);
+    p->journal = openJournal(paths[JOURNAL], paths[CHECKPOINT]);
+    for (int i = 0; i < WEEK_CACHE; i++) p->week[i] = NULL;
+    p->courses = NULL;
+    p->plan = NULL;
+    p->due = NULL;
+    p->index = NULL;
+    p->text = NULL;
+    p->titles = NULL;
+    p->deps = NULL;
+    p->time = NULL;
+    p->undo = newUndoLog(UNDO_BUDGET);
+    p->recurring = loadRecurring(paths[RECURRING]);
+    for (int i = PROGRESS; i <= EXPIRED; i++) {
+        p->generation[i] = 0;
+        p->savedGeneration[i] = 0;
+        p->loaded[i] = false;
+        p->damaged[i] = false;
+        p->history[i].running = false;
+    }
+
+    if (p->inProgress == NULL || p->completed != NULL || p->expired != NULL || p->reports == NULL || p->journal == NULL ||
+        p->recurring == NULL || p->undo == NULL) {
+        fprintf(stderr, "Memory allocation error for planner internal structures.\n");
+        // the structures created before the failure are released
+        freePQ(p->inProgress);
+        freeReportIndex(p->reports);
+        closeJournal(p->journal);
+        freeRecurring(p->recurring);
+        freeUndoLog(p->undo);
+        free(p);
+        return NULL;
+    }
+    return p;
+}
+
+// Whether the queue already has an occurrence, added by a session stopped before saving the definitions
+static bool hasOccurrence(Planner p, const char *title, const char *deadline) {
+    for (int i = 0; i < getSize(p->inProgress); i++) {
+        Task t = getByIndex(p->inProgress, i);
+        if (strcmp(getDeadline(t), deadline) == 0 && strcmp(getTitle(t), title) == 0) return true;
+    }
+    return false;
+}
+
+/* expandRecurring
+ * Syntax Specification:
+ * static bool expandRecurring(Planner p);
+ *
+ * Semantic Specification:
+ * Adds to the in-progress queue, as one batch, the occurrences of the recurring
+ * tasks due within RECURRING_DAYS days from today, and drops the definitions
+ * with no occurrences left. The occurrences are computed from the next deadline
+ * of every definition: the later ones are never visited. The next deadlines
+ * move only once the occurrences are in the queue, and the tasks reach the
+ * journal before the definitions are saved, so the occurrences of a session
+ * stopped in between are found in the queue and not added twice.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with the in-progress queue loaded.
+ *
+ * Postconditions:
+ * - Returns true if the definitions changed and must be saved.
+ *
+ * Side Effects:
+ * - Modifies the in-progress queue and the definitions.
+ */
+static bool expandRecurring(Planner p) {
+    struct recurrence *rules;
+    int numRules = getRecurrences(p->recurring, &rules), first = dateToDays(today), last = first + RECURRING_DAYS;
+    int numel = 0, added = 0;
+    for (int i = 0; i < numRules; i++) numel += countOccurrences(&rules[i], first, last);
+
+    int *days = malloc((numel > 0 ? numel : 1) * sizeof(int)), *ids = malloc((numel > 0 ? numel : 1) * sizeof(int));
+    char (*dates)[9] = malloc((numel > 0 ? numel : 1) * sizeof(*dates));
+    struct taskFields *f = malloc((numel > 0 ? numel : 1) * sizeof(struct taskFields));
+    if (days == NULL || ids == NULL || dates == NULL || f == NULL) {
+        // nothing is taken: the occurrences are added by the next opening
+        free(days);
+        free(ids);
+        free(dates);
+        free(f);
+        return false;
+    }
+
+    for (int i = 0; i < numRules; i++) {
+        int n = getOccurrences(&rules[i], first, last, days);
+        for (int j = 0; j < n; j++) {
+            daysToDate(days[j], dates[added]);
+            if (hasOccurrence(p, rules[i].title, dates[added])) continue;
+            f[added] = (struct taskFields){ rules[i].title, rules[i].description, rules[i].course,
+                                            rules[i].estimatedTime, dates[added], rules[i].priority };
+            added++;
+        }
+    }
+    // the occurrences follow their definitions: they are not undone one by one
+    UndoLog undo = p->undo;
+    p->undo = NULL;
+    bool ok = (added == 0 || plannerAddMany(p, f, added, ids) > 0);
+    p->undo = undo;
+
+    bool changed = false;
+    // if the tasks were not added the definitions are left as they are: the next opening adds them
+    for (int i = 0; ok && i < numRules; i++) {
+        int next = rules[i].next;
+        skipOccurrences(&rules[i], first, last);
+        if (rules[i].next != next) changed = true;
+    }
+    if (ok && dropFinished(p->recurring) > 0) changed = true;
+
+    free(days);
+    free(ids);
+    free(dates);
+    free(f);
+    return changed;
+}
+
+/* startSession
+ * Syntax Specification:
+ * static void startSession(Planner p);
+ *
+ * Semantic Specification:
+ * Runs the checks done at every opening: expired tasks, the occurrences of the
+ * recurring tasks due in the next days, the reports of the weeks in which the
+ * planner was not opened and the weekly report of the day.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with the in-progress queue loaded.
+ *
+ * Postconditions:
+ * - Expired tasks are moved, occurrences are added and the report is generated if due.
+ *
+ * Side Effects:
+ * - May write the report file.
+ */
+static void startSession(Planner p) {
+    checkExpired(p);
+    if (expandRecurring(p)) saveRecurring(p->recurring, paths[RECURRING]);
+    backfillReports(p);
+    if (compareDates(today, getPreviousMonday()) == 0 && !searchReport(p, today, false)){
+        char *monday = getLastWeekDate();
+        generateWeeklyReport(p, monday);
+    }
+}
+
+/* saveChanges
+ * Syntax Specification:
+ * static bool saveChanges(Planner p);
+ *
+ * Semantic Specification:
+ * Writes on file the collections changed since they were loaded or saved, except
+ * the ones whose damaged file could not be set aside.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns true if every changed collection was saved.
+ *
+ * Side Effects:
+ * - Writes to files.
+ */
+static bool saveChanges(Planner p) {
+    // only the collections changed during the session are rewritten
+    if (isDirty(p, PROGRESS) && !p->damaged[PROGRESS] && saveOnFileQueue(p->inProgress, paths[PROGRESS]))
+        p->savedGeneration[PROGRESS] = p->generation[PROGRESS];
+    if (isDirty(p, COMPLETED) && !p->damaged[COMPLETED] && saveOnFileList(p->completed, paths[COMPLETED]))
+        p->savedGeneration[COMPLETED] = p->generation[COMPLETED];
+    if (isDirty(p, EXPIRED) && !p->damaged[EXPIRED] && saveOnFileList(p->expired, paths[EXPIRED]))
+        p->savedGeneration[EXPIRED] = p->generation[EXPIRED];
+    return !isDirty(p, PROGRESS) && !isDirty(p, COMPLETED) && !isDirty(p, EXPIRED);
+}
+
+/* applyChange
+ * Syntax Specification:
+ * static void applyChange(void *ctx, const char *op, Task t, int id);
+ *
+ * Semantic Specification:
+ * Applies a change read from the journal. Tasks are matched by id, so applying
+ * a change already contained in the data files has no effect.
+ *
+ * Preconditions:
+ * - 'ctx' must be the Planner being recovered, with every collection loaded.
+ *
+ * Postconditions:
+ * - The change is applied; 't' belongs to the planner.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections, frees the replaced tasks.
+ */
+static void applyChange(void *ctx, const char *op, Task t, int id) {
+    Planner p = ctx;
+    Task old;
+
+    if (op[0] == 'H') {
+        freeList(&(p->completed));
+        freeList(&(p->expired));
+        return;
+    }
+    if (op[0] == 'P') {
+        old = getByPQId(p->inProgress, id);
+        if (old != NULL) freeTask(pop(p->inProgress, old));
+        if (t != NULL) enqueue(p->inProgress, t);
+        return;
+    }
+
+    list *l = (op[0] == 'C') ? &(p->completed) : &(p->expired);
+    old = getByLId(*l, id);
+    if (old != NULL) freeTask(popL(l, old));
+    if (t != NULL) *l = consList(t, *l);
+}
+
+/* recoverPlanner
+ * Syntax Specification:
+ * static void recoverPlanner(Planner p);
+ *
+ * Semantic Specification:
+ * If the previous session did not close, rebuilds its state from the newest valid
+ * checkpoint and the journal written after it, then saves it on the data files.
+ * Only the changes since the last checkpoint are replayed.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with the in-progress queue loaded.
+ *
+ * Postconditions:
+ * - The planner contains every change logged before the crash.
+ *
+ * Side Effects:
+ * - Reads, writes and removes files; prints a message if something was recovered.
+ */
+static void recoverPlanner(Planner p) {
+    if (!needsRecovery(p->journal)) return;
+
+    // same order as the session (startSession reads the expired tasks first), so that
+    // tasks of files older than the ids get the same ids they had before the crash
+    loadHistory(p, EXPIRED);
+    loadHistory(p, COMPLETED);
+
+    Task *items[JOURNAL_COLLECTIONS];
+    int numel[JOURNAL_COLLECTIONS];
+    int mask = loadCheckpoint(p->journal, items, numel);
+    for (int c = PROGRESS; c <= EXPIRED; c++) {
+        if (!(mask & (1 << c))) continue;
+        if (c == PROGRESS) {
+            freePQ(p->inProgress);
+            p->inProgress = newPQ();
+            enqueueMany(p->inProgress, items[c], numel[c]);
+        } else {
+            list *l = (c == COMPLETED) ? &(p->completed) : &(p->expired);
+            freeList(l);
+            // same order as scanFileList
+            for (int i = 0; i < numel[c]; i++) *l = consList(items[c][i], *l);
+        }
+        free(items[c]);
+    }
+    int replayed = replayJournal(p->journal, applyChange, p);
+    // the words changed by the lost session are not in the text index: it is built again when needed
+    remove(paths[TEXT_INDEX]);
+
+    for (int c = PROGRESS; c <= EXPIRED; c++) touch(p, c);
+    if (saveChanges(p)) discardJournal(p->journal);
+    fprintf(stderr, "\nThe last session was not closed: its changes were recovered (%s, %d changes replayed).\n",
+           mask ? "from a checkpoint" : "from the journal", replayed);
+}
+
+/* loadProgress
+ * Syntax Specification:
+ * static void loadProgress(Planner p);
+ *
+ * Semantic Specification:
+ * Reads the tasks in progress with loadTasks, which parses large files on
+ * several threads, and puts them in the queue in file order. If the file
+ * cannot be read that way, it is read record by record (scanFileQueue).
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner with an empty queue.
+ *
+ * Postconditions:
+ * - The queue holds the tasks of the file; a damaged file is set aside.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static void loadProgress(Planner p) {
+    Task *items;
+    int lastId;
+    bool damaged;
+    int numel = loadTasks(paths[PROGRESS], &items, &lastId, &damaged);
+    if (numel < 0) {
+        scanFileQueue(p->inProgress, fopen(paths[PROGRESS], "r"), &damaged);
+    } else {
+        reserveTaskIds(lastId);
+        reservePQ(p->inProgress, numel);
+        // one task at a time, like scanFileQueue: the heap is the same as with the sequential read
+        for (int i = 0; i < numel; i++) enqueue(p->inProgress, assignTaskId(items[i]));
+        free(items);
+    }
+    if (damaged) setAsideDamaged(p, PROGRESS);
+    p->loaded[PROGRESS] = true;
+}
+
+Planner openPlanner() {
+    Planner p = initPlanner();
+    if (p != NULL) {
+        // completed and expired are history: they are read in the background and handed over when first needed
+        startHistoryLoad(p, COMPLETED);
+        startHistoryLoad(p, EXPIRED);
+        loadProgress(p);
+        recoverPlanner(p);
+        readWeekFile(p);
+        startSession(p);
+    }
+    return p;
+}
+
+int closePlanner(Planner p){
+    if (p == NULL) {
+        fprintf(stderr, "\nError: planner is empty or non-existent\n");
+        return 0;
+    }
+
+    // the journal is kept if some file could not be saved: the next opening recovers it
+    if (saveChanges(p)) {
+        discardJournal(p->journal);
+        writeWeekFile(p);
+    }
+    closeJournal(p->journal);
+    for (int i = 0; i < WEEK_CACHE; i++) freeWeekStats(p->week[i]);
+    freeAnalytics(p->courses);
+    freeSchedule(p->plan);
+    freeDueView(p->due);
+    freeQueryIndex(p->index);
+    if (p->text != NULL) saveTextIndex(p->text, paths[TEXT_INDEX]);
+    freeTextIndex(p->text);
+    freeTitleIndex(p->titles);
+    freeRecurring(p->recurring);
+    freeTaskGraph(p->deps);
+    freeUndoLog(p->undo);
+    if (p->time != NULL) saveTimeLog(p->time, paths[TIME_TOTALS]);
+    freeTimeLog(p->time);
+
+    freePQ(p->inProgress);
+    for (int c = COMPLETED; c <= EXPIRED; c++) joinHistoryLoad(p, c, false);
+    freeList(&(p->completed));
+    freeList(&(p->expired));
+    freeReportIndex(p->reports);
+    free(p);
+    return 1;
+}
+
+// True if 's' has 1 to 'max' characters and no control character: tabs and
+// line breaks would split the records of the data files and of the journal,
+// and an empty field could not be read back from them
+static bool validText(const char *s, size_t max) {
+    size_t len = 0;
+    for (; s[len] != '\0'; len++) {
+        if ((unsigned char) s[len] < 0x20 || s[len] == 0x7f) return false;
+    }
+    return len > 0 && len <= max;
+}
+
+/* validFields
+ * Syntax Specification:
+ * static bool validFields(const char *title, const char *description, const char *course,
+ *                         int estimatedTime, const char *deadline, const char *priority);
+ *
+ * Semantic Specification:
+ * Checks the fields of a task given to the API; NULL fields are not checked.
+ *
+ * Preconditions:
+ * - The global variable 'today' must be initialized.
+ *
+ * Postconditions:
+ * - Returns true if every field given fits the task: text not empty and
+ *   within its length, no control characters, estimated time not negative, deadline valid and not past,
+ *   priority "low", "medium" or "high".
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool validFields(const char *title, const char *description, const char *course,
+                        int estimatedTime, const char *deadline, const char *priority) {
+    if (title != NULL && !validText(title, 20)) return false;
+    if (description != NULL && !validText(description, 255)) return false;
+    if (course != NULL && !validText(course, 50)) return false;
+    if (estimatedTime < 0) return false;
+    if (deadline != NULL && !isValidDate(deadline)) return false;
+    if (priority != NULL && strcmp(priority, "low") != 0 && strcmp(priority, "medium") != 0 && strcmp(priority, "high") != 0)
+        return false;
+    return true;
+}
+
+/* completeTask
+ * Syntax Specification:
+ * static void completeTask(Planner p, Task t, const char *date);
+ *
+ * Semantic Specification:
+ * Moves a task in progress to the completed list, completed on 'date'.
+ *
+ * Preconditions:
+ * - 't' must be in the in-progress queue, 'date' a valid date.
+ *
+ * Postconditions:
+ * - The task is completed at 100% and logged as one batch: after a crash it is
+ *   either still in progress or completed.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections.
+ */
+static void completeTask(Planner p, Task t, const char *date) {
+    loadHistory(p, COMPLETED);
+    Task before = snapshot(p, t);
+    untrack(p, t, STATS_PROGRESS);
+    setCompletionPercentage(t, 100.0);
+    setCompletionDate(t, date);
+    p->completed = consList(pop(p->inProgress, t), p->completed);
+    track(p, t, STATS_COMPLETED);
+    record(p, UNDO_COMPLETE, before, t);
+    touch(p, PROGRESS);
+    touch(p, COMPLETED);
+    beginBatch(p->journal);
+    logTaskId(p->journal, "P-", getId(t));
+    logTask(p->journal, "C+", t);
+    endBatch(p->journal);
+    commit(p);
+}
+
+/* plannerAddTask
+ * Syntax Specification:
+ * int plannerAddTask(Planner p, const struct taskFields *f);
+ *
+ * Semantic Specification:
+ * Adds a new task to the in-progress queue, started today. No input or output
+ * is done: the result tells what happened.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'f' must have every field set.
+ *
+ * Postconditions:
+ * - Returns the id of the new task, or PLANNER_EINVALID / PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Modifies the in-progress queue.
+ */
+int plannerAddTask(Planner p, const struct taskFields *f) {
+    if (p == NULL || f == NULL || f->title == NULL || f->description == NULL || f->course == NULL ||
+        f->deadline == NULL || f->priority == NULL) return PLANNER_EINVALID;
+    if (!validFields(f->title, f->description, f->course, f->estimatedTime, f->deadline, f->priority))
+        return PLANNER_EINVALID;
+
+    char priority[7];
+    snprintf(priority, sizeof(priority), "%s", f->priority);
+    Task t = createTask(f->title, f->description, f->course, f->estimatedTime, f->deadline, priority);
+    if (t == NULL) return PLANNER_ENOMEM;
+    if (!enqueue(p->inProgress, t)) {
+        freeTask(t);
+        return PLANNER_ENOMEM;
+    }
+
+    touch(p, PROGRESS);
+    track(p, t, STATS_PROGRESS);
+    addTextTask(p->text, t);
+    beginAction(p->undo);
+    record(p, UNDO_ADD, NULL, t);
+    logTask(p->journal, "P+", t);
+    commit(p);
+    return getId(t);
+}
+
+/* plannerUpdate
+ * Syntax Specification:
+ * int plannerUpdate(Planner p, int id, const struct taskPatch *patch);
+ *
+ * Semantic Specification:
+ * Changes the fields of a task in progress selected by 'patch->fields' (PATCH_*
+ * flags). Every field is checked before any is changed. A completion of 100
+ * completes the task today.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was updated, PLANNER_ENOTFOUND or PLANNER_EINVALID otherwise.
+ *
+ * Side Effects:
+ * - Modifies the task and the Planner collections.
+ */
+int plannerUpdate(Planner p, int id, const struct taskPatch *patch) {
+    if (p == NULL || patch == NULL) return PLANNER_EINVALID;
+    Task t = getByPQId(p->inProgress, id);
+    if (t == NULL) return PLANNER_ENOTFOUND;
+
+    unsigned int f = patch->fields;
+    if (((f & PATCH_TITLE) && patch->title == NULL) || ((f & PATCH_DESCRIPTION) && patch->description == NULL) ||
+        ((f & PATCH_COURSE) && patch->course == NULL) || ((f & PATCH_DEADLINE) && patch->deadline == NULL) ||
+        ((f & PATCH_PRIORITY) && patch->priority == NULL)) return PLANNER_EINVALID;
+    if (!validFields((f & PATCH_TITLE) ? patch->title : NULL, (f & PATCH_DESCRIPTION) ? patch->description : NULL,
+                     (f & PATCH_COURSE) ? patch->course : NULL, (f & PATCH_TIME) ? patch->estimatedTime : 0,
+                     (f & PATCH_DEADLINE) ? patch->deadline : NULL, (f & PATCH_PRIORITY) ? patch->priority : NULL))
+        return PLANNER_EINVALID;
+    if ((f & PATCH_COMPLETION) && (isnan(patch->completion) || patch->completion < 0 || patch->completion > 100))
+        return PLANNER_EINVALID;
+    if (f == 0) return 1;
+
+    beginAction(p->undo);
+    Task before = snapshot(p, t);
+    // course, estimated time, deadline, priority and completion are part of the counters and of the plan
+    untrack(p, t, STATS_PROGRESS);
+    bool words = f & (PATCH_TITLE | PATCH_DESCRIPTION | PATCH_COURSE);
+    // a saved text index would miss the new words: it is read now and kept up to date
+    if (words) removeTextTask(textIndex(p, false), t);
+    if (f & PATCH_TITLE) setTitle(t, patch->title);
+    if (f & PATCH_DESCRIPTION) setDescription(t, patch->description);
+    if (f & PATCH_COURSE) setCourse(t, patch->course);
+    if (words) addTextTask(p->text, t);
+    if (f & PATCH_TIME) setExdTime(t, patch->estimatedTime);
+    if (f & PATCH_DEADLINE) setDeadline(t, patch->deadline);
+    if (f & PATCH_PRIORITY) {
+        char priority[7];
+        snprintf(priority, sizeof(priority), "%s", patch->priority);
+        setPriority(t, priority);
+        updatePQ(p->inProgress, t);
+    }
+    touch(p, PROGRESS);
+
+    if ((f & PATCH_COMPLETION) && patch->completion == 100.0f) {
+        // completeTask logs the task with all its changes, and records its own step
+        track(p, t, STATS_PROGRESS);
+        record(p, UNDO_UPDATE, before, t);
+        completeTask(p, t, today);
+        return 1;
+    }
+    if (f & PATCH_COMPLETION) setCompletionPercentage(t, patch->completion);
+    track(p, t, STATS_PROGRESS);
+    record(p, UNDO_UPDATE, before, t);
+    logTask(p->journal, "P=", t);
+    commit(p);
+    return 1;
+}
+
+/* plannerComplete
+ * Syntax Specification:
+ * int plannerComplete(Planner p, int id, const char *date);
+ *
+ * Semantic Specification:
+ * Completes a task in progress on 'date' (today if NULL).
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was completed, PLANNER_ENOTFOUND or PLANNER_EINVALID otherwise.
+ *
+ * Side Effects:
+ * - Moves the task to the completed list.
+ */
+int plannerComplete(Planner p, int id, const char *date) {
+    if (p == NULL) return PLANNER_EINVALID;
+    if (date == NULL) date = today;
+    if (!isValidDate(date)) return PLANNER_EINVALID;
+    Task t = getByPQId(p->inProgress, id);
+    if (t == NULL) return PLANNER_ENOTFOUND;
+
+    beginAction(p->undo);
+    completeTask(p, t, date);
+    return 1;
+}
+
+/* plannerDelete
+ * Syntax Specification:
+ * int plannerDelete(Planner p, int id);
+ *
+ * Semantic Specification:
+ * Removes a task from the in-progress queue. The undo log keeps it, so that
+ * the deletion can be undone; otherwise it is freed.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was deleted, PLANNER_ENOTFOUND otherwise.
+ *
+ * Side Effects:
+ * - Modifies the in-progress queue, frees memory.
+ */
+int plannerDelete(Planner p, int id) {
+    if (p == NULL) return PLANNER_EINVALID;
+    Task t = getByPQId(p->inProgress, id);
+    if (t == NULL) return PLANNER_ENOTFOUND;
+
+    untrack(p, t, STATS_PROGRESS);
+    removeTextTask(p->text, t);
+    pop(p->inProgress, t);
+    touch(p, PROGRESS);
+    logTaskId(p->journal, "P-", id);
+    commit(p);
+    // the task is kept by the undo log, not copied
+    beginAction(p->undo);
+    if (!record(p, UNDO_DELETE, NULL, t)) freeTask(t);
+    return 1;
+}
+
+/* plannerRestore
+ * Syntax Specification:
+ * int plannerRestore(Planner p, int id, const char *deadline, const char *priority);
+ *
+ * Semantic Specification:
+ * Moves an expired task back to the in-progress queue, restarted today at 0%
+ * with a new deadline and priority.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the task was restored, PLANNER_ENOTFOUND, PLANNER_EINVALID or
+ *   PLANNER_ENOMEM (the task stays expired) otherwise.
+ *
+ * Side Effects:
+ * - Loads the expired tasks if needed, modifies the Planner collections.
+ */
+int plannerRestore(Planner p, int id, const char *deadline, const char *priority) {
+    if (p == NULL || deadline == NULL || priority == NULL) return PLANNER_EINVALID;
+    if (!validFields(NULL, NULL, NULL, 0, deadline, priority)) return PLANNER_EINVALID;
+    loadHistory(p, EXPIRED);
+    Task t = getByLId(p->expired, id);
+    if (t == NULL) return PLANNER_ENOTFOUND;
+    // the room in the queue is made before the task is changed
+    if (!reservePQ(p->inProgress, getSize(p->inProgress) + 1)) return PLANNER_ENOMEM;
+
+    char pTxt[7];
+    snprintf(pTxt, sizeof(pTxt), "%s", priority);
+    beginAction(p->undo);
+    Task before = snapshot(p, t);
+    untrack(p, t, STATS_EXPIRED);
+    setCompletionPercentage(t, 0.0);
+    setStartDate(t);
+    setPriority(t, pTxt);
+    setDeadline(t, deadline);
+    if (!enqueue(p->inProgress, t)) {
+        // still in the expired list: it is counted there again
+        track(p, t, STATS_EXPIRED);
+        if (before != NULL) freeTask(before);
+        return PLANNER_ENOMEM;
+    }
+    popL(&(p->expired), t);
+    track(p, t, STATS_PROGRESS);
+    record(p, UNDO_RESTORE, before, t);
+    touch(p, EXPIRED);
+    touch(p, PROGRESS);
+    // one batch: after a crash the task is either expired or in progress
+    beginBatch(p->journal);
+    logTaskId(p->journal, "E-", id);
+    logTask(p->journal, "P+", t);
+    endBatch(p->journal);
+    commit(p);
+    return 1;
+}
+
+/* plannerAddRecurring
+ * Syntax Specification:
+ * int plannerAddRecurring(Planner p, const struct taskFields *f, int every, const char *until);
+ *
+ * Semantic Specification:
+ * Adds a recurring task: a task like 'f' is due on f->deadline and then every
+ * 'every' days up to 'until'. Only the definition is stored; every occurrence
+ * becomes a task in progress when its deadline is within RECURRING_DAYS days.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the id of the definition, PLANNER_EINVALID or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Writes the file of the recurring tasks; may add the first occurrences.
+ */
+int plannerAddRecurring(Planner p, const struct taskFields *f, int every, const char *until) {
+    if (p == NULL || f == NULL || f->title == NULL || f->description == NULL || f->course == NULL ||
+        f->deadline == NULL || f->priority == NULL || until == NULL) return PLANNER_EINVALID;
+    if (!validFields(f->title, f->description, f->course, f->estimatedTime, f->deadline, f->priority))
+        return PLANNER_EINVALID;
+    if (every <= 0 || !isValidDate(until) || compareDates(until, f->deadline) < 0) return PLANNER_EINVALID;
+
+    struct recurrence rec = { 0 };
+    snprintf(rec.title, sizeof(rec.title), "%s", f->title);
+    snprintf(rec.description, sizeof(rec.description), "%s", f->description);
+    snprintf(rec.course, sizeof(rec.course), "%s", f->course);
+    snprintf(rec.priority, sizeof(rec.priority), "%s", f->priority);
+    rec.estimatedTime = f->estimatedTime;
+    rec.every = every;
+    rec.next = dateToDays(f->deadline);
+    rec.until = dateToDays(until);
+    int id = addRecurrence(p->recurring, &rec);
+    if (id < 0) return PLANNER_ENOMEM;
+
+    expandRecurring(p);
+    saveRecurring(p->recurring, paths[RECURRING]);
+    return id;
+}
+
+/* plannerStopRecurring
+ * Syntax Specification:
+ * int plannerStopRecurring(Planner p, int id);
+ *
+ * Semantic Specification:
+ * Removes the definition of a recurring task: no more occurrences are added, the
+ * ones already in progress are kept.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1, or PLANNER_ENOTFOUND.
+ *
+ * Side Effects:
+ * - Writes the file of the recurring tasks.
+ */
+int plannerStopRecurring(Planner p, int id) {
+    if (p == NULL) return PLANNER_EINVALID;
+    if (!removeRecurrence(p->recurring, id)) return PLANNER_ENOTFOUND;
+    saveRecurring(p->recurring, paths[RECURRING]);
+    return 1;
+}
+
+// Definitions of the recurring tasks in order of id, to be read (not changed) by the caller
+int plannerGetRecurring(Planner p, struct recurrence **rules) {
+    *rules = NULL;
+    return (p != NULL) ? getRecurrences(p->recurring, rules) : PLANNER_EINVALID;
+}
+
+/* plannerAddPrerequisite, plannerRemovePrerequisite
+ * Syntax Specification:
+ * int plannerAddPrerequisite(Planner p, int id, int prerequisite);
+ * int plannerRemovePrerequisite(Planner p, int id, int prerequisite);
+ *
+ * Semantic Specification:
+ * Task 'prerequisite' must be finished before task 'id' (or no longer): while the
+ * prerequisite is in progress, the task is not among the ready tasks. An edge
+ * that would make two tasks wait for each other, directly or through others, is
+ * rejected.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - plannerAddPrerequisite returns 1 (also if the edge was already there),
+ *   PLANNER_ENOTFOUND if a task is not in progress, PLANNER_ECYCLE or PLANNER_ENOMEM.
+ * - plannerRemovePrerequisite returns 1, PLANNER_ENOTFOUND if there was no such
+ *   edge or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Reads the prerequisites if needed, writes their file.
+ */
+int plannerAddPrerequisite(Planner p, int id, int prerequisite) {
+    if (p == NULL) return PLANNER_EINVALID;
+    if (getByPQId(p->inProgress, id) == NULL || getByPQId(p->inProgress, prerequisite) == NULL) return PLANNER_ENOTFOUND;
+    TaskGraph g = taskGraph(p);
+    if (g == NULL) return PLANNER_ENOMEM;
+
+    int added = addPrerequisite(g, prerequisite, id);
+    if (added == GRAPH_ECYCLE) return PLANNER_ECYCLE;
+    if (added == GRAPH_ENOMEM) return PLANNER_ENOMEM;
+    if (added == 1) saveTaskGraph(g, paths[DEPENDS]);
+    return 1;
+}
+
+int plannerRemovePrerequisite(Planner p, int id, int prerequisite) {
+    if (p == NULL) return PLANNER_EINVALID;
+    TaskGraph g = taskGraph(p);
+    if (g == NULL) return PLANNER_ENOMEM;
+
+    if (!removePrerequisite(g, prerequisite, id)) return PLANNER_ENOTFOUND;
+    saveTaskGraph(g, paths[DEPENDS]);
+    return 1;
+}
+
+// Ids of the prerequisites of a task, to be read (not changed) by the caller until the next change
+int plannerGetPrerequisites(Planner p, int id, const int **ids) {
+    if (p == NULL || ids == NULL) return PLANNER_EINVALID;
+    TaskGraph g = taskGraph(p);
+    return (g != NULL) ? getPrerequisites(g, id, ids) : PLANNER_ENOMEM;
+}
+
+/* plannerReadyTasks
+ * Syntax Specification:
+ * int plannerReadyTasks(Planner p, Task *result, int max);
+ *
+ * Semantic Specification:
+ * The tasks in progress that can be worked on now, none of their prerequisites
+ * being in progress, by earliest deadline, then highest priority: the first one
+ * is the next task to work on. The view is kept up to date by every change, so
+ * completing a task releases its dependents in O(dependents · log(ready)).
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'result' must have room for 'max' tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks (at most 'max'), PLANNER_EINVALID or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Reads the prerequisites if needed, allocates memory.
+ */
+int plannerReadyTasks(Planner p, Task *result, int max) {
+    if (p == NULL || result == NULL || max <= 0) return PLANNER_EINVALID;
+    TaskGraph g = taskGraph(p);
+    if (g == NULL) return PLANNER_ENOMEM;
+
+    int numel = getReadyTasks(g, result, max);
+    if (numel >= 0) return numel;
+    // a task could not be activated: the view is read again on the next call
+    freeTaskGraph(p->deps);
+    p->deps = NULL;
+    return PLANNER_ENOMEM;
+}
+
+// Id of a task asked to a batch operation, with its position in the request
+struct wanted {
+    int id;
+    int index;
+};
+
+static int compareWanted(const void *a, const void *b) {
+    const struct wanted *x = a, *y = b;
+    if (x->id != y->id) return (x->id > y->id) - (x->id < y->id);
+    return x->index - y->index;
+}
+
+/* findMany
+ * Syntax Specification:
+ * static int findMany(Planner p, const int *ids, int n, Task *tasks);
+ *
+ * Semantic Specification:
+ * Finds the tasks in progress with the given ids with one scan of the queue,
+ * instead of one scan per id.
+ *
+ * Preconditions:
+ * - 'ids' and 'tasks' must have 'n' elements.
+ *
+ * Postconditions:
+ * - tasks[i] is the task with id ids[i], or NULL if it is not in progress (or
+ *   if the id was already asked before in 'ids').
+ * - Returns the number of tasks found, or -1 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates temporary memory.
+ */
+static int findMany(Planner p, const int *ids, int n, Task *tasks) {
+    struct wanted *wanted = malloc((n > 0 ? n : 1) * sizeof(struct wanted));
+    if (wanted == NULL) return -1;
+    for (int i = 0; i < n; i++) {
+        wanted[i].id = ids[i];
+        wanted[i].index = i;
+        tasks[i] = NULL;
+    }
+    qsort(wanted, n, sizeof(struct wanted), compareWanted);
+
+    int found = 0;
+    for (int i = 0; i < getSize(p->inProgress); i++) {
+        Task t = getByIndex(p->inProgress, i);
+        struct wanted key = { getId(t), -1 };
+        // first request of the id: the key sorts before every entry with the same id
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (compareWanted(&wanted[mid], &key) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < n && wanted[lo].id == key.id) {
+            tasks[wanted[lo].index] = t;
+            found++;
+        }
+    }
+    free(wanted);
+    return found;
+}
+
+/* plannerAddMany
+ * Syntax Specification:
+ * int plannerAddMany(Planner p, const struct taskFields *f, int n, int *ids);
+ *
+ * Semantic Specification:
+ * Adds a batch of tasks as plannerAddTask does, with one repair of the queue and
+ * one batch entry in the journal for all of them.
+ *
+ * Preconditions:
+ * - 'f' and 'ids' must have 'n' elements.
+ *
+ * Postconditions:
+ * - ids[i] is the id of the i-th new task, or the error that rejected it.
+ * - Returns the number of tasks added, or PLANNER_ENOMEM (nothing is added and
+ *   every id is an error).
+ *
+ * Side Effects:
+ * - Modifies the in-progress queue.
+ */
+int plannerAddMany(Planner p, const struct taskFields *f, int n, int *ids) {
+    if (p == NULL || f == NULL || ids == NULL || n <= 0) return 0;
+    Task *tasks = malloc(n * sizeof(Task));
+    if (tasks == NULL) {
+        for (int i = 0; i < n; i++) ids[i] = PLANNER_ENOMEM;
+        return PLANNER_ENOMEM;
+    }
+
+    int numel = 0;
+    for (int i = 0; i < n; i++) {
+        ids[i] = PLANNER_EINVALID;
+        if (f[i].title == NULL || f[i].description == NULL || f[i].course == NULL || f[i].deadline == NULL ||
+            f[i].priority == NULL) continue;
+        if (!validFields(f[i].title, f[i].description, f[i].course, f[i].estimatedTime, f[i].deadline, f[i].priority))
+            continue;
+
+        char priority[7];
+        snprintf(priority, sizeof(priority), "%s", f[i].priority);
+        Task t = createTask(f[i].title, f[i].description, f[i].course, f[i].estimatedTime, f[i].deadline, priority);
+        ids[i] = PLANNER_ENOMEM;
+        if (t == NULL) continue;
+        ids[i] = getId(t);
+        tasks[numel++] = t;
+    }
+
+    if (!enqueueMany(p->inProgress, tasks, numel)) {
+        for (int i = 0; i < numel; i++) freeTask(tasks[i]);
+        // the ids of the tasks freed are not returned
+        for (int i = 0; i < n; i++) if (ids[i] >= 0) ids[i] = PLANNER_ENOMEM;
+        free(tasks);
+        return PLANNER_ENOMEM;
+    }
+    beginBatch(p->journal);
+    beginAction(p->undo);
+    for (int i = 0; i < numel; i++) {
+        track(p, tasks[i], STATS_PROGRESS);
+        addTextTask(p->text, tasks[i]);
+        record(p, UNDO_ADD, NULL, tasks[i]);
+        logTask(p->journal, "P+", tasks[i]);
+    }
+    endBatch(p->journal);
+    if (numel > 0) touch(p, PROGRESS);
+    commit(p);
+    free(tasks);
+    return numel;
+}
+
+/* plannerCompleteMany, plannerDeleteMany
+ * Syntax Specification:
+ * int plannerCompleteMany(Planner p, const int *ids, int n, const char *date);
+ * int plannerDeleteMany(Planner p, const int *ids, int n);
+ *
+ * Semantic Specification:
+ * Complete (on 'date', today if NULL) or delete a batch of tasks in progress as
+ * plannerComplete and plannerDelete do. The tasks are found with one scan of the
+ * queue, removed with one repair of the heap and logged as one batch entry.
+ *
+ * Preconditions:
+ * - 'ids' must have 'n' elements.
+ *
+ * Postconditions:
+ * - Return the number of tasks completed or deleted (the ids not in progress are
+ *   ignored), PLANNER_EINVALID for an invalid date or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Modify the Planner collections; plannerDeleteMany frees the tasks.
+ */
+int plannerCompleteMany(Planner p, const int *ids, int n, const char *date) {
+    if (p == NULL || ids == NULL || n <= 0) return 0;
+    if (date == NULL) date = today;
+    if (!isValidDate(date)) return PLANNER_EINVALID;
+    Task *tasks = malloc(n * sizeof(Task));
+    if (tasks == NULL || findMany(p, ids, n, tasks) < 0) {
+        free(tasks);
+        return PLANNER_ENOMEM;
+    }
+
+    int numel = 0;
+    for (int i = 0; i < n; i++) if (tasks[i] != NULL) tasks[numel++] = tasks[i];
+    loadHistory(p, COMPLETED);
+    for (int i = 0; i < numel; i++) untrack(p, tasks[i], STATS_PROGRESS);
+    popMany(p->inProgress, tasks, numel);
+
+    beginBatch(p->journal);
+    beginAction(p->undo);
+    for (int i = 0; i < numel; i++) {
+        Task before = snapshot(p, tasks[i]);
+        setCompletionPercentage(tasks[i], 100.0);
+        setCompletionDate(tasks[i], date);
+        p->completed = consList(tasks[i], p->completed);
+        track(p, tasks[i], STATS_COMPLETED);
+        record(p, UNDO_COMPLETE, before, tasks[i]);
+        logTaskId(p->journal, "P-", getId(tasks[i]));
+        logTask(p->journal, "C+", tasks[i]);
+    }
+    endBatch(p->journal);
+    if (numel > 0) {
+        touch(p, PROGRESS);
+        touch(p, COMPLETED);
+    }
+    commit(p);
+    free(tasks);
+    return numel;
+}
+
+int plannerDeleteMany(Planner p, const int *ids, int n) {
+    if (p == NULL || ids == NULL || n <= 0) return 0;
+    Task *tasks = malloc(n * sizeof(Task));
+    if (tasks == NULL || findMany(p, ids, n, tasks) < 0) {
+        free(tasks);
+        return PLANNER_ENOMEM;
+    }
+
+    int numel = 0;
+    for (int i = 0; i < n; i++) if (tasks[i] != NULL) tasks[numel++] = tasks[i];
+    for (int i = 0; i < numel; i++) {
+        untrack(p, tasks[i], STATS_PROGRESS);
+        removeTextTask(p->text, tasks[i]);
+    }
+    popMany(p->inProgress, tasks, numel);
+
+    beginBatch(p->journal);
+    for (int i = 0; i < numel; i++) logTaskId(p->journal, "P-", getId(tasks[i]));
+    endBatch(p->journal);
+    if (numel > 0) touch(p, PROGRESS);
+    commit(p);
+    beginAction(p->undo);
+    for (int i = 0; i < numel; i++) {
+        if (!record(p, UNDO_DELETE, NULL, tasks[i])) freeTask(tasks[i]);
+    }
+    free(tasks);
+    return numel;
+}
+
+/* plannerStartStudy, plannerStopStudy, plannerLogStudy
+ * Syntax Specification:
+ * int plannerStartStudy(Planner p, int id);
+ * int plannerStopStudy(Planner p, int id, int *minutes);
+ * int plannerLogStudy(Planner p, int id, int minutes);
+ *
+ * Semantic Specification:
+ * Start a study session on a task in progress, stop it, or add a session of
+ * 'minutes' ending now (one that was not timed). A session keeps running when
+ * the planner is closed, and can be stopped after the task is completed. Every
+ * session is one line appended to the time log; the minutes are added to the
+ * totals of the task and of its course.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Return 1, PLANNER_ENOTFOUND, PLANNER_EINVALID (minutes not between 1 and
+ *   a day), PLANNER_ERUNNING (a session of the task is running),
+ *   PLANNER_ESTOPPED (none is), PLANNER_EIO or PLANNER_ENOMEM.
+ * - plannerStopStudy sets '*minutes' to the length of the session.
+ *
+ * Side Effects:
+ * - Reads the totals on first use, writes the time log.
+ */
+int plannerStartStudy(Planner p, int id) {
+    if (p == NULL) return PLANNER_EINVALID;
+    if (getByPQId(p->inProgress, id) == NULL) return PLANNER_ENOTFOUND;
+    TimeLog l = timeLog(p);
+    if (l == NULL) return PLANNER_ENOMEM;
+
+    int result = startStudy(l, id, studyClock());
+    if (result == TIMELOG_ERUNNING) return PLANNER_ERUNNING;
+    return (result == TIMELOG_EIO) ? PLANNER_EIO : 1;
+}
+
+int plannerStopStudy(Planner p, int id, int *minutes) {
+    if (p == NULL || minutes == NULL) return PLANNER_EINVALID;
+    TimeLog l = timeLog(p);
+    if (l == NULL) return PLANNER_ENOMEM;
+
+    int result = stopStudy(l, id, courseOfTask(p, id), studyClock());
+    if (result == TIMELOG_ESTOPPED) return PLANNER_ESTOPPED;
+    if (result == TIMELOG_EIO) return PLANNER_EIO;
+    *minutes = result;
+    return 1;
+}
+
+int plannerLogStudy(Planner p, int id, int minutes) {
+    if (p == NULL || minutes <= 0 || minutes > 24 * 60) return PLANNER_EINVALID;
+    Task t = getByPQId(p->inProgress, id);
+    if (t == NULL) return PLANNER_ENOTFOUND;
+    TimeLog l = timeLog(p);
+    if (l == NULL) return PLANNER_ENOMEM;
+
+    return (logStudy(l, id, getCourse(t), studyClock() - minutes, minutes) == TIMELOG_EIO) ? PLANNER_EIO : 1;
+}
+
+/* plannerStudyTime, plannerCourseTimes
+ * Syntax Specification:
+ * int plannerStudyTime(Planner p, int id, struct taskTime *t);
+ * int plannerCourseTimes(Planner p, const struct courseTime **courses);
+ *
+ * Semantic Specification:
+ * Return the minutes spent on a task (0 if it was never studied), to be
+ * compared with its estimated time, or on every course. Both read the totals
+ * kept by the sessions, never the log.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - plannerStudyTime returns 1, plannerCourseTimes the number of courses (the
+ *   array belongs to the planner, valid until the next session); PLANNER_ENOMEM
+ *   or PLANNER_EINVALID otherwise.
+ *
+ * Side Effects:
+ * - Read the totals on first use.
+ */
+int plannerStudyTime(Planner p, int id, struct taskTime *t) {
+    if (p == NULL || t == NULL) return PLANNER_EINVALID;
+    TimeLog l = timeLog(p);
+    if (l == NULL) return PLANNER_ENOMEM;
+    getTaskTime(l, id, t);
+    return 1;
+}
+
+int plannerCourseTimes(Planner p, const struct courseTime **courses) {
+    if (p == NULL || courses == NULL) return PLANNER_EINVALID;
+    TimeLog l = timeLog(p);
+    if (l == NULL) return PLANNER_ENOMEM;
+    return getCourseTimes(l, courses);
+}
+
+/* clearHistory
+ * Syntax Specification:
+ * static int clearHistory(Planner p);
+ *
+ * Semantic Specification:
+ * Discards the completed and expired tasks, in memory and on file, and the
+ * parts of the derived structures built on them. The change is logged but not
+ * committed, so that it can be part of a batch.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if both lists were freed, 0 otherwise.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections, removes and writes files.
+ */
+static int clearHistory(Planner p) {
+    // a read still running is not needed: its tasks are deleted anyway
+    for (int c = COMPLETED; c <= EXPIRED; c++) joinHistoryLoad(p, c, false);
+    p->loaded[COMPLETED] = true;
+    p->loaded[EXPIRED] = true;
+    touch(p, COMPLETED);
+    touch(p, EXPIRED);
+    logTaskId(p->journal, "H0", 0);
+    for (int i = 0; i < WEEK_CACHE; i++) clearHistoryStats(p->week[i]);
+    clearCourseHistory(p->courses);
+    clearIndexHistory(p->index);
+    // most of the words are gone: the text index is built again from the tasks in progress
+    freeTextIndex(p->text);
+    p->text = NULL;
+    remove(paths[TEXT_INDEX]);
+    // the nodes of the old titles are dropped as well
+    freeTitleIndex(p->titles);
+    p->titles = NULL;
+    // the prerequisites of the old tasks can no longer block anything
+    TaskGraph g = taskGraph(p);
+    if (g != NULL) {
+        pruneInactive(g);
+        saveTaskGraph(g, paths[DEPENDS]);
+    }
+    if (freeList(&(p->completed)) == 1 && freeList(&(p->expired)) == 1) return 1;
+    return 0;
+}
+
+// Writes the history on the archive files, from which an undo of clearHistory reads it back
+static bool archiveHistory(Planner p) {
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+    return saveOnFileList(p->completed, paths[ARCHIVE_COMPLETED]) && saveOnFileList(p->expired, paths[ARCHIVE_EXPIRED]);
+}
+
+/* bringBackHistory
+ * Syntax Specification:
+ * static bool bringBackHistory(Planner p);
+ *
+ * Semantic Specification:
+ * Undoes a clearHistory: the tasks of the archive files are added back to the
+ * completed and expired lists, to the derived structures and to the journal.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, inside a batch of the journal.
+ *
+ * Postconditions:
+ * - Returns false if an archive file cannot be read.
+ *
+ * Side Effects:
+ * - Reads the archive files (they are kept until the next clearHistory
+ *   overwrites them), modifies the Planner collections.
+ */
+static bool bringBackHistory(Planner p) {
+    for (int c = COMPLETED; c <= EXPIRED; c++) {
+        FILE *f = fopen(paths[(c == COMPLETED) ? ARCHIVE_COMPLETED : ARCHIVE_EXPIRED], "r");
+        if (f == NULL) return false;
+        loadHistory(p, c);
+        list *l = (c == COMPLETED) ? &(p->completed) : &(p->expired);
+        list old = *l;
+        bool damaged;
+        *l = scanFileList(old, f, &damaged);
+        if (damaged) setAsideDamaged(p, (c == COMPLETED) ? ARCHIVE_COMPLETED : ARCHIVE_EXPIRED);
+        // the tasks read are in front of the ones already in the list
+        for (list n = *l; n != old; n = getNext(n)) {
+            track(p, getValue(n), (c == COMPLETED) ? STATS_COMPLETED : STATS_EXPIRED);
+            addTextTask(p->text, getValue(n));
+            logTask(p->journal, (c == COMPLETED) ? "C+" : "E+", getValue(n));
+        }
+        touch(p, c);
+    }
+    // a saved text index only reads the ids after its last one: it is built again
+    if (p->text == NULL) remove(paths[TEXT_INDEX]);
+    return true;
+}
+
+// Takes a task out of a collection (PROGRESS, COMPLETED or EXPIRED), NULL if it is not there
+static Task takeOut(Planner p, int id, int collection) {
+    Task t;
+    if (collection == PROGRESS) {
+        t = getByPQId(p->inProgress, id);
+        if (t == NULL) return NULL;
+        untrack(p, t, STATS_PROGRESS);
+        pop(p->inProgress, t);
+    } else {
+        loadHistory(p, collection);
+        list *l = (collection == COMPLETED) ? &(p->completed) : &(p->expired);
+        t = getByLId(*l, id);
+        if (t == NULL) return NULL;
+        untrack(p, t, (collection == COMPLETED) ? STATS_COMPLETED : STATS_EXPIRED);
+        popL(l, t);
+    }
+    touch(p, collection);
+    return t;
+}
+
+// Puts a task in a collection, false if memory is not available
+static bool putIn(Planner p, Task t, int collection) {
+    if (collection == PROGRESS) {
+        if (!enqueue(p->inProgress, t)) return false;
+        track(p, t, STATS_PROGRESS);
+    } else {
+        loadHistory(p, collection);
+        list *l = (collection == COMPLETED) ? &(p->completed) : &(p->expired);
+        *l = consList(t, *l);
+        track(p, t, (collection == COMPLETED) ? STATS_COMPLETED : STATS_EXPIRED);
+    }
+    touch(p, collection);
+    return true;
+}
+
+/* moveTask
+ * Syntax Specification:
+ * static bool moveTask(Planner p, int id, int from, int to, bool redo);
+ *
+ * Semantic Specification:
+ * Undoes (or redoes) a step that moved a task between two collections: the task
+ * goes back from 'from' to 'to' with the fields of the step set to their old
+ * (or new) values, and the move is logged as one batch (part of the batch of
+ * the action, if any).
+ *
+ * Preconditions:
+ * - The step was just taken with takeStep(p->undo, redo, ...).
+ *
+ * Postconditions:
+ * - Returns false if the task is not in 'from' or memory is not available.
+ *
+ * Side Effects:
+ * - Modifies the task and the Planner collections.
+ */
+static bool moveTask(Planner p, int id, int from, int to, bool redo) {
+    static const char *removed[] = { "P-", "C-", "E-" }, *added[] = { "P+", "C+", "E+" };
+    Task t = takeOut(p, id, from);
+    if (t == NULL) return false;
+    applyStep(p->undo, redo, t);
+    if (!putIn(p, t, to)) {
+        freeTask(t);
+        return false;
+    }
+    beginBatch(p->journal);
+    logTaskId(p->journal, removed[from], id);
+    logTask(p->journal, added[to], t);
+    endBatch(p->journal);
+    return true;
+}
+
+/* applyUndoStep
+ * Syntax Specification:
+ * static bool applyUndoStep(Planner p, struct undoStep *s, bool redo);
+ *
+ * Semantic Specification:
+ * Undoes (or redoes) a step taken from the undo log. An added task leaves the
+ * queue and is kept by the log, a deleted one comes back from it; an update
+ * costs the fields it changed.
+ *
+ * Preconditions:
+ * - 's' was just taken with takeStep(p->undo, redo, s); inside a batch of the journal.
+ *
+ * Postconditions:
+ * - Returns false if the planner no longer matches the step (e.g. the task
+ *   expired in the meantime): the task handed over by the step is freed.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections, logs the changes.
+ */
+static bool applyUndoStep(Planner p, struct undoStep *s, bool redo) {
+    Task t;
+    bool words = s->fields & (TASK_TITLE | TASK_DESCRIPTION | TASK_COURSE);
+
+    switch (s->op) {
+    case UNDO_ADD:
+    case UNDO_DELETE:
+        if ((s->op == UNDO_ADD) != redo) {
+            // the task leaves the queue, the log keeps it
+            t = takeOut(p, s->id, PROGRESS);
+            if (t == NULL) return false;
+            removeTextTask(p->text, t);
+            keepTask(p->undo, redo, t);
+            logTaskId(p->journal, "P-", s->id);
+            return true;
+        }
+        if (s->task == NULL || !putIn(p, s->task, PROGRESS)) {
+            if (s->task != NULL) freeTask(s->task);
+            return false;
+        }
+        // its id may be before the last one of a saved index: the index is read now
+        addTextTask(textIndex(p, false), s->task);
+        logTask(p->journal, "P+", s->task);
+        return true;
+    case UNDO_UPDATE:
+        t = getByPQId(p->inProgress, s->id);
+        if (t == NULL) return false;
+        untrack(p, t, STATS_PROGRESS);
+        if (words) removeTextTask(textIndex(p, false), t);
+        applyStep(p->undo, redo, t);
+        if (words) addTextTask(p->text, t);
+        if (s->fields & TASK_PRIORITY) updatePQ(p->inProgress, t);
+        track(p, t, STATS_PROGRESS);
+        touch(p, PROGRESS);
+        logTask(p->journal, "P=", t);
+        return true;
+    case UNDO_COMPLETE:
+        return redo ? moveTask(p, s->id, PROGRESS, COMPLETED, redo) : moveTask(p, s->id, COMPLETED, PROGRESS, redo);
+    case UNDO_RESTORE:
+        return redo ? moveTask(p, s->id, EXPIRED, PROGRESS, redo) : moveTask(p, s->id, PROGRESS, EXPIRED, redo);
+    case UNDO_HISTORY:
+        if (!redo) return bringBackHistory(p);
+        if (!archiveHistory(p)) return false;
+        clearHistory(p);
+        return true;
+    }
+    return false;
+}
+
+/* undoAction
+ * Syntax Specification:
+ * static int undoAction(Planner p, bool redo);
+ *
+ * Semantic Specification:
+ * Undoes (or redoes) the last action, all its steps as one batch of the
+ * journal. If a step no longer matches the planner the log is cleared: the
+ * older actions would not match either.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the number of steps applied, or PLANNER_ENOTFOUND.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections.
+ */
+static int undoAction(Planner p, bool redo) {
+    int steps = lastAction(p->undo, redo), done = 0;
+    if (steps == 0) return PLANNER_ENOTFOUND;
+
+    beginBatch(p->journal);
+    for (; done < steps; done++) {
+        struct undoStep s;
+        takeStep(p->undo, redo, &s);
+        if (!applyUndoStep(p, &s, redo)) {
+            clearUndo(p->undo);
+            break;
+        }
+    }
+    endBatch(p->journal);
+    commit(p);
+    return (done > 0) ? done : PLANNER_ENOTFOUND;
+}
+
+/* plannerUndo, plannerRedo
+ * Syntax Specification:
+ * int plannerUndo(Planner p);
+ * int plannerRedo(Planner p);
+ *
+ * Semantic Specification:
+ * Undo the last action of the session (an add, update, completion, restore,
+ * deletion or deletion of the history, a batch counting as one), or redo the
+ * last one undone. A new action drops the actions to redo. Only the changes
+ * made through the planner are recorded: the tasks expired at the opening or
+ * the occurrences of the recurring tasks are not.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Return the number of tasks changed, PLANNER_ENOTFOUND if there is nothing
+ *   to undo (or redo), PLANNER_EINVALID if 'p' is NULL.
+ *
+ * Side Effects:
+ * - Modifies the Planner collections and logs the changes.
+ */
+int plannerUndo(Planner p) {
+    if (p == NULL) return PLANNER_EINVALID;
+    return undoAction(p, false);
+}
+
+int plannerRedo(Planner p) {
+    if (p == NULL) return PLANNER_EINVALID;
+    return undoAction(p, true);
+}
+
+/* plannerFindTask, plannerFindExpired
+ * Syntax Specification:
+ * int plannerFindTask(Planner p, const char *title);
+ * int plannerFindExpired(Planner p, const char *title);
+ *
+ * Semantic Specification:
+ * Return the id of the task in progress (or expired) with the given title.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'title' a null-terminated string.
+ *
+ * Postconditions:
+ * - Return the id, or PLANNER_ENOTFOUND.
+ *
+ * Side Effects:
+ * - plannerFindExpired loads the expired tasks if needed.
+ */
+int plannerFindTask(Planner p, const char *title) {
+    char key[21];
+    snprintf(key, sizeof(key), "%s", title);
+    if (p == NULL) return PLANNER_ENOTFOUND;
+    // once the trie of the titles is built, the queue is no longer scanned
+    Task t = (p->titles != NULL) ? findTitle(p->titles, key, 1u << PROGRESS) : getByPQTitle(p->inProgress, key);
+    return (t != NULL) ? getId(t) : PLANNER_ENOTFOUND;
+}
+
+int plannerFindExpired(Planner p, const char *title) {
+    if (p == NULL) return PLANNER_ENOTFOUND;
+    char key[21];
+    snprintf(key, sizeof(key), "%s", title);
+    loadHistory(p, EXPIRED);
+    Task t = (p->titles != NULL) ? findTitle(p->titles, key, 1u << EXPIRED) : getByLTitle(p->expired, key);
+    return (t != NULL) ? getId(t) : PLANNER_ENOTFOUND;
+}
+
+/* plannerSuggestTitles
+ * Syntax Specification:
+ * int plannerSuggestTitles(Planner p, const char *title, unsigned int states, Task *result, int max);
+ *
+ * Semantic Specification:
+ * Returns the tasks of the collections in 'states' (QUERY_PROGRESS, QUERY_COMPLETED,
+ * QUERY_EXPIRED; 0 for all) that the user may have meant with 'title', case
+ * ignored: first the titles starting with it, in order of title, then the ones
+ * at most TITLE_DISTANCE typos away, the closest first. The tasks are read (not
+ * changed) by the caller.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'title' a null-terminated string, 'result' must
+ *   have room for 'max' tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks (at most 'max'), PLANNER_EINVALID or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Loads the history and builds the trie of the titles if needed.
+ */
+int plannerSuggestTitles(Planner p, const char *title, unsigned int states, Task *result, int max) {
+    if (p == NULL || title == NULL || result == NULL || max <= 0) return PLANNER_EINVALID;
+
+    TitleIndex x = titleIndex(p);
+    if (x == NULL) return PLANNER_ENOMEM;
+    Task *near = malloc(max * sizeof(Task));
+    if (near == NULL) return PLANNER_ENOMEM;
+    int numel = completeTitle(x, title, states, result, max);
+    int numNear = (numel >= 0 && numel < max) ? suggestTitles(x, title, TITLE_DISTANCE, states, near, max) : 0;
+    if (numel < 0 || numNear < 0) {
+        // an incomplete trie is dropped and built again by the next search
+        free(near);
+        freeTitleIndex(p->titles);
+        p->titles = NULL;
+        return PLANNER_ENOMEM;
+    }
+
+    // a title both completed and close to the one given is shown once
+    int completed = numel;
+    for (int i = 0; i < numNear && numel < max; i++) {
+        bool seen = false;
+        for (int j = 0; j < completed && !seen; j++) seen = (result[j] == near[i]);
+        if (!seen) result[numel++] = near[i];
+    }
+    free(near);
+    return numel;
+}
+
+/* plannerGetTask
+ * Syntax Specification:
+ * Task plannerGetTask(Planner p, int id);
+ *
+ * Semantic Specification:
+ * Returns the task in progress with the given id, to be read (not changed) by the caller.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the task, or NULL if there is no task in progress with that id.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task plannerGetTask(Planner p, int id) {
+    return (p != NULL) ? getByPQId(p->inProgress, id) : NULL;
+}
+
+/* plannerQuery
+ * Syntax Specification:
+ * int plannerQuery(Planner p, const struct taskQuery *q, Task **result);
+ *
+ * Semantic Specification:
+ * Returns the tasks of every collection satisfying the query (see struct taskQuery),
+ * to be read (not changed) by the caller. The index of the queries finds them
+ * through the id, the title, the course or the deadline, whichever visits fewer
+ * tasks, or by a scan of its columns.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'q' a valid query.
+ *
+ * Postconditions:
+ * - '*result' is an array to be freed by the caller (NULL if no task matches).
+ * - Returns the number of tasks, PLANNER_EINVALID if the query is not valid or
+ *   PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Loads the history and builds the index if needed.
+ */
+int plannerQuery(Planner p, const struct taskQuery *q, Task **result) {
+    *result = NULL;
+    if (p == NULL || q == NULL) return PLANNER_EINVALID;
+    if ((q->filters & QUERY_TITLE) && q->title == NULL) return PLANNER_EINVALID;
+    if ((q->filters & QUERY_COURSE) && q->course == NULL) return PLANNER_EINVALID;
+    const char *dates[2] = { q->deadlineFrom, q->deadlineTo };
+    for (int i = 0; i < 2; i++) {
+        // any date, past ones included: the history is searched as well
+        if (dates[i] != NULL && (strlen(dates[i]) != 8 || !isOnlyDigits(dates[i], 8))) return PLANNER_EINVALID;
+    }
+    if (q->sort < QUERY_SORT_NONE || q->sort > QUERY_SORT_COMPLETION || q->limit < 0) return PLANNER_EINVALID;
+
+    QueryIndex x = queryIndex(p);
+    if (x == NULL) return PLANNER_ENOMEM;
+    int numel = runQuery(x, q, result);
+    if (numel < 0) {
+        // an incomplete index is dropped and built again by the next query
+        freeQueryIndex(p->index);
+        p->index = NULL;
+        return PLANNER_ENOMEM;
+    }
+    return numel;
+}
+
+/* plannerSearchText
+ * Syntax Specification:
+ * int plannerSearchText(Planner p, const char *text, Task **result);
+ *
+ * Semantic Specification:
+ * Returns the tasks of every collection having all the words of 'text' in their
+ * title, description or course (case does not matter), in order of id, to be
+ * read (not changed) by the caller. The words are looked up in the text index:
+ * only the candidates it returns are read, to discard the stale ones. When most
+ * of the index is stale it is built again.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'text' a null-terminated string.
+ *
+ * Postconditions:
+ * - '*result' is an array to be freed by the caller (NULL if no task matches).
+ * - Returns the number of tasks, PLANNER_EINVALID or PLANNER_ENOMEM.
+ *
+ * Side Effects:
+ * - Loads the history and the indexes if needed.
+ */
+int plannerSearchText(Planner p, const char *text, Task **result) {
+    *result = NULL;
+    if (p == NULL || text == NULL) return PLANNER_EINVALID;
+
+    TextIndex x = textIndex(p, true);
+    if (x != NULL && isTextStale(x)) {
+        freeTextIndex(p->text);
+        p->text = NULL;
+        remove(paths[TEXT_INDEX]);
+        x = textIndex(p, true);
+    }
+    QueryIndex tasks = queryIndex(p);
+    if (x == NULL || tasks == NULL) return PLANNER_ENOMEM;
+
+    int *ids;
+    int numel = searchText(x, text, &ids), found = 0;
+    if (numel < 0) return PLANNER_ENOMEM;
+    if (numel == 0) return 0;
+    *result = malloc(numel * sizeof(Task));
+    if (*result == NULL) {
+        free(ids);
+        return PLANNER_ENOMEM;
+    }
+    for (int i = 0; i < numel; i++) {
+        Task t = getIndexedTask(tasks, ids[i]);
+        if (t != NULL && matchesText(t, text)) (*result)[found++] = t;
+    }
+    free(ids);
+    if (found == 0) {
+        free(*result);
+        *result = NULL;
+    }
+    return found;
+}
+
+/* plannerReport
+ * Syntax Specification:
+ * int plannerReport(Planner p, const char *monday, FILE *f);
+ *
+ * Semantic Specification:
+ * Writes into 'f' the weekly report generated on 'monday', without the header
+ * and the screen handling of weeklyReport.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'f' must be writable.
+ *
+ * Postconditions:
+ * - Returns 1 if the report was written, PLANNER_ENOTFOUND if there is no
+ *   report for that date.
+ *
+ * Side Effects:
+ * - Reads the report file, writes into 'f'.
+ */
+int plannerReport(Planner p, const char *monday, FILE *f) {
+    if (p == NULL || monday == NULL || f == NULL) return PLANNER_EINVALID;
+    char *block = readReport(p->reports, monday);
+    if (block == NULL) return PLANNER_ENOTFOUND;
+
+    fprintReport(f, block);
+    free(block);
+    return 1;
+}
+
+/* plannerError
+ * Syntax Specification:
+ * const char *plannerError(int code);
+ *
+ * Semantic Specification:
+ * Describes a result of the API.
+ *
+ * Preconditions:
+ * - None.
+ *
+ * Postconditions:
+ * - Returns a constant string.
+ *
+ * Side Effects:
+ * - None.
+ */
+const char *plannerError(int code) {
+    switch (code) {
+        case PLANNER_ENOTFOUND: return "task not found";
+        case PLANNER_EINVALID: return "invalid field";
+        case PLANNER_ENOMEM: return "out of memory";
+        case PLANNER_ECYCLE: return "the tasks would wait for each other";
+        case PLANNER_ERUNNING: return "a study session of the task is already running";
+        case PLANNER_ESTOPPED: return "no study session of the task is running";
+        case PLANNER_EIO: return "the file could not be written";
+        default: return (code > 0) ? "ok" : "unknown error";
+    }
+}
+
+void printPlanner(Planner p) {
+    if (p == NULL) {
+        printf("\nPlanner not initialized.\n");
+        return;
+    }
+
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+
+    clearScreen();
+    printf("\n\n\t      --- Planner ---\n\n");
+    printList(p->completed);
+    printQueue(p->inProgress);
+    printList(p->expired);
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+}
+
+/* exportPlannerTo
+ * Syntax Specification:
+ * int exportPlannerTo(Planner p, const char *base, int format);
+ *
+ * Semantic Specification:
+ * Exports all the tasks to "<base>_tasks.<ext>" and the aggregates of the current
+ * week, overall and per course, to "<base>_report.<ext>", as JSON Lines
+ * (EXPORT_JSON, ext "jsonl") or CSV (EXPORT_CSV, ext "csv"). Records are
+ * streamed, never built in memory.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'base' a valid file name prefix.
+ *
+ * Postconditions:
+ * - Returns 1 if both files were written, 0 otherwise.
+ *
+ * Side Effects:
+ * - Loads the history if needed, creates or overwrites two files.
+ */
+int exportPlannerTo(Planner p, const char *base, int format) {
+    if (p == NULL || base == NULL) return 0;
+    loadHistory(p, COMPLETED);
+    loadHistory(p, EXPIRED);
+
+    const char *ext = (format == EXPORT_CSV) ? "csv" : "jsonl";
+    char filename[300];
+    snprintf(filename, sizeof(filename), "%s_tasks.%s", base, ext);
+    FILE *f = openExport(filename);
+    if (f == NULL) return 0;
+
+    exportTaskHeader(f, format);
+    for (int i = 0; i < getSize(p->inProgress); i++) {
+        exportTask(f, getByIndex(p->inProgress, i), "in_progress", format);
+    }
+    for (list l = p->completed; l != NULL; l = getNext(l)) exportTask(f, getValue(l), "completed", format);
+    for (list l = p->expired; l != NULL; l = getNext(l)) exportTask(f, getValue(l), "expired", format);
+    int ok = !ferror(f);
+    fclose(f);
+
+    WeekStats week = weekStats(p, getPreviousMonday());
+    if (week == NULL) return 0;
+    struct weekSummary summary;
+    getWeekSummary(week, &summary);
+    snprintf(filename, sizeof(filename), "%s_report.%s", base, ext);
+    f = openExport(filename);
+    if (f == NULL) return 0;
+    exportSummary(f, &summary, format);
+
+    int completed, inProgress, expired;
+    long minutes;
+    exportCourseHeader(f, format);
+    for (int i = 0; i < getCourseCount(week); i++) {
+        const char *course = getCourseStats(week, i, &completed, &inProgress, &expired, &minutes);
+        if (completed + inProgress + expired > 0) exportCourse(f, course, completed, inProgress, expired, minutes, format);
+    }
+    ok = ok && !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+/* exportPlanner
+ * Syntax Specification:
+ * int exportPlanner(Planner p);
+ *
+ * Semantic Specification:
+ * Asks for the format and the file name prefix, then exports the planner with exportPlannerTo.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the export succeeded, 0 otherwise.
+ *
+ * Side Effects:
+ * - User interaction, file writing.
+ */
+int exportPlanner(Planner p) {
+    if (p == NULL) {
+        printf("\nPlanner not initialized.\n");
+        return 0;
+    }
+
+    char fmt[5], base[256];
+    clearBuffer();
+    do {
+        printf("\nEnter the export format (json/csv): ");
+        read(4, fmt);
+    } while (strcmp(fmt, "json") != 0 && strcmp(fmt, "csv") != 0);
+    printf("\nEnter the name of the export (files <name>_tasks and <name>_report): ");
+    read(255, base);
+
+    int ok = exportPlannerTo(p, base, strcmp(fmt, "csv") == 0 ? EXPORT_CSV : EXPORT_JSON);
+    printf(ok ? "\n\nExport completed.\n" : "\n\nError: export failed.\n");
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return ok;
+}
+
+// Adds a batch of imported rows, see AddTasks
+static int addImported(void *ctx, const struct taskFields *f, int n, int *ids) {
+    return plannerAddMany(ctx, f, n, ids);
+}
+
+/* importTasks
  * Syntax Specification:
- * bool checkExpired(Planner p);
+ * int importTasks(Planner p);
  *
  * Semantic Specification:
- * Checks if any tasks in the in-progress queue have expired and moves them to the expired list.
+ * Asks for the name of a TSV or CSV file and adds all its valid rows to the
+ * in-progress queue with plannerAddMany, one batch of rows at a time (every
+ * batch is one journal entry and one action of undo), reporting the rejected rows.
  *
  * Preconditions:
- * - 'p' must be a valid Planner with a potentially non-empty in-progress queue.
- * - The global variable 'today' must contain a valid date string.
+ * - 'p' must be a valid Planner.
  *
  * Postconditions:
- * - Tasks that are past their deadline are moved from in-progress to expired.
- * - Returns true if at least one task was expired.
+ * - Returns 1 if the file was read, 0 otherwise.
  *
  * Side Effects:
- * - Modifies the Planner's inProgress and expired lists.
- * - Prints messages to the terminal.
+ * - User interaction, file reading, queue modification.
  */
-bool checkExpired(Planner p) {
-    if (emptyPQ(p->inProgress)) {
-        printf("\nThe queue is empty or non-existent.\n");
-        return false;
+int importTasks(Planner p) {
+    if (p == NULL) {
+        printf("\nPlanner not initialized.\n");
+        return 0;
     }
 
-    Task t;
-    bool found = false;
-    for(int i = 0; i < getSize(p->inProgress); i++) {
-        t = getByIndex(p->inProgress, i);
-        if (compareDates(getDeadline(t), today) < 0) {
-            found = true;
-            printf("\nTask '%s' expired", getTitle(t));
-            p->expired = consList(pop(p->inProgress, t), p->expired);
-            i--;
-        }
-    }
-    if (emptyPQ(p->inProgress)) {
-        printf("\nAll tasks have expired.\n");
-    } else {
-        printf("\nDeadline check completed\n");
+    char filename[256];
+    int rejected;
+    clearBuffer();
+    printf("\nEnter the file to import (TSV or CSV): ");
+    read(255, filename);
+
+    // the plan is built again when needed: one sort costs less than inserting every task
+    freeSchedule(p->plan);
+    p->plan = NULL;
+    int imported = importFile(filename, addImported, p, &rejected);
+    if (imported >= 0) {
+        printf("\n\n%d tasks imported, %d rows rejected.\n", imported, rejected);
     }
-    return found;
+
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return imported >= 0;
 }
 
-/* generateWeeklyReport
+/* showTaskProgress
  * Syntax Specification:
- * void generateWeeklyReport(Planner p);
+ * int showTaskProgress(Planner p);
  *
  * Semantic Specification:
- * Generates a weekly report file listing completed, in-progress, and expired tasks since the last Monday.
+ * Shows the completion and the time progress of every task in progress, in
+ * queue order or from the most behind schedule. The progress of all the tasks is
+ * computed by one batch kernel on the columns of the batch, then formatted.
  *
  * Preconditions:
- * - 'p' must be a valid pointer to a Planner.
- * - The global variable 'today' must be initialized with a valid date.
+ * - 'p' must be a valid Planner.
  *
  * Postconditions:
- * - Appends a formatted report to the "./Data/report.txt" file.
+ * - Returns 1 if the progress was shown, 0 otherwise.
  *
  * Side Effects:
- * - Writes to a file.
- * - Reads data from Planner and outputs messages in case of errors.
+ * - User interaction, terminal output.
  */
-void generateWeeklyReport(Planner p, char *monday) {
-    FILE *reportFile = fopen(paths[3], "a"); // Apertura in modalità append per non sovrascrivere il contenuto
-    int counter = 0;
-
-    if (reportFile == NULL) {
-        printf("\nError: Unable to open report file.\n");
-        return;
+int showTaskProgress (Planner p){
+    if (p == NULL){
+        printf("\nError: planner does not exist\n");
+        return 0;
+    }
+    if (emptyPQ(p->inProgress)) {
+        printf("\nThere are no tasks in progress at the moment.\n");
+        return 0;
     }
 
-    fprintf(reportFile, "%s", today);
-    fprintf(reportFile, "\n$\n\n\t      --- Weekly Report ---\n\n");
+    char ans;
+    printf("\nShow the most behind schedule first? (y/n) ");
+    scanf(" %c", &ans);
 
-    if (p->completed != NULL) {
-        fprintf(reportFile, "\n+ Completed tasks:\n");
-        list temp = p->completed;
-        while (temp != NULL) {
-            Task t = getValue(temp);
-            if (compareDates(getCompletionDate(t), monday) >= 0 && compareDates(getCompletionDate(t), today) <= 0) {
-                fprintf(reportFile, "- %s (%s) Completed on: ", getTitle(t), getCourse(t));
-                fprintDate(reportFile, getCompletionDate(t));
-                fprintf(reportFile, "\n");
-                counter++;
-            }
-            temp = getNext(temp);
-        }
-        fprintf(reportFile, "* There are %s completed task", counter ? intToString(counter) : "no" );
+    ProgressBatch batch = newProgressBatch();
+    if (batch == NULL || gatherProgress(batch, p->inProgress) < 0) {
+        freeProgressBatch(batch);
+        printf("\nError: memory allocation for the progress failed.\n");
+        return 0;
     }
+    computeProgress(batch);
+    if (ans == 'y') sortByDelay(batch);
 
-    if (p->inProgress != NULL) {
-        counter = 0;
-        fprintf(reportFile, "\n\n+ Tasks in progress:\n");
-        for (int i = 0; i < getSize(p->inProgress); i++, counter++) {
-            Task t = getByIndex(p->inProgress, i);
-            if (compareDates(getDeadline(t), today) == 0) {
-            fprintf(reportFile, "- %s (%s) ! Due today !\n", getTitle(t), getCourse(t));
-            } else {
-                fprintf(reportFile, "- %s (%s) Deadline: ", getTitle(t), getCourse(t));
-                fprintDate(reportFile, getDeadline(t));
-                fprintf(reportFile, "\n");
-            }
-        }
-        fprintf(reportFile, "* There are %s in progress task", counter ? intToString(counter) : "no" );
-    }   
+    Task t;
+    float completion, timePerc;
+    bool valid;
 
-    if (p->expired != NULL) { 
-        counter = 0;
-        fprintf(reportFile, "\n\n+ Expired tasks:\n");
-        list temp = p->expired;
-        while (temp != NULL) {
-            Task t = getValue(temp);
-            if (compareDates(getDeadline(t), monday) >= 0 && compareDates(getDeadline(t), today) < 0) {
-                fprintf(reportFile, "- %s (%s) Expired on: ", getTitle(t), getCourse(t));
-                fprintDate(reportFile, getDeadline(t));
-                fprintf(reportFile,"\n");
-                counter++;
-            }
-            temp = getNext(temp);
+    clearScreen();
+    printf("\n\n\t      --- Task Progress ---\n\n");
+    for (int i = 0; i < getProgressCount(batch); i++) {
+        t = getProgressEntry(batch, i, &completion, &timePerc, &valid);
+        if (!valid) {
+            printf("\nError: start and deadline dates are not valid.\n");
+            continue;
         }
-        fprintf(reportFile, "* There are %s expired task", counter ? intToString(counter) : "no" );
-    }
 
-    fprintf(reportFile, "\n\n\t      ---------------------\n\n$\n");
+        printf("\nTask %d: %s\n- Completion: %.2f%%\n- Time Progress: %.2f%%\n", 
+                i + 1, getTitle(t), completion, timePerc);
+    }
+    freeProgressBatch(batch);
 
-    fclose(reportFile); // Chiude il file dopo aver scritto il report
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return 1;
 }
 
-/* searchReport
+/* showCourseOverview
  * Syntax Specification:
- * bool searchReport(const char *startDate);
+ * int showCourseOverview(Planner p);
  *
  * Semantic Specification:
- * Searches for and displays a weekly report block in the report file that starts with a given date.
+ * Shows for every course the open, completed and expired tasks, the total and
+ * remaining estimated time, the time actually spent, the rate of tasks
+ * completed on time and the average lateness. The rollups and the totals of the
+ * time log are read, the tasks and the sessions are not visited.
  *
  * Preconditions:
- * - 'startDate' must be a valid string representing a date in the format "ddmmyyyy".
+ * - 'p' must be a valid Planner.
  *
  * Postconditions:
- * - Prints the matched report block to the screen.
- * - Returns true if a report is found, false otherwise.
+ * - Returns 1 if the overview was shown, 0 otherwise.
  *
  * Side Effects:
- * - Reads from file.
- * - Outputs to the terminal.
+ * - Loads the history the first time, terminal output.
  */
-bool searchReport(const char *startDate, bool print) {
-    FILE *file = fopen(paths[3], "r");
-    if (file == NULL) {
-        printf("\nError: Unable to open file.\n");
-        return false;
+int showCourseOverview(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist\n");
+        return 0;
+    }
+    Analytics a = courseAnalytics(p);
+    if (a == NULL) {
+        printf("\nError: memory allocation for the course overview failed.\n");
+        return 0;
     }
 
-    char line[512];
-    bool found = false;
-    bool insideBlock = false;
-
-    while (fgets(line, sizeof(line), file)) {
-        // Rimuove newline
-        line[strcspn(line, "\n")] = 0;
-
-        // Cerca una data intermedia
-        if (!insideBlock && strcmp(line, startDate) == 0) {
-            found = true;
-            if (print){
-                clearScreen();
-                printf("\nReport generated on date: ");
-                printDate(line);
-                printf("\n");
-            }
-            insideBlock = true; // Ora iniziamo a cercare il blocco di testo
-            continue;
-        }
+    // the totals of the time log, not its sessions, are read
+    TimeLog l = timeLog(p);
 
-        // Se abbiamo trovato la data, cerchiamo il primo $
-        if (insideBlock && print) {
-            if (line[0] == '$') {
-                // Se troviamo il primo $, iniziamo a stampare il contenuto
-                while (fgets(line, sizeof(line), file)) {
-                    line[strcspn(line, "\n")] = 0;
-                    if (line[0] == '$') break; // Stop al secondo $
-                    printf("%s\n", line);
-                }
-                break; // Fermiamo la ricerca dopo aver stampato il blocco
-            }
-        }
+    clearScreen();
+    printf("\n\n\t      --- Course Overview ---\n\n");
+    struct courseRollup r;
+    int shown = 0;
+    for (int i = 0; i < getRollupCount(a); i++) {
+        getRollupAt(a, i, &r);
+        if (r.open + r.completed + r.expired == 0) continue;
+        shown++;
+        printf("\nCourse: %s\n- Tasks: %d open, %d completed, %d expired\n", r.course, r.open, r.completed, r.expired);
+        printf("- Estimated time: %ld minutes, %.0f remaining\n", r.totalMinutes, r.remainingMinutes);
+        if (l != NULL) printf("- Time spent: %ld minutes\n", getCourseTime(l, r.course));
+        if (r.onTimeRate < 0) printf("- On time: no task closed yet\n");
+            else printf("- On time: %.2f%%\n", r.onTimeRate);
+        printf("- Average lateness: %.2f days\n", r.averageLateness);
     }
+    if (shown == 0) printf("\nThere are no tasks in the planner.\n");
 
-    fclose(file);
-    return found;
+    printf("\n\nPress x to continue...\n");
+    while (getchar() != 'x');
+    return 1;
 }
 
-Planner openPlanner() {
-    Planner p = malloc(sizeof(struct planner));
-    if (p != NULL) {
-        p->inProgress = newPQ();
-        p->completed = newList();
-        p->expired = newList();
-        paths = getFilePath();
-
-        if (p->inProgress == NULL || p->completed != NULL || p->expired != NULL) {
-            printf("Memory allocation error for planner internal structures.\n");
-            free(p);
-            return NULL;
-        }
-
-        scanFileQueue(p->inProgress, fopen(*paths, "r"));
-        p->completed = scanFileList(p->completed, fopen(paths[1], "r"));
-        p->expired = scanFileList(p->expired, fopen(paths[2], "r"));
-        checkExpired(p);
-        if (compareDates(today, getPreviousMonday()) == 0 && !searchReport(today, false)){
-            char *monday = getLastWeekDate();
-            generateWeeklyReport(p, monday);
-        }
-
-    } else {
-        printf("Memory allocation error for planner.\n");
+/* studyPlan
+ * Syntax Specification:
+ * static Schedule studyPlan(Planner p, int budget);
+ *
+ * Semantic Specification:
+ * Returns the study plan of the tasks in progress with 'budget' minutes per day.
+ * It is built with one sort the first time, then every change of a task moves
+ * only that task and places again the tasks after it.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner, 'budget' > 0.
+ *
+ * Postconditions:
+ * - Returns the plan, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static Schedule studyPlan(Planner p, int budget) {
+    if (p->plan != NULL) {
+        setDailyBudget(p->plan, budget);
+        return p->plan;
     }
-    return p;
-}
 
-int closePlanner(Planner p){
-    if (p == NULL) {
-        printf("\nError: planner is empty or non-existent\n");
-        return 0;
+    int size = getSize(p->inProgress);
+    Task *tasks = malloc((size > 0 ? size : 1) * sizeof(Task));
+    p->plan = newSchedule(budget);
+    if (tasks != NULL) {
+        for (int i = 0; i < size; i++) tasks[i] = getByIndex(p->inProgress, i);
     }
-
-    saveOnFileQueue(p->inProgress, *paths);
-    saveOnFileList(p->completed, paths[1]);
-    saveOnFileList(p->expired, paths[2]);
-
-    freePQ(p->inProgress);
-    freeList(&(p->completed));
-    freeList(&(p->expired));
-    free(p);
-    clearScreen();
-    printf("\n--- Study session ended ---\n");
+    if (tasks == NULL || p->plan == NULL || !buildSchedule(p->plan, tasks, size)) {
+        freeSchedule(p->plan);
+        p->plan = NULL;
+    }
+    free(tasks);
+    return p->plan;
 }
 
-/* setCompleted
+/* showStudyPlan
  * Syntax Specification:
- * int setCompleted(Task t, Planner p);
+ * int showStudyPlan(Planner p);
  *
  * Semantic Specification:
- * Marks a given task as completed by setting its percentage to 100 and setting its completion date.
+ * Asks for the minutes of study per day and shows the plan of the tasks in
+ * progress, earliest deadline first: the tasks that cannot be finished by their
+ * deadline are listed first, then the tasks of the next PLAN_DAYS_SHOWN days.
  *
  * Preconditions:
- * - 't' must be a valid Task.
  * - 'p' must be a valid Planner.
- * - The global variable 'today' must contain a valid date string.
  *
  * Postconditions:
- * - The task is updated as completed.
- * - The task is moved from the in-progress list to the completed list.
+ * - Returns 1 if the plan was shown, 0 otherwise.
  *
  * Side Effects:
- * - Modifies task attributes.
- * - Changes Planner state.
- * - Prints messages to the terminal.
+ * - User interaction, terminal output.
  */
-int setCompleted(Task t, Planner p){ 
-    if (t == NULL) {
-        printf("\nError: task is empty or non-existent\n");
+int showStudyPlan(Planner p) {
+    if (p == NULL) {
+        printf("\nError: planner does not exist\n");
         return 0;
     }
-
-    if (strcmp(getCompletionDate(t), "00000000") != 0) {
-        printf("\nTask is already completed.\n");
-    } else {
-        setCompletionPercentage(t, 100.0);
-        t = setCompletionDate(t, today);
-        p->completed = consList(pop(p->inProgress, t), p->completed);
-        printf("\nTask '%s' successfully completed.\n", getTitle(t));
+    if (emptyPQ(p->inProgress)) {
+        printf("\nThere are no tasks in progress at the moment.\n");
+        return 0;
     }
 
-    return 1;
-}
-
-int restoreExpiredTask(Planner p) {
-    if (p->inProgress == NULL || p->expired == NULL ) {
-        printf("\nError: the queue or the list is empty or non-existent\n");
+    int budget = 0;
+    while (budget <= 0) {
+        printf("\nEnter the minutes you can study per day: ");
+        if (scanf("%d", &budget) != 1) return 0;
+        if (budget <= 0) printf("\nError: the minutes must be positive.");
+    }
+    Schedule plan = studyPlan(p, budget);
+    if (plan == NULL) {
+        printf("\nError: memory allocation for the study plan failed.\n");
         return 0;
     }
-    char title[21];
-    clearBuffer();
-    printf("\nEnter the title of the task to restore: ");
-    read(20, title);
 
     clearScreen();
-    printf("\n\n      --- Restore Expired Task ---\n\n");
-    Task t = getByLTitle(p->expired, title);
-    if (t != NULL) {
-        t = setCompletionPercentage(t, 0.0);
-        char pTxt[7];
-        char newDeadline[9];
-        strcpy(newDeadline, "00000000");
-        t = setStartDate(t);
-
-        while (1) {
-            printf("\nEnter the priority level (low/medium/high): ");
-            read(6, pTxt);
-
-            if ((strcmp(pTxt, "low") == 0) || (strcmp(pTxt, "medium") == 0) || (strcmp(pTxt, "high") == 0)) {
-                t = setPriority(t, pTxt);
-                break;
-            } else {
-                printf("\n!! Error: invalid input, please try again !!");
-                memset(pTxt, '\0', sizeof(pTxt));
-            }
-        }
-        
-        while (!isValidDate(newDeadline)) {
-            printf("\nEnter the new deadline (format ddmmyyyy): ");
-            read(8, newDeadline);
-            if (!isValidDate(newDeadline)) {
-                printf("\n!! Invalid date !! Please try again !!");
-            }
+    printf("\n\n\t      --- Study Plan ---\n\n");
+    int late = getLateCount(plan), finishDay, shown = 0;
+    bool isLate;
+    char date[9];
+    if (late > 0) {
+        printf("\n%d tasks cannot be finished by their deadline:\n", late);
+        for (int i = 0; i < getScheduledCount(plan) && shown < PLAN_LATE_SHOWN; i++) {
+            Task t = getPlanEntry(plan, i, &finishDay, &isLate);
+            if (!isLate) continue;
+            daysToDate(dateToDays(today) + finishDay, date);
+            printf("- %s (%s): deadline ", getTitle(t), getCourse(t));
+            printDate(getDeadline(t));
+            printf(", finished on ");
+            printDate(date);
+            printf("\n");
+            shown++;
         }
-        t = setDeadline(t, newDeadline);
-        if (t == NULL) {
-            printf("\nError: invalid deadline.\n");
-            return 1;
-        }
-
-        enqueue(p->inProgress, popL(&(p->expired), t));
-        printf("\nTask '%s' successfully restored.\n", title);
-    } else {
-        printf("\nTask with title '%s' not found in the expired list.\n", title);
+        if (late > shown) printf("... and %d more\n", late - shown);
     }
 
-    return 0;
-}
-
-void printPlanner(Planner p) {
-    if (p == NULL) {
-        printf("\nPlanner not initialized.\n");
-        return;
+    int days = getPlanDays(plan);
+    printf("\n%d tasks planned in %d days.\n", getScheduledCount(plan), days);
+    for (int day = 0; day < days && day < PLAN_DAYS_SHOWN; day++) {
+        daysToDate(dateToDays(today) + day, date);
+        printf("\n");
+        printDate(date);
+        printf(":\n");
+        for (int i = findDayStart(plan, day); i < getScheduledCount(plan); i++) {
+            int minutes = getMinutesOnDay(plan, i, day);
+            Task t = getPlanEntry(plan, i, &finishDay, &isLate);
+            if (minutes > 0) printf("- %s (%s): %d minutes%s\n", getTitle(t), getCourse(t), minutes, isLate ? " (late)" : "");
+            if (finishDay > day) break;
+        }
     }
 
-    clearScreen();
-    printf("\n\n\t      --- Planner ---\n\n");
-    printList(p->completed);
-    printQueue(p->inProgress);
-    printList(p->expired);
     printf("\n\nPress x to continue...\n");
     while (getchar() != 'x');
+    return 1;
 }
 
-int insert(Planner p) {
-    if (p == NULL) {
-        printf("\nPlanner not initialized.\n");
-        return 0;
-    }
-
-    Task t = newTask();
-    if (t == NULL) {
-        printf("\nError: memory allocation for the task failed.\n");
-        return 0;
+/* dueView
+ * Syntax Specification:
+ * static DueView dueView(Planner p);
+ *
+ * Semantic Specification:
+ * Returns the tasks in progress bucketed by deadline day. The view is built with
+ * a single visit of the queue the first time, then kept up to date by every
+ * change and moved forward when the date changes.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns the view, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static DueView dueView(Planner p) {
+    if (p->due != NULL) {
+        rollDueView(p->due);
+        return p->due;
     }
 
-    if (enqueue(p->inProgress, t)) {
-        printf("\n\nTask successfully added to the in-progress queue.\n");
-        printf("\n\nPress x to continue...\n");
-        while (getchar() != 'x');
-        return 1;
-    } else {
-        printf("\n\nError: task insertion into the in-progress queue failed.\n");
-        printf("\n\nPress x to continue...\n");
-        while (getchar() != 'x');
-        return 0;
-    }
+    p->due = newDueView();
+    if (p->due == NULL) return NULL;
+    for (int i = 0; i < getSize(p->inProgress); i++) trackDue(p->due, getByIndex(p->inProgress, i));
+    return p->due;
 }
 
-Planner modifyTask(Planner p) {
-    if (p == NULL) {
-        printf("\nError: planner does not exist.\n");
-        return NULL;
-    }
-
-    char title[21], ans;
-    int choice;
-    Task t;
-    do {
-        clearBuffer();
-        printf("\nEnter the title of the task to modify: ");
-        read(20, title);
-        t = getByPQTitle(p->inProgress, title);
-        printf("\nThe selected task is: \n\n");
-        printTaskDetails(t);
-        printf("\n\nWould you pick another task? (y/n) ");
-        scanf("%c", &ans);
-    } while (ans != 'n');
-
-    do {
-        clearScreen();
-        printf("\n\n\t      --- Modification Menu ---\n\n");
-        printf("1. Change title\n");
-        printf("2. Change description\n");
-        printf("3. Change course\n");
-        printf("4. Change estimated time\n");
-        printf("5. Change deadline\n");
-        printf("6. Change priority\n");
-        printf("7. Change completion percentage\n");
-        printf("8. See the changes made\n");
-        printf("0. Return to main menu\n");
-        printf("Choose an option: ");
-        scanf("%d", &choice);
-
-        switch (choice) {
-            case 1: {
-                clearBuffer(); 
-                printf("\nEnter the new title (max 20): ");
-                read(20, title);
-                setTitle(t, title);
-                printf("\nTitle successfully changed to '%s'.\n", title);
-                break;
-            }
-            case 2: {
-                clearBuffer(); 
-                char newDescription[256];
-                printf("\nEnter the new description (max 255): ");
-                read(256, newDescription);
-                setDescription(t, newDescription);
-                printf("\nDescription successfully changed for task '%s'.\n", title);
-                break;
-            }
-            case 3: {
-                clearBuffer(); 
-                char newCourse[50];
-                printf("\nEnter the new course (max 50): ");
-                read(50, newCourse);
-                setCourse(t, newCourse);
-                printf("\nCourse successfully changed for task '%s'.\n", title);
-                break;
-            }
-            case 4: {
-                clearBuffer();
-                int newEstimatedTime;
-                do {
-                    if (newEstimatedTime < 0) printf("\nError: estimated time cannot be negative.");
-                    printf("\nEnter the new estimated time (in minutes): ");
-                    scanf("%d", &newEstimatedTime);
-                } while (newEstimatedTime < 0);
-                setExdTime(t, newEstimatedTime);
-                printf("\nEstimated time successfully changed for task '%s'.\n", title);
-                break;
-            }
-            case 5: {
-                clearBuffer(); 
-                char newDeadline[9];
-                while (!isValidDate(newDeadline)) {
-                    printf("\nEnter the new deadline (format ddmmyyyy): ");
-                    read(8, newDeadline);
-                    if (!isValidDate(newDeadline)) {
-                        printf("\n!! Invalid date !! Please try again !!");
-                    }
-                }
-                setDeadline(t, newDeadline);
-                printf("\nDeadline successfully changed for task '%s'.\n", title);
-                break;
-            }
-            case 6: {
-                clearBuffer(); 
-                char pTxt[6];
-                while (1) {
-                    printf("\nEnter priority level (low/medium/high): ");
-                    read(6, pTxt);
-
-                    if ((strcmp(pTxt, "low") != 0) && (strcmp(pTxt, "medium") != 0) && (strcmp(pTxt, "high") != 0)) {
-                        printf("\n!! Error: Invalid input, please try again !!");
-                        memset(pTxt, '\0', sizeof(pTxt));
-                    } else break;
-                }
-                setPriority(t, pTxt);
-                printf("\nPriority successfully changed for task '%s'.\n", title);
-                break;
-            }
-            case 7: {
-                clearBuffer(); 
-                float newPerc;
-                do {
-                    printf("\nEnter the new completion percentage (0-100): ");
-                    scanf("%f", &newPerc);
-                    if (newPerc < 0 || newPerc > 100) {
-                        printf("\nError: The percentage must be between 0 and 100.\n");
-                    }
-                } while (newPerc < 0 || newPerc > 100);
-            
-                if (newPerc == 100.0) {
-                    printf("\nGreat job, the task is complete\n");
-                    setCompleted(t, p);
-                } else {
-                    setCompletionPercentage(t, newPerc);
-                    printf("\nCompletion percentage successfully changed for task '%s'.\n", title);
-                }
-                break;
-            }
-            case 8: {
-                printTaskDetails(t);
-                printf("\n\nPress x to continue...\n");
-                while (getchar() != 'x');
-                break;}
-            case 0: break;
-            default: printf("Invalid choice, please try again.\n");
+/* printDue
+ * Syntax Specification:
+ * static int printDue(DueView v, int first, int last, const char *title);
+ *
+ * Semantic Specification:
+ * Prints a section of the deadlines: the tasks due from 'first' to 'last' days from today.
+ *
+ * Preconditions:
+ * - 'v' must be valid and rolled to today.
+ *
+ * Postconditions:
+ * - Returns the number of tasks printed.
+ *
+ * Side Effects:
+ * - Terminal output.
+ */
+static int printDue(DueView v, int first, int last, const char *title) {
+    Task *tasks;
+    int shown = 0;
+    printf("\n%s:\n", title);
+    for (int day = first; day <= last; day++) {
+        int numel = getDueTasks(v, day, &tasks);
+        for (int i = 0; i < numel; i++) {
+            printf("- %s (%s) Deadline: ", getTitle(tasks[i]), getCourse(tasks[i]));
+            printDate(getDeadline(tasks[i]));
+            printf("\n");
         }
-    } while (choice != 0);
+        shown += numel;
+    }
+    if (shown == 0) printf("- None\n");
+    return shown;
 }
 
-int showTaskProgress (Planner p){
-    if (p == NULL){
+/* showDueTasks
+ * Syntax Specification:
+ * int showDueTasks(Planner p);
+ *
+ * Semantic Specification:
+ * Shows the tasks due today, tomorrow and in the rest of the week (until Sunday).
+ * Only the buckets of those days are read, whatever the size of the queue.
+ *
+ * Preconditions:
+ * - 'p' must be a valid Planner.
+ *
+ * Postconditions:
+ * - Returns 1 if the deadlines were shown, 0 otherwise.
+ *
+ * Side Effects:
+ * - Terminal output.
+ */
+int showDueTasks(Planner p) {
+    if (p == NULL) {
         printf("\nError: planner does not exist\n");
         return 0;
     }
-    if (emptyPQ(p->inProgress)) {
-        printf("\nThere are no tasks in progress at the moment.\n");
+    DueView v = dueView(p);
+    if (v == NULL) {
+        printf("\nError: memory allocation for the deadlines failed.\n");
         return 0;
     }
-    Task t;
-    float timePerc = 0.0;
-    int totalTime = 0, timeSpent = 0;
-
-    clearScreen();
-    printf("\n\n\t      --- Task Progress ---\n\n");
-    for (int i = 0; i < getSize(p->inProgress); i++) {
-        t = getByIndex(p->inProgress, i);
-        totalTime = compareDates(getDeadline(t), getStartDate(t));
-        timeSpent = compareDates(today, getStartDate(t));
 
-        if (totalTime < 0) {
-            printf("\nError: start and deadline dates are not valid.\n");
-            continue;
-        }
-        if (totalTime == 0) timePerc = 100.0; 
-            else timePerc = ((float)timeSpent / totalTime) * 100.0;
+    // days from today to Sunday
+    int weekEnd = 6 - (dateToDays(today) - dateToDays(getPreviousMonday()));
 
-        printf("\nTask %d: %s\n- Completion: %.2f%%\n- Time Progress: %.2f%%\n", 
-                i + 1, getTitle(t), getCompletionPercentage(t), timePerc);
-    }
+    clearScreen();
+    printf("\n\n\t      --- Upcoming Deadlines ---\n\n");
+    printDue(v, 0, 0, "Due today");
+    printDue(v, 1, 1, "Due tomorrow");
+    if (weekEnd >= 2) printDue(v, 2, weekEnd, "Due this week");
 
     printf("\n\nPress x to continue...\n");
     while (getchar() != 'x');
@@ -590,7 +3521,7 @@ int weeklyReport (Planner p){
         return 0;
     }
 
-    if (!searchReport(getPreviousMonday(), true)) {
+    if (!searchReport(p, getPreviousMonday(), true)) {
         printf("\nError: Report not available. not found.");
     }
 
@@ -604,30 +3535,14 @@ int deleteHistory(Planner p){
         printf("\nError: planner does not exist.\n");
         return 0;
     }
-    if (freeList(&(p->completed)) == 1 && freeList(&(p->expired)) == 1) return 1;
-    return 0;
-}
-
-int deleteTask(Planner p){
-    if (p == NULL) {
-        printf("\nError: planner does not exist.\n");
-        return 0;
+    // the history is read only to be archived, so that the deletion can be undone
+    if (p->undo != NULL && archiveHistory(p)) {
+        beginAction(p->undo);
+        record(p, UNDO_HISTORY, NULL, NULL);
+    } else {
+        clearUndo(p->undo);
     }
-
-    char title[21], ans;
-    Task t;
-    do {
-        clearBuffer();
-        printf("\nEnter the title of the task to delete: ");
-        read(20, title);
-        t = getByPQTitle(p->inProgress, title);
-        
-        printf("\nThe selected task is: \n\n");
-        printTaskDetails(t);
-        printf("\n\nWould you pick an another task? (y/n) ");
-        scanf("%c", &ans);
-    } while (ans != 'n');
-
-    t = pop(p->inProgress, t);
-    freeTask(t);
+    int done = clearHistory(p);
+    commit(p);
+    return done;
 }
@@ -1,5 +1,9 @@
 // inclusion of functions for managing input/output and dates
 #include "../char/char.h"
+#include "../task/task.h"
+#include "../query/query.h"
+#include "../recurring/recurring.h"
+#include "../timelog/timelog.h"
 
 // Forward declaration of the planner struct
 typedef struct planner *Planner;
@@ -7,15 +11,90 @@ typedef struct planner *Planner;
 #define DEFAULT_TXT_FOLDER "Data"
 #endif
 
+// Results of the planner API: the ids and 1 are successes, the negative values errors
+#define PLANNER_ENOTFOUND -1
+#define PLANNER_EINVALID -2
+#define PLANNER_ENOMEM -3
+#define PLANNER_ECYCLE -4
+#define PLANNER_ERUNNING -5
+#define PLANNER_ESTOPPED -6
+#define PLANNER_EIO -7
+
+// Fields of a new task: strings of 1 to 20, 255 and 50 characters, the deadline
+// as ddmmyyyy and the priority as "low", "medium" or "high"
+struct taskFields {
+    const char *title;
+    const char *description;
+    const char *course;
+    int estimatedTime;
+    const char *deadline;
+    const char *priority;
+};
+
+// Fields changed by plannerUpdate
+#define PATCH_TITLE 0x01
+#define PATCH_DESCRIPTION 0x02
+#define PATCH_COURSE 0x04
+#define PATCH_TIME 0x08
+#define PATCH_DEADLINE 0x10
+#define PATCH_PRIORITY 0x20
+#define PATCH_COMPLETION 0x40
+
+// Changes of a task in progress: only the fields named in 'fields' (PATCH_*) are read
+struct taskPatch {
+    unsigned int fields;
+    const char *title;
+    const char *description;
+    const char *course;
+    int estimatedTime;
+    const char *deadline;
+    const char *priority;
+    float completion;
+};
+
 //planner prototypes
 Planner openPlanner(void);
 int closePlanner(Planner p);   
-int restoreExpiredTask(Planner p); 
-Planner modifyTask(Planner p);
 void printPlanner(Planner p);
-int insert(Planner p);
+int importTasks(Planner p);
+int exportPlanner(Planner p);
+int exportPlannerTo(Planner p, const char *base, int format);
 int weeklyReport (Planner p);
 int showTaskProgress (Planner p);
+int showCourseOverview(Planner p);
+int showStudyPlan(Planner p);
+int showDueTasks(Planner p);
 int deleteHistory(Planner p);
-int deleteTask(Planner p);
+
+// planner API: no input or output on the terminal
+int plannerAddTask(Planner p, const struct taskFields *f);
+int plannerUpdate(Planner p, int id, const struct taskPatch *patch);
+int plannerComplete(Planner p, int id, const char *date);
+int plannerDelete(Planner p, int id);
+int plannerRestore(Planner p, int id, const char *deadline, const char *priority);
+int plannerAddRecurring(Planner p, const struct taskFields *f, int every, const char *until);
+int plannerStopRecurring(Planner p, int id);
+int plannerGetRecurring(Planner p, struct recurrence **rules);
+int plannerAddPrerequisite(Planner p, int id, int prerequisite);
+int plannerRemovePrerequisite(Planner p, int id, int prerequisite);
+int plannerGetPrerequisites(Planner p, int id, const int **ids);
+int plannerReadyTasks(Planner p, Task *result, int max);
+int plannerAddMany(Planner p, const struct taskFields *f, int n, int *ids);
+int plannerCompleteMany(Planner p, const int *ids, int n, const char *date);
+int plannerDeleteMany(Planner p, const int *ids, int n);
+int plannerStartStudy(Planner p, int id);
+int plannerStopStudy(Planner p, int id, int *minutes);
+int plannerLogStudy(Planner p, int id, int minutes);
+int plannerStudyTime(Planner p, int id, struct taskTime *t);
+int plannerCourseTimes(Planner p, const struct courseTime **courses);
+int plannerUndo(Planner p);
+int plannerRedo(Planner p);
+int plannerFindTask(Planner p, const char *title);
+int plannerFindExpired(Planner p, const char *title);
+int plannerSuggestTitles(Planner p, const char *title, unsigned int states, Task *result, int max);
+Task plannerGetTask(Planner p, int id);
+int plannerQuery(Planner p, const struct taskQuery *q, Task **result);
+int plannerSearchText(Planner p, const char *text, Task **result);
+int plannerReport(Planner p, const char *monday, FILE *f);
+const char *plannerError(int code);
 
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "progress.h"
+
+// Progress of the tasks in progress, one array per field so that the kernel
+// reads and writes contiguous memory
+struct progressBatch {
+    Task *tasks;
+    int *start;             // start and deadline dates, in days (see dateToDays)
+    int *deadline;
+    float *completion;
+    float *timeProgress;    // percentage of the time between start and deadline already passed
+    float *gap;             // time progress minus completion: how much the task is behind
+    unsigned char *valid;   // 0 if the deadline precedes the start date
+    int *order;             // order in which the tasks are shown
+    int numel;
+    int tot;
+};
+
+// Task of the order being sorted, with its key
+struct delay {
+    float gap;
+    int index;
+};
+
+ProgressBatch newProgressBatch(void) {
+    return calloc(1, sizeof(struct progressBatch));
+}
+
+void freeProgressBatch(ProgressBatch b) {
+    if (b == NULL) return;
+    free(b->tasks);
+    free(b->start);
+    free(b->deadline);
+    free(b->completion);
+    free(b->timeProgress);
+    free(b->gap);
+    free(b->valid);
+    free(b->order);
+    free(b);
+}
+
+/* reserveBatch
+ * Syntax Specification:
+ * static bool reserveBatch(ProgressBatch b, int numel);
+ *
+ * Semantic Specification:
+ * Makes room for 'numel' tasks in every column.
+ *
+ * Preconditions:
+ * - 'b' must be valid.
+ *
+ * Postconditions:
+ * - Returns true if every column has room, false if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static bool reserveBatch(ProgressBatch b, int numel) {
+    if (numel <= b->tot) return true;
+
+    void *columns[8] = { b->tasks, b->start, b->deadline, b->completion, b->timeProgress, b->gap, b->valid, b->order };
+    size_t sizes[8] = { sizeof(Task), sizeof(int), sizeof(int), sizeof(float), sizeof(float), sizeof(float), 1, sizeof(int) };
+    bool ok = true;
+    for (int c = 0; c < 8; c++) {
+        void *column = realloc(columns[c], numel * sizes[c]);
+        if (column == NULL) ok = false;
+        else columns[c] = column;
+    }
+    b->tasks = columns[0];
+    b->start = columns[1];
+    b->deadline = columns[2];
+    b->completion = columns[3];
+    b->timeProgress = columns[4];
+    b->gap = columns[5];
+    b->valid = columns[6];
+    b->order = columns[7];
+    if (ok) b->tot = numel;
+    return ok;
+}
+
+/* gatherProgress
+ * Syntax Specification:
+ * int gatherProgress(ProgressBatch b, pQueue q);
+ *
+ * Semantic Specification:
+ * Copies the dates and the completion of the tasks in the queue into the columns
+ * of the batch, in the order of the queue.
+ *
+ * Preconditions:
+ * - 'b' and 'q' must be valid.
+ *
+ * Postconditions:
+ * - Returns the number of tasks, or -1 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+int gatherProgress(ProgressBatch b, pQueue q) {
+    int numel = getSize(q);
+    if (!reserveBatch(b, numel)) return -1;
+
+    for (int i = 0; i < numel; i++) {
+        Task t = getByIndex(q, i);
+        b->tasks[i] = t;
+        b->start[i] = dateToDays(getStartDate(t));
+        b->deadline[i] = dateToDays(getDeadline(t));
+        b->completion[i] = getCompletionPercentage(t);
+        b->order[i] = i;
+    }
+    b->numel = numel;
+    return numel;
+}
+
+/* progressKernel
+ * Syntax Specification:
+ * void progressKernel(int numel, const int *start, const int *deadline, const float *completion, int today,
+ *                     float *timeProgress, float *gap, unsigned char *valid);
+ *
+ * Semantic Specification:
+ * Computes for every task the time progress (100 if the deadline is the start
+ * date), how much it is behind schedule and whether its dates are valid. The
+ * loop has no branches and no calls, so the compiler turns it into SIMD code.
+ *
+ * Preconditions:
+ * - Every array must have 'numel' elements; the output arrays must not overlap the input.
+ *
+ * Postconditions:
+ * - 'timeProgress', 'gap' and 'valid' are filled.
+ *
+ * Side Effects:
+ * - None.
+ */
+void progressKernel(int numel, const int *restrict start, const int *restrict deadline,
+                    const float *restrict completion, int today,
+                    float *restrict timeProgress, float *restrict gap, unsigned char *restrict valid) {
+    for (int i = 0; i < numel; i++) {
+        int total = deadline[i] - start[i];
+        // selections are written as arithmetic on 0/1: the division is always done,
+        // on the divisor 1 when the deadline is not after the start date
+        int positive = total > 0;
+        float perc = (float)(today - start[i]) / (float)(total * positive + 1 - positive) * 100.0f;
+        perc = positive * perc + (1 - positive) * 100.0f;
+        timeProgress[i] = perc;
+        gap[i] = perc - completion[i];
+        valid[i] = total >= 0;
+    }
+}
+
+void computeProgress(ProgressBatch b) {
+    progressKernel(b->numel, b->start, b->deadline, b->completion, dateToDays(today),
+                   b->timeProgress, b->gap, b->valid);
+}
+
+/* compareDelays
+ * Syntax Specification:
+ * static int compareDelays(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Most behind first; on equal delay, the order of the queue.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to delays.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareDelays(const void *a, const void *b) {
+    const struct delay *x = a, *y = b;
+    if (x->gap != y->gap) return x->gap > y->gap ? -1 : 1;
+    return x->index - y->index;
+}
+
+/* sortByDelay
+ * Syntax Specification:
+ * int sortByDelay(ProgressBatch b);
+ *
+ * Semantic Specification:
+ * Orders the tasks from the most behind schedule, using the gaps already computed
+ * by computeProgress. The tasks with invalid dates are shown last.
+ *
+ * Preconditions:
+ * - 'b' must be valid, computeProgress must have been called.
+ *
+ * Postconditions:
+ * - Returns 1 if the order was changed, 0 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates temporary memory.
+ */
+int sortByDelay(ProgressBatch b) {
+    struct delay *delays = malloc((b->numel > 0 ? b->numel : 1) * sizeof(struct delay));
+    if (delays == NULL) return 0;
+
+    int n = 0, invalid = b->numel;
+    for (int i = 0; i < b->numel; i++) {
+        if (b->valid[i]) {
+            delays[n].gap = b->gap[i];
+            delays[n++].index = i;
+        } else {
+            b->order[--invalid] = i;
+        }
+    }
+    qsort(delays, n, sizeof(struct delay), compareDelays);
+    for (int i = 0; i < n; i++) b->order[i] = delays[i].index;
+    // the invalid tasks were stored from the end: put them back in queue order
+    for (int i = n, j = b->numel - 1; i < j; i++, j--) {
+        int temp = b->order[i];
+        b->order[i] = b->order[j];
+        b->order[j] = temp;
+    }
+    free(delays);
+    return 1;
+}
+
+int getProgressCount(ProgressBatch b) {
+    return b->numel;
+}
+
+/* getProgressEntry
+ * Syntax Specification:
+ * Task getProgressEntry(ProgressBatch b, int i, float *completion, float *timeProgress, bool *valid);
+ *
+ * Semantic Specification:
+ * Returns the i-th task in the order to show, with its completion and time progress.
+ *
+ * Preconditions:
+ * - 'b' must be valid, computeProgress must have been called, 0 <= i < getProgressCount(b).
+ *
+ * Postconditions:
+ * - Returns the task and fills the other parameters.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task getProgressEntry(ProgressBatch b, int i, float *completion, float *timeProgress, bool *valid) {
+    int k = b->order[i];
+    *completion = b->completion[k];
+    *timeProgress = b->timeProgress[k];
+    *valid = b->valid[k];
+    return b->tasks[k];
+}
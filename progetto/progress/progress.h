@@ -0,0 +1,18 @@
+#include <stdbool.h>
+#include "../pQueue/pQueue.h"
+
+// Forward declaration of the progress batch struct
+typedef struct progressBatch *ProgressBatch;
+
+ //progress prototypes
+ProgressBatch newProgressBatch(void);
+void freeProgressBatch(ProgressBatch b);
+
+int gatherProgress(ProgressBatch b, pQueue q);
+void progressKernel(int numel, const int *start, const int *deadline, const float *completion, int today,
+                    float *timeProgress, float *gap, unsigned char *valid);
+void computeProgress(ProgressBatch b);
+int sortByDelay(ProgressBatch b);
+
+int getProgressCount(ProgressBatch b);
+Task getProgressEntry(ProgressBatch b, int i, float *completion, float *timeProgress, bool *valid);
@@ -0,0 +1,651 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "query.h"
+
+// Keys with a hash index
+#define KEY_TITLE 0
+#define KEY_COURSE 1
+#define KEY_DEADLINE 2
+#define NUM_KEYS 3
+
+// Ways to find the candidates of a query
+#define PATH_ID 0
+#define PATH_TITLE 1
+#define PATH_COURSE 2
+#define PATH_DEADLINE 3
+#define PATH_SCAN 4
+
+// Cost of visiting a slot through a chain, in slots of a scan
+#define CHAIN_COST 4
+
+// Chains of the slots with the same hash of a key: the chains are linked through
+// the 'next' and 'prev' columns of the index, so that a slot is removed in O(1)
+struct chains {
+    int *head;                  // first slot of every bucket, -1 if empty
+    int *count;                 // slots in every bucket: an upper bound of the matches of a key
+    int size;                   // always a power of two, at least the number of slots
+};
+
+// Every task of the planner in one slot, with the fields of the queries in one
+// array per field so that a scan reads contiguous memory
+struct queryIndex {
+    Task *tasks;
+    int *ids;
+    unsigned char *state;       // collection: 0 progress, 1 completed, 2 expired
+    unsigned char *priority;
+    int *deadline;              // in days (see dateToDays)
+    float *completion;
+    unsigned int *hash[NUM_KEYS];
+    int *next[NUM_KEYS];
+    int *prev[NUM_KEYS];
+    int numel;
+    int tot;
+    struct chains keys[NUM_KEYS];
+    int *slotOf;                // slot of every id, -1 if not in the index
+    int numIds;
+    bool failed;                // a task could not be added: the index is incomplete
+};
+
+// Match of a query, with its sort key
+struct hit {
+    float key;
+    int id;
+    int slot;
+};
+
+QueryIndex newQueryIndex(void) {
+    return calloc(1, sizeof(struct queryIndex));
+}
+
+void freeQueryIndex(QueryIndex x) {
+    if (x == NULL) return;
+    free(x->tasks);
+    free(x->ids);
+    free(x->state);
+    free(x->priority);
+    free(x->deadline);
+    free(x->completion);
+    for (int k = 0; k < NUM_KEYS; k++) {
+        free(x->hash[k]);
+        free(x->next[k]);
+        free(x->prev[k]);
+        free(x->keys[k].head);
+        free(x->keys[k].count);
+    }
+    free(x->slotOf);
+    free(x);
+}
+
+// FNV-1a hash of a string, as for the courses of the analytics
+static unsigned int hashString(const char *s) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; s[i] != '\0'; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Consecutive days fall in different buckets
+static unsigned int hashDay(int day) {
+    return (unsigned int)day * 2654435761u;
+}
+
+/* reserveSlots
+ * Syntax Specification:
+ * static bool reserveSlots(QueryIndex x, int numel);
+ *
+ * Semantic Specification:
+ * Makes room for 'numel' slots in every column.
+ *
+ * Preconditions:
+ * - 'x' must be valid.
+ *
+ * Postconditions:
+ * - Returns true if every column has room, false if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static bool reserveSlots(QueryIndex x, int numel) {
+    if (numel <= x->tot) return true;
+
+    int tot = x->tot ? x->tot : 64;
+    while (tot < numel) tot *= 2;
+
+    void **columns[6 + 3 * NUM_KEYS] = { (void **)&x->tasks, (void **)&x->ids, (void **)&x->state,
+                                         (void **)&x->priority, (void **)&x->deadline, (void **)&x->completion };
+    size_t sizes[6 + 3 * NUM_KEYS] = { sizeof(Task), sizeof(int), 1, 1, sizeof(int), sizeof(float) };
+    for (int k = 0; k < NUM_KEYS; k++) {
+        columns[6 + 3 * k] = (void **)&x->hash[k];
+        columns[7 + 3 * k] = (void **)&x->next[k];
+        columns[8 + 3 * k] = (void **)&x->prev[k];
+        sizes[6 + 3 * k] = sizeof(unsigned int);
+        sizes[7 + 3 * k] = sizes[8 + 3 * k] = sizeof(int);
+    }
+    bool ok = true;
+    for (int c = 0; c < 6 + 3 * NUM_KEYS; c++) {
+        void *column = realloc(*columns[c], tot * sizes[c]);
+        if (column == NULL) ok = false;
+        else *columns[c] = column;
+    }
+    if (ok) x->tot = tot;
+    return ok;
+}
+
+/* link, unlink
+ * Syntax Specification:
+ * static void link(QueryIndex x, int k, int slot);
+ * static void unlink(QueryIndex x, int k, int slot);
+ *
+ * Semantic Specification:
+ * Add the slot to (or remove it from) the chain of its hash for the key 'k'. A
+ * slot is added at the head of the chain.
+ *
+ * Preconditions:
+ * - 'x' must be valid, the hash of the slot must be set and the chains allocated.
+ *
+ * Postconditions:
+ * - The slot is (or is no longer) in its chain, and the count of the bucket is updated.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void link(QueryIndex x, int k, int slot) {
+    struct chains *c = &x->keys[k];
+    int b = x->hash[k][slot] & (c->size - 1);
+    x->prev[k][slot] = -1;
+    x->next[k][slot] = c->head[b];
+    if (c->head[b] != -1) x->prev[k][c->head[b]] = slot;
+    c->head[b] = slot;
+    c->count[b]++;
+}
+
+static void unlink(QueryIndex x, int k, int slot) {
+    struct chains *c = &x->keys[k];
+    int b = x->hash[k][slot] & (c->size - 1);
+    int prev = x->prev[k][slot], next = x->next[k][slot];
+    if (prev != -1) x->next[k][prev] = next;
+        else c->head[b] = next;
+    if (next != -1) x->prev[k][next] = prev;
+    c->count[b]--;
+}
+
+/* growChains
+ * Syntax Specification:
+ * static bool growChains(QueryIndex x, int numel);
+ *
+ * Semantic Specification:
+ * Doubles the buckets of every key until there is one per slot, and links again
+ * the slots already in the index, so that the chains stay short.
+ *
+ * Preconditions:
+ * - 'x' must be valid.
+ *
+ * Postconditions:
+ * - Returns true if the buckets are enough for 'numel' slots, false if memory is
+ *   not available (the old buckets are kept).
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+static bool growChains(QueryIndex x, int numel) {
+    if (numel <= x->keys[0].size) return true;
+
+    int size = x->keys[0].size ? x->keys[0].size : 64;
+    while (size < numel) size *= 2;
+
+    // every key has the same number of buckets: all of them are allocated first
+    int *heads[NUM_KEYS], *counts[NUM_KEYS];
+    bool ok = true;
+    for (int k = 0; k < NUM_KEYS; k++) {
+        heads[k] = malloc(size * sizeof(int));
+        counts[k] = calloc(size, sizeof(int));
+        if (heads[k] == NULL || counts[k] == NULL) ok = false;
+    }
+    if (!ok) {
+        for (int k = 0; k < NUM_KEYS; k++) {
+            free(heads[k]);
+            free(counts[k]);
+        }
+        return false;
+    }
+
+    for (int k = 0; k < NUM_KEYS; k++) {
+        for (int b = 0; b < size; b++) heads[k][b] = -1;
+        free(x->keys[k].head);
+        free(x->keys[k].count);
+        x->keys[k].head = heads[k];
+        x->keys[k].count = counts[k];
+        x->keys[k].size = size;
+        for (int s = 0; s < x->numel; s++) link(x, k, s);
+    }
+    return true;
+}
+
+/* indexTask
+ * Syntax Specification:
+ * void indexTask(QueryIndex x, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Adds a task of the given collection (0 progress, 1 completed, 2 expired) to the
+ * index, copying the fields the queries read.
+ *
+ * Preconditions:
+ * - 't' must be valid and not in the index; 'x' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The task is found by the queries. If memory is not available the index is
+ *   marked as incomplete and runQuery fails.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+void indexTask(QueryIndex x, Task t, int collection) {
+    if (x == NULL || t == NULL) return;
+
+    int id = getId(t);
+    if (id < 0 || !reserveSlots(x, x->numel + 1) || !growChains(x, x->numel + 1)) {
+        x->failed = true;
+        return;
+    }
+    if (id >= x->numIds) {
+        int numIds = x->numIds ? x->numIds : 64;
+        while (numIds <= id) numIds *= 2;
+        int *slotOf = realloc(x->slotOf, numIds * sizeof(int));
+        if (slotOf == NULL) {
+            x->failed = true;
+            return;
+        }
+        for (int i = x->numIds; i < numIds; i++) slotOf[i] = -1;
+        x->slotOf = slotOf;
+        x->numIds = numIds;
+    }
+
+    int s = x->numel++;
+    x->tasks[s] = t;
+    x->ids[s] = id;
+    x->state[s] = collection;
+    x->priority[s] = getPriority(t);
+    x->deadline[s] = dateToDays(getDeadline(t));
+    x->completion[s] = getCompletionPercentage(t);
+    x->hash[KEY_TITLE][s] = hashString(getTitle(t));
+    x->hash[KEY_COURSE][s] = hashString(getCourse(t));
+    x->hash[KEY_DEADLINE][s] = hashDay(x->deadline[s]);
+    for (int k = 0; k < NUM_KEYS; k++) link(x, k, s);
+    x->slotOf[id] = s;
+}
+
+/* removeSlot
+ * Syntax Specification:
+ * static void removeSlot(QueryIndex x, int s);
+ *
+ * Semantic Specification:
+ * Removes a slot, moving the last slot in its place.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 0 <= s < numel.
+ *
+ * Postconditions:
+ * - The task of the slot is no longer in the index; the other tasks are.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void removeSlot(QueryIndex x, int s) {
+    for (int k = 0; k < NUM_KEYS; k++) unlink(x, k, s);
+    x->slotOf[x->ids[s]] = -1;
+
+    int last = --x->numel;
+    if (s == last) return;
+
+    x->tasks[s] = x->tasks[last];
+    x->ids[s] = x->ids[last];
+    x->state[s] = x->state[last];
+    x->priority[s] = x->priority[last];
+    x->deadline[s] = x->deadline[last];
+    x->completion[s] = x->completion[last];
+    for (int k = 0; k < NUM_KEYS; k++) {
+        int prev = x->prev[k][last], next = x->next[k][last];
+        x->hash[k][s] = x->hash[k][last];
+        x->prev[k][s] = prev;
+        x->next[k][s] = next;
+        if (prev != -1) x->next[k][prev] = s;
+            else x->keys[k].head[x->hash[k][s] & (x->keys[k].size - 1)] = s;
+        if (next != -1) x->prev[k][next] = s;
+    }
+    x->slotOf[x->ids[s]] = s;
+}
+
+/* unindexTask
+ * Syntax Specification:
+ * void unindexTask(QueryIndex x, Task t);
+ *
+ * Semantic Specification:
+ * Removes a task from the index. Together with indexTask it is called around every
+ * change of the task, so the index does not keep stale fields.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'x' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The task is no longer in the index.
+ *
+ * Side Effects:
+ * - None.
+ */
+void unindexTask(QueryIndex x, Task t) {
+    if (x == NULL || t == NULL) return;
+
+    int id = getId(t);
+    if (id < 0 || id >= x->numIds || x->slotOf[id] == -1) return;
+    if (x->tasks[x->slotOf[id]] != t) return;
+    removeSlot(x, x->slotOf[id]);
+}
+
+/* getIndexedTask
+ * Syntax Specification:
+ * Task getIndexedTask(QueryIndex x, int id);
+ *
+ * Semantic Specification:
+ * Returns the task with the given id, in any collection, in constant time.
+ *
+ * Preconditions:
+ * - 'x' must be valid.
+ *
+ * Postconditions:
+ * - Returns the task, or NULL if no task in the index has that id.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task getIndexedTask(QueryIndex x, int id) {
+    if (id < 0 || id >= x->numIds || x->slotOf[id] == -1) return NULL;
+    return x->tasks[x->slotOf[id]];
+}
+
+/* clearIndexHistory
+ * Syntax Specification:
+ * void clearIndexHistory(QueryIndex x);
+ *
+ * Semantic Specification:
+ * Removes the completed and expired tasks, after the history has been deleted.
+ *
+ * Preconditions:
+ * - 'x' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - Only the tasks in progress are left.
+ *
+ * Side Effects:
+ * - None.
+ */
+void clearIndexHistory(QueryIndex x) {
+    if (x == NULL) return;
+    // from the end, so that the slot moved in place of a removed one was already checked
+    for (int s = x->numel - 1; s >= 0; s--) {
+        if (x->state[s] != 0) removeSlot(x, s);
+    }
+}
+
+/* choosePath
+ * Syntax Specification:
+ * static int choosePath(QueryIndex x, const struct taskQuery *q, int from, int to);
+ *
+ * Semantic Specification:
+ * Chooses how to find the candidates of a query: the slot of the id, the chain of
+ * the title, of the course or of the days of the deadline range, or every slot.
+ * The number of slots of a chain is known from the count of its bucket without
+ * visiting it; since a chain jumps across the columns, each of its slots costs
+ * CHAIN_COST slots of a scan. The cheapest path is chosen.
+ *
+ * Preconditions:
+ * - 'x' and 'q' must be valid; 'from' and 'to' are the deadline range in days.
+ *
+ * Postconditions:
+ * - Returns one of the PATH_* values.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int choosePath(QueryIndex x, const struct taskQuery *q, int from, int to) {
+    if (q->filters & QUERY_ID) return PATH_ID;
+
+    int path = PATH_SCAN;
+    long cost = x->numel;
+    if (x->keys[0].size == 0) return path;
+
+    int mask = x->keys[0].size - 1;
+    if (q->filters & QUERY_TITLE) {
+        long c = (long)x->keys[KEY_TITLE].count[hashString(q->title) & mask] * CHAIN_COST;
+        if (c < cost) {
+            path = PATH_TITLE;
+            cost = c;
+        }
+    }
+    if (q->filters & QUERY_COURSE) {
+        long c = (long)x->keys[KEY_COURSE].count[hashString(q->course) & mask] * CHAIN_COST;
+        if (c < cost) {
+            path = PATH_COURSE;
+            cost = c;
+        }
+    }
+    if ((q->filters & QUERY_DEADLINE) && q->deadlineFrom != NULL && q->deadlineTo != NULL && (long)to - from + 1 < cost) {
+        // one probe per day, stopping as soon as the path is not the cheapest
+        long c = (long)to - from + 1;
+        for (int d = from; d <= to && c < cost; d++) c += (long)x->keys[KEY_DEADLINE].count[hashDay(d) & mask] * CHAIN_COST;
+        if (c < cost) {
+            path = PATH_DEADLINE;
+            cost = c;
+        }
+    }
+    return path;
+}
+
+/* matches
+ * Syntax Specification:
+ * static bool matches(QueryIndex x, const struct taskQuery *q, int s, const unsigned int *hashes, int from, int to);
+ *
+ * Semantic Specification:
+ * Checks every condition of the query on the columns of a slot. The strings are
+ * compared only when their hashes are equal.
+ *
+ * Preconditions:
+ * - 'x' and 'q' must be valid, 0 <= s < numel; 'hashes' holds the hashes of the
+ *   title and of the course of the query.
+ *
+ * Postconditions:
+ * - Returns true if the task of the slot satisfies the query.
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool matches(QueryIndex x, const struct taskQuery *q, int s, const unsigned int *hashes, int from, int to) {
+    unsigned int filters = q->filters;
+    if (q->states != 0 && !(q->states & (1u << x->state[s]))) return false;
+    if ((filters & QUERY_ID) && x->ids[s] != q->id) return false;
+    if ((filters & QUERY_PRIORITY) && (x->priority[s] < q->minPriority || x->priority[s] > q->maxPriority)) return false;
+    if ((filters & QUERY_DEADLINE) && (x->deadline[s] < from || x->deadline[s] > to)) return false;
+    if ((filters & QUERY_COMPLETION) && (x->completion[s] < q->minCompletion || x->completion[s] > q->maxCompletion))
+        return false;
+    if ((filters & QUERY_TITLE) && (x->hash[KEY_TITLE][s] != hashes[KEY_TITLE]
+                                    || strcmp(getTitle(x->tasks[s]), q->title) != 0)) return false;
+    if ((filters & QUERY_COURSE) && (x->hash[KEY_COURSE][s] != hashes[KEY_COURSE]
+                                     || strcmp(getCourse(x->tasks[s]), q->course) != 0)) return false;
+    return true;
+}
+
+/* compareHits
+ * Syntax Specification:
+ * static int compareHits(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Ascending order of the sort key; on equal key, the order of the ids.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to hits.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareHits(const void *a, const void *b) {
+    const struct hit *x = a, *y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/* selectFirst
+ * Syntax Specification:
+ * static void selectFirst(struct hit *hits, int numel, int k);
+ *
+ * Semantic Specification:
+ * Moves the first 'k' hits in the sort order to the front of the array, in any
+ * order, in linear time on average (quickselect), so that only they are sorted
+ * when the query has a limit.
+ *
+ * Preconditions:
+ * - 'hits' must have 'numel' distinct elements, 0 < k <= numel.
+ *
+ * Postconditions:
+ * - hits[0..k-1] are the first 'k' hits.
+ *
+ * Side Effects:
+ * - Reorders the array.
+ */
+static void selectFirst(struct hit *hits, int numel, int k) {
+    int lo = 0, hi = numel - 1;
+    while (lo < hi) {
+        struct hit pivot = hits[lo + (hi - lo) / 2];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (compareHits(&hits[i], &pivot) < 0) i++;
+            while (compareHits(&hits[j], &pivot) > 0) j--;
+            if (i <= j) {
+                struct hit temp = hits[i];
+                hits[i++] = hits[j];
+                hits[j--] = temp;
+            }
+        }
+        if (k - 1 <= j) hi = j;
+            else if (k - 1 >= i) lo = i;
+            else return;
+    }
+}
+
+/* addHit
+ * Syntax Specification:
+ * static bool addHit(QueryIndex x, const struct taskQuery *q, int s, struct hit **hits, int *numel, int *tot);
+ *
+ * Semantic Specification:
+ * Adds a matching slot to the hits, with the key of the order of the query.
+ *
+ * Preconditions:
+ * - 'x' and 'q' must be valid, 0 <= s < numel.
+ *
+ * Postconditions:
+ * - Returns true, or false if memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static bool addHit(QueryIndex x, const struct taskQuery *q, int s, struct hit **hits, int *numel, int *tot) {
+    if (*numel == *tot) {
+        int n = *tot ? *tot * 2 : 64;
+        struct hit *h = realloc(*hits, n * sizeof(struct hit));
+        if (h == NULL) return false;
+        *hits = h;
+        *tot = n;
+    }
+    float key = 0;
+    if (q->sort == QUERY_SORT_DEADLINE) key = x->deadline[s];
+        else if (q->sort == QUERY_SORT_PRIORITY) key = x->priority[s];
+        else if (q->sort == QUERY_SORT_COMPLETION) key = x->completion[s];
+    struct hit *h = &(*hits)[(*numel)++];
+    h->key = q->descending ? -key : key;
+    h->id = x->ids[s];
+    h->slot = s;
+    return true;
+}
+
+/* runQuery
+ * Syntax Specification:
+ * int runQuery(QueryIndex x, const struct taskQuery *q, Task **result);
+ *
+ * Semantic Specification:
+ * Returns the tasks satisfying the query, in the order and up to the limit it
+ * asks for. The candidates come from the cheapest path (see choosePath) and every
+ * condition is checked on them; with a limit, only the tasks returned are sorted.
+ *
+ * Preconditions:
+ * - 'x' and 'q' must be valid; the dates of the query, if any, must be ddmmyyyy.
+ *
+ * Postconditions:
+ * - '*result' is an array allocated for the caller (NULL if there are no tasks),
+ *   whose tasks are owned by the planner.
+ * - Returns the number of tasks, or -1 if memory is not available or the index
+ *   is incomplete.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+int runQuery(QueryIndex x, const struct taskQuery *q, Task **result) {
+    *result = NULL;
+    if (x->failed) return -1;
+
+    int from = (q->deadlineFrom != NULL) ? dateToDays(q->deadlineFrom) : -2147483647 - 1;
+    int to = (q->deadlineTo != NULL) ? dateToDays(q->deadlineTo) : 2147483647;
+    unsigned int hashes[NUM_KEYS] = { 0 };
+    if (q->filters & QUERY_TITLE) hashes[KEY_TITLE] = hashString(q->title);
+    if (q->filters & QUERY_COURSE) hashes[KEY_COURSE] = hashString(q->course);
+
+    struct hit *hits = NULL;
+    int numel = 0, tot = 0;
+    bool ok = true;
+    int path = choosePath(x, q, from, to);
+    if (path == PATH_ID) {
+        int s = (q->id >= 0 && q->id < x->numIds) ? x->slotOf[q->id] : -1;
+        if (s != -1 && matches(x, q, s, hashes, from, to)) ok = addHit(x, q, s, &hits, &numel, &tot);
+    } else if (path == PATH_SCAN) {
+        for (int s = 0; s < x->numel && ok; s++) {
+            if (matches(x, q, s, hashes, from, to)) ok = addHit(x, q, s, &hits, &numel, &tot);
+        }
+    } else {
+        int k = (path == PATH_TITLE) ? KEY_TITLE : (path == PATH_COURSE) ? KEY_COURSE : KEY_DEADLINE;
+        int mask = x->keys[k].size - 1;
+        // the days of the range, or the only hash of the title or of the course
+        int first = (k == KEY_DEADLINE) ? from : 0, last = (k == KEY_DEADLINE) ? to : 0;
+        for (int d = first; d <= last && ok; d++) {
+            unsigned int h = (k == KEY_DEADLINE) ? hashDay(d) : hashes[k];
+            for (int s = x->keys[k].head[h & mask]; s != -1 && ok; s = x->next[k][s]) {
+                // chains are shared by the keys with the same bucket
+                if (x->hash[k][s] != h || (k == KEY_DEADLINE && x->deadline[s] != d)) continue;
+                if (matches(x, q, s, hashes, from, to)) ok = addHit(x, q, s, &hits, &numel, &tot);
+            }
+        }
+    }
+    if (!ok) {
+        free(hits);
+        return -1;
+    }
+
+    int count = (q->limit > 0 && q->limit < numel) ? q->limit : numel;
+    if (count < numel) selectFirst(hits, numel, count);
+    qsort(hits, count, sizeof(struct hit), compareHits);
+
+    if (count > 0) {
+        *result = malloc(count * sizeof(Task));
+        if (*result == NULL) {
+            free(hits);
+            return -1;
+        }
+        for (int i = 0; i < count; i++) (*result)[i] = x->tasks[hits[i].slot];
+    }
+    free(hits);
+    return count;
+}
@@ -0,0 +1,54 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Collections searched by a query, same indexes as the planner
+#define QUERY_PROGRESS (1 << 0)
+#define QUERY_COMPLETED (1 << 1)
+#define QUERY_EXPIRED (1 << 2)
+
+// Conditions of a query
+#define QUERY_ID 0x01
+#define QUERY_TITLE 0x02
+#define QUERY_COURSE 0x04
+#define QUERY_PRIORITY 0x08
+#define QUERY_DEADLINE 0x10
+#define QUERY_COMPLETION 0x20
+
+// Orders of the result
+#define QUERY_SORT_NONE 0
+#define QUERY_SORT_DEADLINE 1
+#define QUERY_SORT_PRIORITY 2
+#define QUERY_SORT_COMPLETION 3
+
+// Query over the tasks: only the conditions named in 'filters' (QUERY_*) are
+// read, and all of them must hold
+struct taskQuery {
+    unsigned int filters;
+    unsigned int states;        // QUERY_PROGRESS, QUERY_COMPLETED, QUERY_EXPIRED; 0 for all
+    int id;
+    const char *title;
+    const char *course;
+    int minPriority;            // 1 low, 2 medium, 3 high
+    int maxPriority;
+    const char *deadlineFrom;   // ddmmyyyy, NULL for no bound
+    const char *deadlineTo;
+    float minCompletion;
+    float maxCompletion;
+    int sort;                   // QUERY_SORT_*, ties in id order
+    bool descending;
+    int limit;                  // 0 for no limit
+};
+
+// Forward declaration of the query index struct
+typedef struct queryIndex *QueryIndex;
+
+ //query prototypes
+QueryIndex newQueryIndex(void);
+void freeQueryIndex(QueryIndex x);
+
+void indexTask(QueryIndex x, Task t, int collection);
+void unindexTask(QueryIndex x, Task t);
+void clearIndexHistory(QueryIndex x);
+Task getIndexedTask(QueryIndex x, int id);
+
+int runQuery(QueryIndex x, const struct taskQuery *q, Task **result);
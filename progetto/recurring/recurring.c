@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "../crc/crc.h"
+#include "recurring.h"
+
+#define HEADER_FORMAT "#PRT\t%d\t%010d\t%010d\t%08x\n"
+#define RECURRING_MAX_LINE 512
+#define RECURRING_FIELDS 9
+
+struct recurring {
+    struct recurrence *rules;   // in order of id
+    int numel;
+    int tot;
+    int lastId;                 // ids are never reused
+};
+
+Recurring newRecurring(void) {
+    return calloc(1, sizeof(struct recurring));
+}
+
+void freeRecurring(Recurring r) {
+    if (r == NULL) return;
+    free(r->rules);
+    free(r);
+}
+
+/* addRecurrence
+ * Syntax Specification:
+ * int addRecurrence(Recurring r, const struct recurrence *rec);
+ *
+ * Semantic Specification:
+ * Adds a definition; if its id is 0 a new one is assigned.
+ *
+ * Preconditions:
+ * - 'r' must be valid, 'rec' a checked definition.
+ *
+ * Postconditions:
+ * - Returns the id of the definition, or -1 if memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+int addRecurrence(Recurring r, const struct recurrence *rec) {
+    if (r->numel == r->tot) {
+        int tot = r->tot ? r->tot * 2 : 8;
+        struct recurrence *rules = realloc(r->rules, tot * sizeof(struct recurrence));
+        if (rules == NULL) return -1;
+        r->rules = rules;
+        r->tot = tot;
+    }
+    struct recurrence *added = &r->rules[r->numel++];
+    *added = *rec;
+    if (added->id <= 0) added->id = r->lastId + 1;
+    if (added->id > r->lastId) r->lastId = added->id;
+    return added->id;
+}
+
+bool removeRecurrence(Recurring r, int id) {
+    for (int i = 0; i < r->numel; i++) {
+        if (r->rules[i].id != id) continue;
+        memmove(&r->rules[i], &r->rules[i + 1], (r->numel - i - 1) * sizeof(struct recurrence));
+        r->numel--;
+        return true;
+    }
+    return false;
+}
+
+// Definitions in order of id, owned by 'r' and valid until the next change
+int getRecurrences(Recurring r, struct recurrence **rules) {
+    *rules = r->rules;
+    return r->numel;
+}
+
+// Removes the definitions whose occurrences have all been added, returns how many
+int dropFinished(Recurring r) {
+    int kept = 0;
+    for (int i = 0; i < r->numel; i++) {
+        if (r->rules[i].next <= r->rules[i].until) r->rules[kept++] = r->rules[i];
+    }
+    int dropped = r->numel - kept;
+    r->numel = kept;
+    return dropped;
+}
+
+// First occurrence not added yet with a deadline from 'first' on
+static int firstFrom(const struct recurrence *rec, int first) {
+    if (rec->next >= first) return rec->next;
+    return rec->next + (first - rec->next + rec->every - 1) / rec->every * rec->every;
+}
+
+/* countOccurrences, getOccurrences, skipOccurrences
+ * Syntax Specification:
+ * int countOccurrences(const struct recurrence *rec, int first, int last);
+ * int getOccurrences(const struct recurrence *rec, int first, int last, int *days);
+ * void skipOccurrences(struct recurrence *rec, int first, int last);
+ *
+ * Semantic Specification:
+ * Count, or list, the occurrences not added yet with a deadline from day 'first'
+ * to day 'last'. The occurrences before 'first' (missed while the planner was
+ * closed) are skipped. getOccurrences writes their deadlines in 'days';
+ * skipOccurrences moves the next occurrence after 'last', once they were added.
+ * All are computed, not visited.
+ *
+ * Preconditions:
+ * - 'rec' must be valid, 'days' must have room for countOccurrences(rec, first, last) days.
+ *
+ * Postconditions:
+ * - countOccurrences and getOccurrences return the number of occurrences.
+ *
+ * Side Effects:
+ * - skipOccurrences changes rec->next.
+ */
+int countOccurrences(const struct recurrence *rec, int first, int last) {
+    int start = firstFrom(rec, first), end = (last < rec->until) ? last : rec->until;
+    return (start > end) ? 0 : (end - start) / rec->every + 1;
+}
+
+int getOccurrences(const struct recurrence *rec, int first, int last, int *days) {
+    int numel = countOccurrences(rec, first, last), start = firstFrom(rec, first);
+    for (int i = 0; i < numel; i++) days[i] = start + i * rec->every;
+    return numel;
+}
+
+void skipOccurrences(struct recurrence *rec, int first, int last) {
+    rec->next = firstFrom(rec, first) + countOccurrences(rec, first, last) * rec->every;
+}
+
+/* saveRecurring
+ * Syntax Specification:
+ * bool saveRecurring(Recurring r, const char *path);
+ *
+ * Semantic Specification:
+ * Writes the definitions on file (see recurring.h); the header is written last,
+ * with the checksum of the records.
+ *
+ * Preconditions:
+ * - 'r' must be valid, 'path' a writable path.
+ *
+ * Postconditions:
+ * - Returns true if the file was written.
+ *
+ * Side Effects:
+ * - Writes to file.
+ */
+bool saveRecurring(Recurring r, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return false;
+
+    bool ok = fprintf(f, HEADER_FORMAT, RECURRING_VERSION, 0, 0, 0u) > 0;
+    unsigned int crc = 0;
+    for (int i = 0; i < r->numel && ok; i++) {
+        const struct recurrence *rec = &r->rules[i];
+        char line[RECURRING_MAX_LINE], next[9], until[9];
+        daysToDate(rec->next, next);
+        daysToDate(rec->until, until);
+        int len = snprintf(line, sizeof(line), "%d\t%s\t%s\t%s\t%d\t%s\t%d\t%s\t%s", rec->id, rec->title,
+                           rec->description, rec->course, rec->estimatedTime, rec->priority, rec->every, next, until);
+        crc = crc32c(crc, line, len);
+        ok = fprintf(f, "%s\n", line) > 0;
+    }
+    if (ok) ok = fseek(f, 0, SEEK_SET) == 0 && fprintf(f, HEADER_FORMAT, RECURRING_VERSION, r->numel, r->lastId, crc) > 0;
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+// Date of the file, ddmmyyyy (past dates allowed), in days
+static bool readDay(const char *date, int *day) {
+    if (strlen(date) != 8 || !isOnlyDigits(date, 8)) return false;
+    *day = dateToDays(date);
+    return true;
+}
+
+/* parseRecord
+ * Syntax Specification:
+ * static bool parseRecord(char *line, struct recurrence *rec);
+ *
+ * Semantic Specification:
+ * Reads a record of the file; empty fields (e.g. the description) are allowed.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated line without terminators; it is split in place.
+ *
+ * Postconditions:
+ * - Returns true if every field is valid.
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool parseRecord(char *line, struct recurrence *rec) {
+    char *fields[RECURRING_FIELDS];
+    int n = 0;
+    fields[n++] = line;
+    for (char *c = line; *c != '\0'; c++) {
+        if (*c != '\t') continue;
+        if (n == RECURRING_FIELDS) return false;
+        *c = '\0';
+        fields[n++] = c + 1;
+    }
+    if (n != RECURRING_FIELDS || strlen(fields[1]) > 20 || strlen(fields[2]) > 255 || strlen(fields[3]) > 50) return false;
+    if (strcmp(fields[5], "low") != 0 && strcmp(fields[5], "medium") != 0 && strcmp(fields[5], "high") != 0) return false;
+
+    memset(rec, 0, sizeof(struct recurrence));
+    rec->id = atoi(fields[0]);
+    strcpy(rec->title, fields[1]);
+    strcpy(rec->description, fields[2]);
+    strcpy(rec->course, fields[3]);
+    rec->estimatedTime = atoi(fields[4]);
+    strcpy(rec->priority, fields[5]);
+    rec->every = atoi(fields[6]);
+    return rec->id > 0 && rec->estimatedTime >= 0 && rec->every > 0 &&
+           readDay(fields[7], &rec->next) && readDay(fields[8], &rec->until);
+}
+
+/* loadRecurring
+ * Syntax Specification:
+ * Recurring loadRecurring(const char *path);
+ *
+ * Semantic Specification:
+ * Reads the definitions written by saveRecurring. A missing file means no
+ * definitions; the records of a damaged file that can still be read are kept,
+ * and a warning is printed.
+ *
+ * Preconditions:
+ * - 'path' must be a valid path.
+ *
+ * Postconditions:
+ * - Returns the definitions, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+Recurring loadRecurring(const char *path) {
+    Recurring r = newRecurring();
+    if (r == NULL) return NULL;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return r;
+
+    char line[RECURRING_MAX_LINE];
+    int version, count = -1, lastId = 0;
+    unsigned int crc = 0, computed = 0;
+    bool ok = fgets(line, sizeof(line), f) != NULL &&
+              sscanf(line, "#PRT\t%d\t%d\t%d\t%x", &version, &count, &lastId, &crc) == 4 && version == RECURRING_VERSION;
+    // a damaged record is skipped, the others are still read
+    while (fgets(line, sizeof(line), f) != NULL) {
+        int len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        computed = crc32c(computed, line, len);
+
+        struct recurrence rec;
+        if (!parseRecord(line, &rec)) {
+            ok = false;
+        } else if (addRecurrence(r, &rec) < 0) {
+            fclose(f);
+            freeRecurring(r);
+            return NULL;
+        }
+    }
+    fclose(f);
+
+    if (lastId > r->lastId) r->lastId = lastId;
+    if (!ok || r->numel != count || computed != crc) {
+        fprintf(stderr, "\nWarning: the file of the recurring tasks is damaged, %d definitions were read.\n", r->numel);
+    }
+    return r;
+}
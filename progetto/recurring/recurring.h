@@ -0,0 +1,41 @@
+#include <stdbool.h>
+
+// Recurring tasks: one definition is stored for every series, and its occurrences
+// become tasks in progress only when their deadline enters the look-ahead window
+// of the planner, so nothing grows with the number of future occurrences.
+// Layout of the file:
+//   #PRT <version> <count> <last id> <CRC32C of the records>
+//   one record per line: id title description course time priority every next until
+// with the fields separated by tabs and the dates as ddmmyyyy.
+#define RECURRING_VERSION 1
+
+// Definition of a series of tasks
+struct recurrence {
+    int id;
+    char title[21];
+    char description[256];
+    char course[51];
+    int estimatedTime;
+    char priority[7];           // "low", "medium" or "high"
+    int every;                  // days between two occurrences
+    int next;                   // deadline of the next occurrence not added yet, in days (see dateToDays)
+    int until;                  // deadline of the last occurrence, in days
+};
+
+// Forward declaration of the recurring struct
+typedef struct recurring *Recurring;
+
+ //recurring prototypes
+Recurring newRecurring(void);
+void freeRecurring(Recurring r);
+Recurring loadRecurring(const char *path);
+bool saveRecurring(Recurring r, const char *path);
+
+int addRecurrence(Recurring r, const struct recurrence *rec);
+bool removeRecurrence(Recurring r, int id);
+int getRecurrences(Recurring r, struct recurrence **rules);
+int dropFinished(Recurring r);
+
+int countOccurrences(const struct recurrence *rec, int first, int last);
+int getOccurrences(const struct recurrence *rec, int first, int last, int *days);
+void skipOccurrences(struct recurrence *rec, int first, int last);
@@ -0,0 +1,682 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "report.h"
+#include "../char/char.h"
+#include "../codec/codec.h"
+
+// Years probed for sealed segments when the index has to be rebuilt
+#define OLDEST_SEGMENT_YEAR 2000
+
+// Text shared by every report: compressed blocks may refer to it
+static const char reportDictionary[] =
+    "\n$\n\n\t      --- Weekly Report ---\n\n\n+ Completed tasks:\n"
+    "* There are no completed task\n\n+ Tasks in progress:\n"
+    "* There are no in progress task\n\n+ Expired tasks:\n"
+    "* There are no expired task\n\n\t      ---------------------\n\n$\n"
+    ") Completed on: ) Deadline: ) Expired on: ) ! Due today !\n";
+
+// Position of one weekly report: in the current plain segment (segment 0),
+// or compressed in the sealed segment of a year
+struct entry {
+    char date[9];
+    int segment;
+    long offset;
+    long length;
+    long rawLength;
+};
+
+struct reportIndex {
+    const char *reportPath;
+    const char *indexPath;
+    int currentYear; // year of the reports in the current segment, 0 if empty
+    struct entry *entries;
+    int numel;
+    int tot;
+    int *table;     // open addressing hash table of positions in 'entries', -1 if free
+    int tableSize;  // always a power of two, at least twice 'numel'
+};
+
+/* hashDate
+ * Syntax Specification:
+ * static unsigned int hashDate(const char *date);
+ *
+ * Semantic Specification:
+ * Computes the FNV-1a hash of a "ddmmyyyy" date.
+ *
+ * Preconditions:
+ * - 'date' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns the hash value.
+ *
+ * Side Effects:
+ * - None.
+ */
+static unsigned int hashDate(const char *date) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; date[i] != '\0'; i++) {
+        h ^= (unsigned char)date[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* findSlot
+ * Syntax Specification:
+ * static int findSlot(ReportIndex r, const char *date);
+ *
+ * Semantic Specification:
+ * Returns the slot of the hash table holding 'date', or the free slot where it would go.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index with at least one free slot.
+ *
+ * Postconditions:
+ * - Returns a slot index in [0, tableSize).
+ *
+ * Side Effects:
+ * - None.
+ */
+static int findSlot(ReportIndex r, const char *date) {
+    int slot = hashDate(date) & (r->tableSize - 1);
+    while (r->table[slot] != -1 && strcmp(r->entries[r->table[slot]].date, date) != 0) {
+        slot = (slot + 1) & (r->tableSize - 1);
+    }
+    return slot;
+}
+
+/* growTable
+ * Syntax Specification:
+ * static int growTable(ReportIndex r);
+ *
+ * Semantic Specification:
+ * Doubles the hash table and reinserts every entry.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index.
+ *
+ * Postconditions:
+ * - Returns 1 on success, 0 if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates and frees memory.
+ */
+static int growTable(ReportIndex r) {
+    int *old = r->table;
+    r->tableSize *= 2;
+    r->table = malloc(r->tableSize * sizeof(int));
+    if (r->table == NULL) {
+        r->table = old;
+        r->tableSize /= 2;
+        return 0;
+    }
+    for (int i = 0; i < r->tableSize; i++) r->table[i] = -1;
+    for (int i = 0; i < r->numel; i++) r->table[findSlot(r, r->entries[i].date)] = i;
+    free(old);
+    return 1;
+}
+
+/* insertEntry
+ * Syntax Specification:
+ * static int insertEntry(ReportIndex r, const char *date, int segment, long offset, long length, long rawLength);
+ *
+ * Semantic Specification:
+ * Adds a report position to the in-memory index; a newer report for the same date replaces the old one.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index, 'date' a "ddmmyyyy" string.
+ *
+ * Postconditions:
+ * - Returns 1 on success, 0 if memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static int insertEntry(ReportIndex r, const char *date, int segment, long offset, long length, long rawLength) {
+    int slot = findSlot(r, date);
+    if (segment == 0 && r->currentYear == 0) r->currentYear = atoi(date + 4);
+    if (r->table[slot] != -1) {
+        struct entry *e = &r->entries[r->table[slot]];
+        e->segment = segment;
+        e->offset = offset;
+        e->length = length;
+        e->rawLength = rawLength;
+        return 1;
+    }
+
+    if (r->numel == r->tot) {
+        r->tot *= 2;
+        struct entry *temp = realloc(r->entries, r->tot * sizeof(struct entry));
+        if (temp == NULL) {
+            r->tot /= 2;
+            return 0;
+        }
+        r->entries = temp;
+    }
+
+    struct entry *e = &r->entries[r->numel];
+    strncpy(e->date, date, 8);
+    e->date[8] = '\0';
+    e->segment = segment;
+    e->offset = offset;
+    e->length = length;
+    e->rawLength = rawLength;
+    r->table[slot] = r->numel++;
+
+    if (r->numel * 2 > r->tableSize) return growTable(r);
+    return 1;
+}
+
+// Replaces 'path' with 'temp'; rename does not replace an existing file on Windows
+static bool replaceFile(const char *temp, const char *path) {
+    if (rename(temp, path) == 0) return true;
+    remove(path);
+    return rename(temp, path) == 0;
+}
+
+/* writeIndex
+ * Syntax Specification:
+ * static int writeIndex(ReportIndex r);
+ *
+ * Semantic Specification:
+ * Rewrites the index file with all the entries in memory. The entries are
+ * written to a temporary file that replaces the index only when it is complete.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index.
+ *
+ * Postconditions:
+ * - Returns 1 if the file was written, 0 otherwise (the old index is kept).
+ *
+ * Side Effects:
+ * - Writes to a file.
+ */
+static int writeIndex(ReportIndex r) {
+    char temp[260];
+    snprintf(temp, sizeof(temp), "%s.tmp", r->indexPath);
+    FILE *f = fopen(temp, "w");
+    if (f == NULL) {
+        fprintf(stderr, "\nError: Unable to write the report index.\n");
+        return 0;
+    }
+    for (int i = 0; i < r->numel; i++) {
+        struct entry *e = &r->entries[i];
+        fprintf(f, "%s\t%d\t%ld\t%ld\t%ld\n", e->date, e->segment, e->offset, e->length, e->rawLength);
+    }
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+    if (!ok || !replaceFile(temp, r->indexPath)) {
+        remove(temp);
+        fprintf(stderr, "\nError: Unable to write the report index.\n");
+        return 0;
+    }
+    return 1;
+}
+
+/* segmentPath
+ * Syntax Specification:
+ * static void segmentPath(ReportIndex r, int year, char *path, int size);
+ *
+ * Semantic Specification:
+ * Builds the name of the sealed segment of a year, next to the report file
+ * (e.g. "./Data/report.txt" -> "./Data/report_2024.lz").
+ *
+ * Preconditions:
+ * - 'path' must have 'size' bytes of space.
+ *
+ * Postconditions:
+ * - 'path' contains the segment file name.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void segmentPath(ReportIndex r, int year, char *path, int size) {
+    const char *dot = strrchr(r->reportPath, '.');
+    int prefix = (dot != NULL && dot != r->reportPath) ? dot - r->reportPath : (int)strlen(r->reportPath);
+    snprintf(path, size, "%.*s_%d.lz", prefix, r->reportPath, year);
+}
+
+/* scanSegment
+ * Syntax Specification:
+ * static void scanSegment(ReportIndex r, int year);
+ *
+ * Semantic Specification:
+ * Indexes the blocks of a sealed segment reading only their headers
+ * ("date rawLength length" lines, each followed by the compressed block).
+ *
+ * Preconditions:
+ * - 'r' must be a valid index.
+ *
+ * Postconditions:
+ * - Every block of the segment is in the index; nothing happens if the segment does not exist.
+ *
+ * Side Effects:
+ * - Reads from file.
+ */
+static void scanSegment(ReportIndex r, int year) {
+    char path[256], line[64], date[9];
+    segmentPath(r, year, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return;
+
+    long rawLength, length;
+    while (fgets(line, sizeof(line), f) && sscanf(line, "%8s %ld %ld", date, &rawLength, &length) == 3) {
+        insertEntry(r, date, year, ftell(f), length, rawLength);
+        if (fseek(f, length, SEEK_CUR) != 0) break;
+    }
+    fclose(f);
+}
+
+/* rebuildIndex
+ * Syntax Specification:
+ * static void rebuildIndex(ReportIndex r);
+ *
+ * Semantic Specification:
+ * Reads the block headers of the sealed segments, then scans the current report
+ * file once, indexing every block that starts with a date line and ends at its
+ * second '$' line, and saves the index file.
+ *
+ * Preconditions:
+ * - 'r' must be a valid, empty index.
+ *
+ * Postconditions:
+ * - The index describes every report in the file.
+ *
+ * Side Effects:
+ * - Reads the report file, writes the index file.
+ */
+static void rebuildIndex(ReportIndex r) {
+    int lastYear = (today != NULL) ? atoi(today + 4) : 0;
+    for (int year = OLDEST_SEGMENT_YEAR; year <= lastYear; year++) scanSegment(r, year);
+
+    FILE *f = fopen(r->reportPath, "rb");
+    if (f == NULL) {
+        writeIndex(r);
+        return;
+    }
+
+    char line[512], date[9];
+    long pos = 0, start = -1;
+    int dollars = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        long next = ftell(f);
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (start < 0) {
+            if (strlen(line) == 8 && isOnlyDigits(line, 8)) {
+                strcpy(date, line);
+                start = pos;
+                dollars = 0;
+            }
+        } else if (line[0] == '$' && ++dollars == 2) {
+            insertEntry(r, date, 0, start, next - start, next - start);
+            start = -1;
+        }
+        pos = next;
+    }
+    fclose(f);
+    writeIndex(r);
+}
+
+/* openReportIndex
+ * Syntax Specification:
+ * ReportIndex openReportIndex(const char *reportPath, const char *indexPath);
+ *
+ * Semantic Specification:
+ * Loads the sidecar index mapping each report date to its offset and length in
+ * the report file. The index is rebuilt from the report file when it is missing
+ * or does not cover the whole file.
+ *
+ * Preconditions:
+ * - 'reportPath' and 'indexPath' must be valid paths that outlive the index.
+ *
+ * Postconditions:
+ * - Returns a valid ReportIndex, or NULL in case of memory errors.
+ *
+ * Side Effects:
+ * - Reads files, may rewrite the index file.
+ * - Allocates memory.
+ */
+ReportIndex openReportIndex(const char *reportPath, const char *indexPath) {
+    ReportIndex r = malloc(sizeof(struct reportIndex));
+    if (r == NULL) return NULL;
+
+    r->reportPath = reportPath;
+    r->indexPath = indexPath;
+    r->currentYear = 0;
+    r->numel = 0;
+    r->tot = 16;
+    r->tableSize = 32;
+    r->entries = malloc(r->tot * sizeof(struct entry));
+    r->table = malloc(r->tableSize * sizeof(int));
+    if (r->entries == NULL || r->table == NULL) {
+        freeReportIndex(r);
+        return NULL;
+    }
+    for (int i = 0; i < r->tableSize; i++) r->table[i] = -1;
+
+    long indexed = 0, size = 0;
+    FILE *f = fopen(indexPath, "r");
+    if (f != NULL) {
+        char line[128], date[9];
+        int segment;
+        long offset, length, rawLength;
+        while (fgets(line, sizeof(line), f)) {
+            // the lines of an older layout are skipped: the index is then rebuilt from the report
+            if (sscanf(line, "%8s\t%d\t%ld\t%ld\t%ld", date, &segment, &offset, &length, &rawLength) != 5) continue;
+            insertEntry(r, date, segment, offset, length, rawLength);
+            if (segment == 0 && offset + length > indexed) indexed = offset + length;
+        }
+        fclose(f);
+    }
+
+    FILE *report = fopen(reportPath, "rb");
+    if (report != NULL) {
+        fseek(report, 0, SEEK_END);
+        size = ftell(report);
+        fclose(report);
+    }
+
+    // reports appended without updating the index (or a lost index): scan once
+    if (f == NULL || indexed < size) {
+        r->numel = 0;
+        r->currentYear = 0;
+        for (int i = 0; i < r->tableSize; i++) r->table[i] = -1;
+        rebuildIndex(r);
+    }
+    return r;
+}
+
+/* freeReportIndex
+ * Syntax Specification:
+ * void freeReportIndex(ReportIndex r);
+ *
+ * Semantic Specification:
+ * Deallocates the index.
+ *
+ * Preconditions:
+ * - 'r' can be NULL or a valid index.
+ *
+ * Postconditions:
+ * - All the memory of the index is freed.
+ *
+ * Side Effects:
+ * - Frees memory.
+ */
+void freeReportIndex(ReportIndex r) {
+    if (r == NULL) return;
+    free(r->entries);
+    free(r->table);
+    free(r);
+}
+
+/* hasReport
+ * Syntax Specification:
+ * bool hasReport(ReportIndex r, const char *date);
+ *
+ * Semantic Specification:
+ * Checks in constant time whether a report generated on 'date' exists.
+ *
+ * Preconditions:
+ * - 'date' must be a "ddmmyyyy" string.
+ *
+ * Postconditions:
+ * - Returns true if the report is in the index.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool hasReport(ReportIndex r, const char *date) {
+    if (r == NULL || date == NULL) return false;
+    return r->table[findSlot(r, date)] != -1;
+}
+
+/* getLastReportDate
+ * Syntax Specification:
+ * bool getLastReportDate(ReportIndex r, char *date);
+ *
+ * Semantic Specification:
+ * Finds the most recent report of the archive, sealed segments included.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index, 'date' must have space for 9 characters.
+ *
+ * Postconditions:
+ * - Returns false if there are no reports; otherwise 'date' is the newest date.
+ *
+ * Side Effects:
+ * - None.
+ */
+bool getLastReportDate(ReportIndex r, char *date) {
+    int last = -1, lastDays = 0;
+    for (int i = 0; i < r->numel; i++) {
+        int days = dateToDays(r->entries[i].date);
+        if (last == -1 || days > lastDays) {
+            last = i;
+            lastDays = days;
+        }
+    }
+    if (last == -1) return false;
+    strcpy(date, r->entries[last].date);
+    return true;
+}
+
+/* addReport
+ * Syntax Specification:
+ * int addReport(ReportIndex r, const char *date, long offset, long length);
+ *
+ * Semantic Specification:
+ * Records a report just appended to the report file, both in memory and in the index file.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index.
+ * - 'offset' and 'length' must describe the whole report block.
+ *
+ * Postconditions:
+ * - Returns 1 on success, 0 otherwise.
+ *
+ * Side Effects:
+ * - Appends a line to the index file.
+ */
+int addReport(ReportIndex r, const char *date, long offset, long length) {
+    if (r == NULL || !insertEntry(r, date, 0, offset, length, length)) return 0;
+
+    FILE *f = fopen(r->indexPath, "a");
+    if (f == NULL) {
+        fprintf(stderr, "\nError: Unable to update the report index.\n");
+        return 0;
+    }
+    fprintf(f, "%s\t%d\t%ld\t%ld\t%ld\n", date, 0, offset, length, length);
+    fclose(f);
+    return 1;
+}
+
+// Copies the file 'path', if it exists, at the end of 'to'; false on a read or write error
+static bool copyFile(const char *path, FILE *to) {
+    FILE *from = fopen(path, "rb");
+    if (from == NULL) return true;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), from)) > 0) {
+        if (fwrite(buffer, 1, n, to) != n) break;
+    }
+    bool ok = !ferror(from) && !ferror(to);
+    fclose(from);
+    return ok;
+}
+
+/* sealReports
+ * Syntax Specification:
+ * static bool sealReports(ReportIndex r, const char *text, long size, FILE *segment, struct entry *sealed);
+ *
+ * Semantic Specification:
+ * Compresses every report of the current segment ('text', 'size' bytes) as a
+ * separate block at the end of 'segment' and describes its new position in
+ * 'sealed', a copy of the entries of the index.
+ *
+ * Preconditions:
+ * - 'sealed' must have 'r->numel' elements, copied from 'r->entries'.
+ *
+ * Postconditions:
+ * - Returns true if every report was written, false otherwise.
+ *
+ * Side Effects:
+ * - Writes to 'segment', allocates temporary memory.
+ */
+static bool sealReports(ReportIndex r, const char *text, long size, FILE *segment, struct entry *sealed) {
+    int dictLen = sizeof(reportDictionary) - 1;
+    for (int i = 0; i < r->numel; i++) {
+        struct entry *e = &sealed[i];
+        if (e->segment != 0) continue;
+        if (e->offset + e->length > size) return false;
+
+        // incompressible data can grow by one byte every 128
+        int cap = e->length + e->length / 128 + 16;
+        char *block = malloc(cap);
+        int length = (block != NULL) ? compressBlock(text + e->offset, e->length, block, cap, reportDictionary, dictLen) : -1;
+        if (length < 0) {
+            free(block);
+            return false;
+        }
+
+        fprintf(segment, "%s %ld %d\n", e->date, e->length, length);
+        e->segment = r->currentYear;
+        e->offset = ftell(segment);
+        e->rawLength = e->length;
+        e->length = length;
+        size_t written = fwrite(block, 1, length, segment);
+        free(block);
+        if (written != (size_t)length) return false;
+    }
+    return !ferror(segment);
+}
+
+/* rotateReports
+ * Syntax Specification:
+ * int rotateReports(ReportIndex r, const char *date);
+ *
+ * Semantic Specification:
+ * Called before appending the report of 'date'. If the current segment holds the
+ * reports of an earlier year, seals it: every report is compressed as a separate
+ * block into the segment of its year, the index is updated and the plain report
+ * file starts over empty. The segment is rebuilt in a temporary file, and the
+ * index and the plain file change only after every report has been sealed.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index, 'date' a "ddmmyyyy" string.
+ *
+ * Postconditions:
+ * - The current segment only contains reports of the year of 'date'.
+ * - Returns 1 on success (or if no rotation is needed), 0 otherwise (the
+ *   reports stay in the current segment and the index is unchanged).
+ *
+ * Side Effects:
+ * - Reads and writes files.
+ */
+int rotateReports(ReportIndex r, const char *date) {
+    int year = atoi(date + 4);
+    if (r == NULL || r->currentYear == 0 || r->currentYear == year) return 1;
+
+    FILE *plain = fopen(r->reportPath, "rb");
+    if (plain == NULL) return 0;
+    long size = (fseek(plain, 0, SEEK_END) == 0) ? ftell(plain) : -1;
+    char *text = (size >= 0 && fseek(plain, 0, SEEK_SET) == 0) ? malloc(size + 1) : NULL;
+    if (text == NULL || fread(text, 1, size, plain) != (size_t)size) {
+        free(text);
+        fclose(plain);
+        return 0;
+    }
+    fclose(plain);
+
+    char path[256], temp[260];
+    segmentPath(r, r->currentYear, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    struct entry *sealed = malloc((r->numel > 0 ? r->numel : 1) * sizeof(struct entry));
+    FILE *segment = (sealed != NULL) ? fopen(temp, "wb") : NULL;
+    bool ok = (segment != NULL);
+    if (ok) {
+        // the blocks already sealed in the segment keep their offsets
+        memcpy(sealed, r->entries, r->numel * sizeof(struct entry));
+        ok = copyFile(path, segment) && sealReports(r, text, size, segment, sealed);
+        if (fclose(segment) != 0) ok = false;
+    }
+    free(text);
+    if (!ok || !replaceFile(temp, path)) {
+        remove(temp);
+        free(sealed);
+        fprintf(stderr, "\nError: Unable to write the report archive.\n");
+        return 0;
+    }
+
+    // the index must point to the archive before the plain copy is dropped
+    struct entry *old = r->entries;
+    r->entries = sealed;
+    if (!writeIndex(r)) {
+        // the plain copy is still there: the new blocks of the segment are not referenced
+        r->entries = old;
+        free(sealed);
+        return 0;
+    }
+    // 'sealed' has only 'numel' slots: the entries go back to the array that can grow
+    memcpy(old, sealed, r->numel * sizeof(struct entry));
+    r->entries = old;
+    free(sealed);
+
+    plain = fopen(r->reportPath, "w");
+    if (plain != NULL) fclose(plain);
+    r->currentYear = 0;
+    return 1;
+}
+
+/* readReport
+ * Syntax Specification:
+ * char *readReport(ReportIndex r, const char *date);
+ *
+ * Semantic Specification:
+ * Fetches the report block generated on 'date' with a single positioned read,
+ * decompressing it if it is in a sealed segment.
+ *
+ * Preconditions:
+ * - 'r' must be a valid index.
+ *
+ * Postconditions:
+ * - Returns a new null-terminated string with the block, or NULL if not found.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+char *readReport(ReportIndex r, const char *date) {
+    if (!hasReport(r, date)) return NULL;
+    struct entry *e = &r->entries[r->table[findSlot(r, date)]];
+
+    char path[256];
+    if (e->segment != 0) segmentPath(r, e->segment, path, sizeof(path));
+    FILE *f = fopen(e->segment != 0 ? path : r->reportPath, "rb");
+    if (f == NULL) return NULL;
+
+    char *block = malloc(e->length + 1);
+    if (block == NULL || fseek(f, e->offset, SEEK_SET) != 0 ||
+        fread(block, 1, e->length, f) != (size_t)e->length) {
+        free(block);
+        fclose(f);
+        return NULL;
+    }
+    block[e->length] = '\0';
+    fclose(f);
+    if (e->segment == 0) return block;
+
+    char *text = malloc(e->rawLength + 1);
+    if (text == NULL || decompressBlock(block, e->length, text, e->rawLength,
+                                        reportDictionary, sizeof(reportDictionary) - 1) != e->rawLength) {
+        fprintf(stderr, "\nError: corrupted report archive.\n");
+        free(text);
+        text = NULL;
+    } else {
+        text[e->rawLength] = '\0';
+    }
+    free(block);
+    return text;
+}
@@ -0,0 +1,14 @@
+#include <stdbool.h>
+
+// Forward declaration of the report index struct
+typedef struct reportIndex *ReportIndex;
+
+ //report index prototypes
+ReportIndex openReportIndex(const char *reportPath, const char *indexPath);
+void freeReportIndex(ReportIndex r);
+
+bool hasReport(ReportIndex r, const char *date);
+bool getLastReportDate(ReportIndex r, char *date);
+int addReport(ReportIndex r, const char *date, long offset, long length);
+int rotateReports(ReportIndex r, const char *date);
+char *readReport(ReportIndex r, const char *date);
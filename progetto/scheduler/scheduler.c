@@ -0,0 +1,437 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "scheduler.h"
+
+// A task of the plan, with the fields it was ordered by
+struct entry {
+    Task t;
+    int deadline;       // days from today
+    int priority;
+    int id;
+    long long work;     // minutes still to do
+    long long end;      // minutes of work planned up to this task included
+    int finishDay;
+    bool late;          // finished after its deadline
+};
+
+struct schedule {
+    int budget;         // minutes of study per day
+    int today;          // day 0 of the plan, in days (see dateToDays)
+    struct entry *entries; // sorted by deadline, priority and id
+    int numel;
+    int tot;
+    int late;           // entries finishing after their deadline
+    int dirty;          // first entry whose days are not up to date, 'numel' if none
+};
+
+/* newSchedule
+ * Syntax Specification:
+ * Schedule newSchedule(int budget);
+ *
+ * Semantic Specification:
+ * Creates an empty plan starting today, with 'budget' minutes of study per day.
+ *
+ * Preconditions:
+ * - 'budget' > 0, the global 'today' must be initialized.
+ *
+ * Postconditions:
+ * - Returns the new plan, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+Schedule newSchedule(int budget) {
+    Schedule s = calloc(1, sizeof(struct schedule));
+    if (s == NULL) return NULL;
+    s->budget = budget > 0 ? budget : 1;
+    s->today = dateToDays(today);
+    return s;
+}
+
+void freeSchedule(Schedule s) {
+    if (s == NULL) return;
+    free(s->entries);
+    free(s);
+}
+
+/* fillEntry
+ * Syntax Specification:
+ * static void fillEntry(Schedule s, struct entry *e, Task t);
+ *
+ * Semantic Specification:
+ * Copies the fields of the task used by the plan. The work left is the estimated
+ * time not covered by the completion percentage, rounded up to the minute.
+ *
+ * Preconditions:
+ * - 's', 'e' and 't' must be valid.
+ *
+ * Postconditions:
+ * - 'e' describes the task; its position in the plan is not computed yet.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void fillEntry(Schedule s, struct entry *e, Task t) {
+    long long todo = (long long)((100.0f - getCompletionPercentage(t)) * 100.0f + 0.5f);
+    e->t = t;
+    e->deadline = dateToDays(getDeadline(t)) - s->today;
+    e->priority = getPriority(t);
+    e->id = getId(t);
+    e->work = (getExdTime(t) * todo + 9999) / 10000;
+    if (e->work < 0) e->work = 0;
+    e->late = false;
+}
+
+/* compareEntries
+ * Syntax Specification:
+ * static int compareEntries(const void *a, const void *b);
+ *
+ * Semantic Specification:
+ * Order of the plan: earliest deadline first, then higher priority, then id.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to entries.
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as for qsort.
+ *
+ * Side Effects:
+ * - None.
+ */
+static int compareEntries(const void *a, const void *b) {
+    const struct entry *x = a, *y = b;
+    if (x->deadline != y->deadline) return x->deadline < y->deadline ? -1 : 1;
+    if (x->priority != y->priority) return x->priority > y->priority ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/* lowerBound
+ * Syntax Specification:
+ * static int lowerBound(Schedule s, const struct entry *key);
+ *
+ * Semantic Specification:
+ * Returns the position of the first entry not preceding 'key'.
+ *
+ * Preconditions:
+ * - 's' and 'key' must be valid.
+ *
+ * Postconditions:
+ * - Returns a position in [0, numel].
+ *
+ * Side Effects:
+ * - None.
+ */
+static int lowerBound(Schedule s, const struct entry *key) {
+    int lo = 0, hi = s->numel;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compareEntries(&s->entries[mid], key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* invalidate
+ * Syntax Specification:
+ * static void invalidate(Schedule s, int from);
+ *
+ * Semantic Specification:
+ * Records that the tasks from position 'from' on must be placed again. The work
+ * is done by the next query, so a sequence of changes places them only once.
+ *
+ * Preconditions:
+ * - 's' must be valid, 0 <= from <= numel.
+ *
+ * Postconditions:
+ * - The entries from 'from' on are out of date.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void invalidate(Schedule s, int from) {
+    if (from < s->dirty) s->dirty = from;
+}
+
+/* update
+ * Syntax Specification:
+ * static void update(Schedule s);
+ *
+ * Semantic Specification:
+ * Places again the tasks from the first one out of date to the end of the plan.
+ * The tasks before it are not affected by the changes and are not visited.
+ *
+ * Preconditions:
+ * - 's' must be valid.
+ *
+ * Postconditions:
+ * - Every entry has its finishing day and lateness; the late count is updated.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void update(Schedule s) {
+    if (s->dirty >= s->numel) {
+        s->dirty = s->numel;
+        return;
+    }
+    long long end = (s->dirty > 0) ? s->entries[s->dirty - 1].end : 0;
+    for (int i = s->dirty; i < s->numel; i++) {
+        struct entry *e = &s->entries[i];
+        s->late -= e->late;
+        end += e->work;
+        e->end = end;
+        e->finishDay = (e->work > 0) ? (int)((end - 1) / s->budget) : 0;
+        e->late = e->finishDay > e->deadline;
+        s->late += e->late;
+    }
+    s->dirty = s->numel;
+}
+
+/* buildSchedule
+ * Syntax Specification:
+ * int buildSchedule(Schedule s, Task *tasks, int numel);
+ *
+ * Semantic Specification:
+ * Replaces the plan with the given tasks, sorting them once (O(n log n)).
+ *
+ * Preconditions:
+ * - 's' must be valid, 'tasks' an array of 'numel' valid tasks.
+ *
+ * Postconditions:
+ * - Returns 1 if the plan was built, 0 if memory is not available (the plan is left empty).
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+int buildSchedule(Schedule s, Task *tasks, int numel) {
+    if (numel > s->tot) {
+        struct entry *entries = realloc(s->entries, numel * sizeof(struct entry));
+        if (entries == NULL) {
+            s->numel = s->late = 0;
+            return 0;
+        }
+        s->entries = entries;
+        s->tot = numel;
+    }
+    for (int i = 0; i < numel; i++) fillEntry(s, &s->entries[i], tasks[i]);
+    s->numel = numel;
+    s->late = 0;
+    qsort(s->entries, numel, sizeof(struct entry), compareEntries);
+    s->dirty = 0;
+    update(s);
+    return 1;
+}
+
+int getDailyBudget(Schedule s) {
+    return s->budget;
+}
+
+/* setDailyBudget
+ * Syntax Specification:
+ * void setDailyBudget(Schedule s, int budget);
+ *
+ * Semantic Specification:
+ * Changes the minutes of study per day. The order does not change, only the
+ * days of every task are computed again.
+ *
+ * Preconditions:
+ * - 's' must be valid, 'budget' > 0.
+ *
+ * Postconditions:
+ * - The plan uses the new budget.
+ *
+ * Side Effects:
+ * - None.
+ */
+void setDailyBudget(Schedule s, int budget) {
+    if (budget <= 0 || budget == s->budget) return;
+    s->budget = budget;
+    invalidate(s, 0);
+}
+
+/* scheduleTask
+ * Syntax Specification:
+ * int scheduleTask(Schedule s, Task t);
+ *
+ * Semantic Specification:
+ * Adds a task to the plan: it is inserted at its position and only the tasks
+ * after it will be placed again.
+ *
+ * Preconditions:
+ * - 't' must be valid and not in the plan; 's' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - Returns 1 if the task was added, 0 otherwise.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+int scheduleTask(Schedule s, Task t) {
+    if (s == NULL || t == NULL) return 0;
+
+    if (s->numel == s->tot) {
+        int tot = s->tot ? s->tot * 2 : 64;
+        struct entry *entries = realloc(s->entries, tot * sizeof(struct entry));
+        if (entries == NULL) return 0;
+        s->entries = entries;
+        s->tot = tot;
+    }
+    struct entry e;
+    fillEntry(s, &e, t);
+    int pos = lowerBound(s, &e);
+    memmove(&s->entries[pos + 1], &s->entries[pos], (s->numel - pos) * sizeof(struct entry));
+    s->entries[pos] = e;
+    s->numel++;
+    invalidate(s, pos);
+    return 1;
+}
+
+/* unscheduleTask
+ * Syntax Specification:
+ * void unscheduleTask(Schedule s, Task t);
+ *
+ * Semantic Specification:
+ * Removes a task from the plan; only the tasks after it will be placed again. Must be
+ * called before the fields used by the plan (deadline, priority, estimated time,
+ * completion percentage) are changed, since they are used to find the task.
+ *
+ * Preconditions:
+ * - 't' must be valid; 's' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The task is no longer in the plan.
+ *
+ * Side Effects:
+ * - None.
+ */
+void unscheduleTask(Schedule s, Task t) {
+    if (s == NULL || t == NULL) return;
+
+    struct entry key;
+    fillEntry(s, &key, t);
+    int pos = lowerBound(s, &key);
+    if (pos == s->numel || s->entries[pos].t != t) return;
+
+    s->late -= s->entries[pos].late;
+    memmove(&s->entries[pos], &s->entries[pos + 1], (s->numel - pos - 1) * sizeof(struct entry));
+    s->numel--;
+    invalidate(s, pos);
+}
+
+/* getScheduledCount, getLateCount, getPlanDays
+ * Syntax Specification:
+ * int getScheduledCount(Schedule s);
+ * int getLateCount(Schedule s);
+ * int getPlanDays(Schedule s);
+ *
+ * Semantic Specification:
+ * Return the tasks in the plan, the tasks that cannot be finished by their
+ * deadline with the daily budget, and the days needed to finish every task.
+ * The tasks changed since the last query are placed first.
+ * When the earliest-deadline order finishes a task late, no other order
+ * finishes every task in time.
+ *
+ * Preconditions:
+ * - 's' must be valid.
+ *
+ * Postconditions:
+ * - Return the counts.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getScheduledCount(Schedule s) {
+    return s->numel;
+}
+
+int getLateCount(Schedule s) {
+    update(s);
+    return s->late;
+}
+
+int getPlanDays(Schedule s) {
+    update(s);
+    if (s->numel == 0 || s->entries[s->numel - 1].end == 0) return 0;
+    return (int)((s->entries[s->numel - 1].end - 1) / s->budget) + 1;
+}
+
+/* getPlanEntry
+ * Syntax Specification:
+ * Task getPlanEntry(Schedule s, int i, int *finishDay, bool *late);
+ *
+ * Semantic Specification:
+ * Returns the i-th task of the plan, with the day it is finished and whether
+ * that day is after its deadline.
+ *
+ * Preconditions:
+ * - 's' must be valid, 0 <= i < getScheduledCount(s).
+ *
+ * Postconditions:
+ * - Returns the task and fills 'finishDay' and 'late'.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task getPlanEntry(Schedule s, int i, int *finishDay, bool *late) {
+    update(s);
+    *finishDay = s->entries[i].finishDay;
+    *late = s->entries[i].late;
+    return s->entries[i].t;
+}
+
+/* findDayStart
+ * Syntax Specification:
+ * int findDayStart(Schedule s, int day);
+ *
+ * Semantic Specification:
+ * Returns the position of the first task worked on 'day', with a binary search
+ * on the planned minutes: the tasks of the day follow it in the plan.
+ *
+ * Preconditions:
+ * - 's' must be valid, 'day' >= 0.
+ *
+ * Postconditions:
+ * - Returns a position in [0, getScheduledCount(s)].
+ *
+ * Side Effects:
+ * - None.
+ */
+int findDayStart(Schedule s, int day) {
+    long long start = (long long)day * s->budget;
+    int lo = 0, hi = s->numel;
+    update(s);
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (s->entries[mid].end <= start) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* getMinutesOnDay
+ * Syntax Specification:
+ * int getMinutesOnDay(Schedule s, int i, int day);
+ *
+ * Semantic Specification:
+ * Returns the minutes of the i-th task planned on 'day'.
+ *
+ * Preconditions:
+ * - 's' must be valid, 0 <= i < getScheduledCount(s).
+ *
+ * Postconditions:
+ * - Returns a value between 0 and the daily budget.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getMinutesOnDay(Schedule s, int i, int day) {
+    update(s);
+    long long dayStart = (long long)day * s->budget, dayEnd = dayStart + s->budget;
+    long long start = s->entries[i].end - s->entries[i].work, end = s->entries[i].end;
+    if (start < dayStart) start = dayStart;
+    if (end > dayEnd) end = dayEnd;
+    return end > start ? (int)(end - start) : 0;
+}
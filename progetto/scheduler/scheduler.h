@@ -0,0 +1,26 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Study plan of the tasks in progress: the tasks are worked one after the other in
+// order of deadline (earliest first, higher priority first on the same day), each
+// day using at most the daily budget of minutes, starting from today (day 0).
+
+// Forward declaration of the schedule struct
+typedef struct schedule *Schedule;
+
+ //scheduler prototypes
+Schedule newSchedule(int budget);
+void freeSchedule(Schedule s);
+int buildSchedule(Schedule s, Task *tasks, int numel);
+int getDailyBudget(Schedule s);
+void setDailyBudget(Schedule s, int budget);
+
+int scheduleTask(Schedule s, Task t);
+void unscheduleTask(Schedule s, Task t);
+
+int getScheduledCount(Schedule s);
+int getLateCount(Schedule s);
+int getPlanDays(Schedule s);
+Task getPlanEntry(Schedule s, int i, int *finishDay, bool *late);
+int findDayStart(Schedule s, int day);
+int getMinutesOnDay(Schedule s, int i, int day);
@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../char/char.h"
+#include "../crc/crc.h"
+#include "../export/export.h"
+#include "stats.h"
+
+#define WEEK_HEADER "#PWS\t%d\t%s\t%010d\t%010d\t%08x\n"
+#define WEEK_VERSION 1
+#define WEEK_MAX_LINE 1024
+
+// Counters of one course for the week
+struct course {
+    char name[51];
+    int completed;
+    int inProgress;
+    int expired;
+    long minutes;
+};
+
+struct weekStats {
+    char monday[9];
+    char today[9];
+    int completed;
+    int inProgress;
+    int dueToday;
+    int expired;
+    long minutes;           // estimated time of the tasks in progress
+    Task *week[3];          // completed and expired tasks of the week, oldest first
+    int numel[3];
+    int tot[3];
+    struct course *courses;
+    int numCourses;
+    int totCourses;
+    int *table;             // open addressing hash table of positions in 'courses', -1 if free
+    int tableSize;          // always a power of two, at least twice 'numCourses'
+    Task *own;              // tasks read from the week file, owned by the counters
+    int numOwn;
+};
+
+/* newWeekStats
+ * Syntax Specification:
+ * WeekStats newWeekStats(const char *monday);
+ *
+ * Semantic Specification:
+ * Creates empty counters for the week going from 'monday' to today. The tasks
+ * are then added with trackTask, and kept up to date at every change of state.
+ *
+ * Preconditions:
+ * - 'monday' must be a "ddmmyyyy" date, the global 'today' must be initialized.
+ *
+ * Postconditions:
+ * - Returns the new counters, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+WeekStats newWeekStats(const char *monday) {
+    WeekStats w = calloc(1, sizeof(struct weekStats));
+    if (w == NULL) return NULL;
+
+    strcpy(w->monday, monday);
+    strcpy(w->today, today);
+    w->tableSize = 16;
+    w->table = malloc(w->tableSize * sizeof(int));
+    if (w->table == NULL) {
+        free(w);
+        return NULL;
+    }
+    for (int i = 0; i < w->tableSize; i++) w->table[i] = -1;
+    return w;
+}
+
+void freeWeekStats(WeekStats w) {
+    if (w == NULL) return;
+    for (int c = 0; c < 3; c++) free(w->week[c]);
+    for (int i = 0; i < w->numOwn; i++) freeTask(w->own[i]);
+    free(w->own);
+    free(w->courses);
+    free(w->table);
+    free(w);
+}
+
+const char *getStatsMonday(WeekStats w) {
+    return w->monday;
+}
+
+/* findSlot
+ * Syntax Specification:
+ * static int findSlot(WeekStats w, const char *name);
+ *
+ * Semantic Specification:
+ * Returns the slot of the hash table holding the course, or the free slot where it would go.
+ *
+ * Preconditions:
+ * - 'w' must be valid, with at least one free slot.
+ *
+ * Postconditions:
+ * - Returns a slot index in [0, tableSize).
+ *
+ * Side Effects:
+ * - None.
+ */
+static int findSlot(WeekStats w, const char *name) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; name[i] != '\0'; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    int slot = h & (w->tableSize - 1);
+    while (w->table[slot] != -1 && strcmp(w->courses[w->table[slot]].name, name) != 0) {
+        slot = (slot + 1) & (w->tableSize - 1);
+    }
+    return slot;
+}
+
+/* findCourse
+ * Syntax Specification:
+ * static struct course *findCourse(WeekStats w, const char *name);
+ *
+ * Semantic Specification:
+ * Returns the counters of a course, adding them if the course is new.
+ *
+ * Preconditions:
+ * - 'w' must be valid, 'name' a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns the counters, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static struct course *findCourse(WeekStats w, const char *name) {
+    int slot = findSlot(w, name);
+    if (w->table[slot] != -1) return &w->courses[w->table[slot]];
+
+    // the table stays at most half full
+    if ((w->numCourses + 1) * 2 > w->tableSize) {
+        int *table = malloc(w->tableSize * 2 * sizeof(int));
+        if (table == NULL) return NULL;
+        free(w->table);
+        w->table = table;
+        w->tableSize *= 2;
+        for (int i = 0; i < w->tableSize; i++) w->table[i] = -1;
+        for (int i = 0; i < w->numCourses; i++) w->table[findSlot(w, w->courses[i].name)] = i;
+        slot = findSlot(w, name);
+    }
+    if (w->numCourses == w->totCourses) {
+        int tot = w->totCourses ? w->totCourses * 2 : 8;
+        struct course *courses = realloc(w->courses, tot * sizeof(struct course));
+        if (courses == NULL) return NULL;
+        w->courses = courses;
+        w->totCourses = tot;
+    }
+
+    struct course *c = &w->courses[w->numCourses];
+    memset(c, 0, sizeof(struct course));
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    w->table[slot] = w->numCourses++;
+    return c;
+}
+
+/* inWeek
+ * Syntax Specification:
+ * static bool inWeek(WeekStats w, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Tells whether a task belongs to the weekly report: every task in progress, the
+ * tasks completed from monday to today and those expired from monday to yesterday.
+ *
+ * Preconditions:
+ * - 'w' and 't' must be valid.
+ *
+ * Postconditions:
+ * - Returns true if the task is counted.
+ *
+ * Side Effects:
+ * - None.
+ */
+static bool inWeek(WeekStats w, Task t, int collection) {
+    if (collection == STATS_COMPLETED) {
+        return compareDates(getCompletionDate(t), w->monday) >= 0 && compareDates(getCompletionDate(t), w->today) <= 0;
+    }
+    if (collection == STATS_EXPIRED) {
+        return compareDates(getDeadline(t), w->monday) >= 0 && compareDates(getDeadline(t), w->today) < 0;
+    }
+    return true;
+}
+
+/* count
+ * Syntax Specification:
+ * static void count(WeekStats w, Task t, int collection, int sign);
+ *
+ * Semantic Specification:
+ * Adds (sign 1) or removes (sign -1) a task from the counters of the week and of its course.
+ *
+ * Preconditions:
+ * - The task must belong to the week (see inWeek).
+ *
+ * Postconditions:
+ * - The counters are updated.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static void count(WeekStats w, Task t, int collection, int sign) {
+    struct course *c = findCourse(w, getCourse(t));
+    if (collection == STATS_PROGRESS) {
+        w->inProgress += sign;
+        w->minutes += sign * getExdTime(t);
+        if (strcmp(getDeadline(t), w->today) == 0) w->dueToday += sign;
+        if (c != NULL) {
+            c->inProgress += sign;
+            c->minutes += sign * getExdTime(t);
+        }
+    } else if (collection == STATS_COMPLETED) {
+        w->completed += sign;
+        if (c != NULL) c->completed += sign;
+    } else {
+        w->expired += sign;
+        if (c != NULL) c->expired += sign;
+    }
+}
+
+/* trackTask
+ * Syntax Specification:
+ * void trackTask(WeekStats w, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Records that a task entered a collection (STATS_PROGRESS, STATS_COMPLETED or STATS_EXPIRED).
+ *
+ * Preconditions:
+ * - 't' must be valid; 'w' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - If the task belongs to the week, the counters include it.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+void trackTask(WeekStats w, Task t, int collection) {
+    if (w == NULL || t == NULL || !inWeek(w, t, collection)) return;
+
+    count(w, t, collection, 1);
+    if (collection == STATS_PROGRESS) return;
+    if (w->numel[collection] == w->tot[collection]) {
+        int tot = w->tot[collection] ? w->tot[collection] * 2 : 16;
+        Task *week = realloc(w->week[collection], tot * sizeof(Task));
+        if (week == NULL) return;
+        w->week[collection] = week;
+        w->tot[collection] = tot;
+    }
+    w->week[collection][w->numel[collection]++] = t;
+}
+
+/* untrackTask
+ * Syntax Specification:
+ * void untrackTask(WeekStats w, Task t, int collection);
+ *
+ * Semantic Specification:
+ * Records that a task is leaving a collection. Must be called before the fields
+ * used by the counters (dates, course, estimated time) are changed. The task is
+ * found by id: the counters read from the week file hold copies of the tasks.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'w' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - The counters no longer include the task.
+ *
+ * Side Effects:
+ * - None.
+ */
+void untrackTask(WeekStats w, Task t, int collection) {
+    if (w == NULL || t == NULL || !inWeek(w, t, collection)) return;
+
+    count(w, t, collection, -1);
+    if (collection == STATS_PROGRESS) return;
+    for (int i = w->numel[collection] - 1; i >= 0; i--) {
+        if (getId(w->week[collection][i]) == getId(t)) {
+            memmove(&w->week[collection][i], &w->week[collection][i + 1], (w->numel[collection] - i - 1) * sizeof(Task));
+            w->numel[collection]--;
+            return;
+        }
+    }
+}
+
+/* clearHistoryStats
+ * Syntax Specification:
+ * void clearHistoryStats(WeekStats w);
+ *
+ * Semantic Specification:
+ * Resets the counters of the completed and expired tasks, when the history is deleted.
+ *
+ * Preconditions:
+ * - 'w' may be NULL (nothing is done).
+ *
+ * Postconditions:
+ * - Only the tasks in progress are counted.
+ *
+ * Side Effects:
+ * - None.
+ */
+void clearHistoryStats(WeekStats w) {
+    if (w == NULL) return;
+    w->completed = w->expired = 0;
+    w->numel[STATS_COMPLETED] = w->numel[STATS_EXPIRED] = 0;
+    for (int i = 0; i < w->numCourses; i++) w->courses[i].completed = w->courses[i].expired = 0;
+}
+
+/* saveWeekFile
+ * Syntax Specification:
+ * int saveWeekFile(const char *path, const char *monday, const char *stamp, Task *tasks[3], const int numel[3]);
+ *
+ * Semantic Specification:
+ * Writes the week file (see stats.h): the tasks completed (tasks[STATS_COMPLETED])
+ * and expired (tasks[STATS_EXPIRED]) from 'monday' on, after the stamp of the
+ * history files they were taken from. The header is written last, with the checksum.
+ *
+ * Preconditions:
+ * - 'stamp' must end with a line break, the tasks must be in the order of the history files.
+ *
+ * Postconditions:
+ * - Returns 1 if the file was written, 0 otherwise.
+ *
+ * Side Effects:
+ * - Writes to a file.
+ */
+int saveWeekFile(const char *path, const char *monday, const char *stamp, Task *tasks[3], const int numel[3]) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return 0;
+
+    // room for the header, rewritten at the end
+    bool ok = fprintf(f, WEEK_HEADER, WEEK_VERSION, monday, 0, 0, 0u) > 0 && fputs(stamp, f) >= 0;
+    unsigned int crc = crc32c(0, stamp, strlen(stamp));
+    char line[WEEK_MAX_LINE];
+    for (int c = STATS_COMPLETED; c <= STATS_EXPIRED; c++) {
+        for (int i = 0; i < numel[c] && ok; i++) {
+            int len = sPrintTask(tasks[c][i], line, sizeof(line) - 1);
+            ok = len >= 0;
+            if (!ok) break;
+            line[len++] = '\n';
+            crc = crc32c(crc, line, len);
+            ok = fwrite(line, 1, len, f) == (size_t)len;
+        }
+    }
+    if (ok) {
+        rewind(f);
+        ok = fprintf(f, WEEK_HEADER, WEEK_VERSION, monday, numel[STATS_COMPLETED], numel[STATS_EXPIRED], crc) > 0;
+    }
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/* loadWeekFile
+ * Syntax Specification:
+ * WeekStats loadWeekFile(const char *path, const char *stamp, Task *progress, int numProgress);
+ *
+ * Semantic Specification:
+ * Reads the week file written by saveWeekFile and returns the counters of its
+ * week up to today: the tasks in progress given, then the completed and expired
+ * tasks of the file are tracked, in the order used when the counters are built
+ * from the collections. The file is used only if its stamp is 'stamp', that is
+ * if the history files did not change since it was written.
+ *
+ * Preconditions:
+ * - 'path' must be a valid path, the global 'today' must be initialized.
+ * - 'progress' must have 'numProgress' valid tasks.
+ *
+ * Postconditions:
+ * - Returns the counters, or NULL if the file is missing, damaged, of another
+ *   version or stamp, or memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+WeekStats loadWeekFile(const char *path, const char *stamp, Task *progress, int numProgress) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+
+    char header[64], monday[9];
+    int version, numel[3] = { 0, 0, 0 };
+    long size = 0;
+    unsigned int crc;
+    if (fgets(header, sizeof(header), f) == NULL
+            || sscanf(header, "#PWS\t%d\t%8s\t%d\t%d\t%x", &version, monday, &numel[STATS_COMPLETED],
+                      &numel[STATS_EXPIRED], &crc) != 5
+            || version != WEEK_VERSION || numel[STATS_COMPLETED] < 0 || numel[STATS_EXPIRED] < 0) {
+        fclose(f);
+        return NULL;
+    }
+    long start = ftell(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f) - start;
+    fseek(f, start, SEEK_SET);
+    long len = strlen(stamp);
+    char *body = malloc(size + 1);
+    WeekStats w = newWeekStats(monday);
+    int total = numel[STATS_COMPLETED] + numel[STATS_EXPIRED];
+    if (w != NULL) w->own = malloc((total > 0 ? total : 1) * sizeof(Task));
+    if (body == NULL || w == NULL || w->own == NULL || fread(body, 1, size, f) != (size_t)size
+            || crc32c(0, body, size) != crc || size < len || memcmp(body, stamp, len) != 0) {
+        fclose(f);
+        free(body);
+        freeWeekStats(w);
+        return NULL;
+    }
+    fclose(f);
+    body[size] = '\0';
+
+    for (int i = 0; i < numProgress; i++) trackTask(w, progress[i], STATS_PROGRESS);
+    // the tasks are tracked in file order, the order of the history files
+    long pos = len;
+    for (int c = STATS_COMPLETED; c <= STATS_EXPIRED; c++) {
+        for (int i = 0; i < numel[c]; i++) {
+            char *end = memchr(body + pos, '\n', size - pos);
+            if (end == NULL) break;
+            *end = '\0';
+            Task t = sReadTask(body + pos);
+            if (t == NULL) break;
+            pos = end - body + 1;
+            w->own[w->numOwn++] = t;
+            trackTask(w, t, c);
+        }
+    }
+    free(body);
+    if (w->numOwn != total || pos != size) {
+        freeWeekStats(w);
+        return NULL;
+    }
+    return w;
+}
+
+/* getWeekSummary
+ * Syntax Specification:
+ * void getWeekSummary(WeekStats w, struct weekSummary *s);
+ *
+ * Semantic Specification:
+ * Copies the aggregates of the week, without visiting any task.
+ *
+ * Preconditions:
+ * - 'w' and 's' must be valid.
+ *
+ * Postconditions:
+ * - 's' contains the counts of the week.
+ *
+ * Side Effects:
+ * - None.
+ */
+void getWeekSummary(WeekStats w, struct weekSummary *s) {
+    strcpy(s->monday, w->monday);
+    strcpy(s->today, w->today);
+    s->completed = w->completed;
+    s->inProgress = w->inProgress;
+    s->dueToday = w->dueToday;
+    s->expired = w->expired;
+    s->minutesPlanned = w->minutes;
+}
+
+/* getWeekTasks
+ * Syntax Specification:
+ * int getWeekTasks(WeekStats w, int collection, Task **tasks);
+ *
+ * Semantic Specification:
+ * Returns the tasks completed (STATS_COMPLETED) or expired (STATS_EXPIRED) during
+ * the week, oldest first, so the report does not have to walk the history.
+ *
+ * Preconditions:
+ * - 'w' must be valid.
+ *
+ * Postconditions:
+ * - '*tasks' points to an array owned by 'w', valid until the next change.
+ * - Returns the number of tasks.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getWeekTasks(WeekStats w, int collection, Task **tasks) {
+    *tasks = w->week[collection];
+    return w->numel[collection];
+}
+
+/* getCourseCount, getCourseStats
+ * Syntax Specification:
+ * int getCourseCount(WeekStats w);
+ * const char *getCourseStats(WeekStats w, int i, int *completed, int *inProgress, int *expired, long *minutes);
+ *
+ * Semantic Specification:
+ * Visit the counters of the week per course, in order of first appearance.
+ *
+ * Preconditions:
+ * - 'w' must be valid, 0 <= i < getCourseCount(w).
+ *
+ * Postconditions:
+ * - getCourseStats fills the counters and returns the name of the course.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getCourseCount(WeekStats w) {
+    return w->numCourses;
+}
+
+const char *getCourseStats(WeekStats w, int i, int *completed, int *inProgress, int *expired, long *minutes) {
+    struct course *c = &w->courses[i];
+    *completed = c->completed;
+    *inProgress = c->inProgress;
+    *expired = c->expired;
+    *minutes = c->minutes;
+    return c->name;
+}
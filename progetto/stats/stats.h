@@ -0,0 +1,34 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Collections tracked by the weekly counters, same indexes as the planner
+#define STATS_PROGRESS 0
+#define STATS_COMPLETED 1
+#define STATS_EXPIRED 2
+
+// Layout of the week file, the history of the current week kept between sessions:
+//   #PWS <version> <monday> <completed> <expired> <CRC32C of the rest of the file>
+//   the stamp of the history files the tasks were taken from (their header lines)
+//   the tasks completed from monday on, then the ones expired from monday on, in the
+//   order of the history files
+
+// Forward declarations: the summary is defined in export.h
+typedef struct weekStats *WeekStats;
+struct weekSummary;
+
+ //weekly statistics prototypes
+WeekStats newWeekStats(const char *monday);
+void freeWeekStats(WeekStats w);
+const char *getStatsMonday(WeekStats w);
+
+void trackTask(WeekStats w, Task t, int collection);
+void untrackTask(WeekStats w, Task t, int collection);
+void clearHistoryStats(WeekStats w);
+
+int saveWeekFile(const char *path, const char *monday, const char *stamp, Task *tasks[3], const int numel[3]);
+WeekStats loadWeekFile(const char *path, const char *stamp, Task *progress, int numProgress);
+
+void getWeekSummary(WeekStats w, struct weekSummary *s);
+int getWeekTasks(WeekStats w, int collection, Task **tasks);
+int getCourseCount(WeekStats w);
+const char *getCourseStats(WeekStats w, int i, int *completed, int *inProgress, int *expired, long *minutes);
@@ -15,77 +15,127 @@ struct task {
     int priority;
     float completionPercentage;
     char completionDate[9];
+    int id; // unique among all the tasks of the planner, 0 if not assigned yet
 };
 
-/* newTask
+// Highest id given to a task so far
+static int lastId = 0;
+
+/* createTask
  * Syntax Specification:
- * Task newTask();
+ * Task createTask(const char *title, const char *description, const char *course,
+ *                 int estimatedTime, const char *deadline, char *pTxt);
  *
  * Semantic Specification:
- * Allocates and initializes a new task by requesting user input for all the required fields.
- * Initializes completion percentage to 0 and assigns today's date as the start date.
+ * Allocates a new in-progress task from already validated fields, without any
+ * interaction with the user. The start date is today.
  *
  * Preconditions:
- * - 'today' must be a valid date string defined externally.
- * - Functions clearBuffer(), read(), and isValidDate() must be available.
+ * - The strings must fit the task fields (20, 255 and 50 characters).
+ * - 'deadline' must be a valid date, 'pTxt' one of "low", "medium", "high".
  *
  * Postconditions:
- * - Returns a pointer to a fully initialized Task.
+ * - Returns a pointer to a fully initialized Task, or NULL if memory is not available.
  *
  * Side Effects:
- * - Reads user input from terminal.
- * - Prints prompts to terminal.
  * - Allocates memory dynamically.
  */
-Task newTask() {
-    char pTxt[10];
+Task createTask(const char *title, const char *description, const char *course,
+                int estimatedTime, const char *deadline, char *pTxt) {
     Task new = malloc(sizeof(struct task));
+    if (new == NULL) return NULL;
+
+    snprintf(new->title, sizeof(new->title), "%s", title);
+    snprintf(new->description, sizeof(new->description), "%s", description);
+    snprintf(new->course, sizeof(new->course), "%s", course);
+    snprintf(new->deadline, sizeof(new->deadline), "%s", deadline);
+    new->estimatedTime = estimatedTime;
+    setPriority(new, pTxt);
+    new->completionPercentage = 0.0;
+    strcpy(new->startDate, today);
+    strcpy(new->completionDate, "00000000");
+    new->id = ++lastId;
+    return new;
+}
 
-    clearBuffer();
-    printf("\nEnter title (max 20): ");
-    read(20, new->title);
-    printf("\nEnter description (max 255): ");
-    read(255, new->description);
-    printf("\nEnter course name (max 50): ");
-    read(50, new->course);
-    
-
-    do {
-        printf("\nEnter estimated time (in minutes): ");
-        scanf("%d", &new->estimatedTime);
-        if (new->estimatedTime < 0) printf("\nError: estimated time cannot be negative.");
-    } while (new->estimatedTime < 0);
-
-    while (!isValidDate(new->deadline)) {
-        clearBuffer();
-        printf("\nEnter deadline (format ddmmyyyy): ");
-        read(8, new->deadline);
-        if (!isValidDate(new->deadline)) {
-            printf("\n!! Invalid date !! Try again !!");
-        }
-    }
+/* getId
+ * Syntax Specification:
+ * int getId(Task t);
+ *
+ * Semantic Specification:
+ * Returns the id of the task, which stays the same for its whole life
+ * (in progress, completed, expired, restored) and across sessions.
+ *
+ * Preconditions:
+ * - 't' must not be NULL.
+ *
+ * Postconditions:
+ * - Returns the id.
+ *
+ * Side Effects:
+ * - None.
+ */
+int getId(Task t) {
+    return t->id;
+}
 
-    while (1) {
-        printf("\nEnter priority level (low/medium/high): ");
-        read(6, pTxt);
-
-        if ((strcmp(pTxt, "low") == 0) || (strcmp(pTxt, "medium") == 0) || (strcmp(pTxt, "high") == 0)) {
-            new = setPriority(new, pTxt);
-            break;
-        } else {
-            printf("\n!! Error, try again !!");
-            memset(pTxt, '\0', sizeof(pTxt));
-        }
-    }
+/* assignTaskId
+ * Syntax Specification:
+ * Task assignTaskId(Task t);
+ *
+ * Semantic Specification:
+ * Registers a task read from file: its id is reserved, or a new one is given
+ * if the task was saved before ids existed.
+ *
+ * Preconditions:
+ * - Must be called by one thread at a time.
+ *
+ * Postconditions:
+ * - 't' has an id that new tasks will not reuse. Returns 't'.
+ *
+ * Side Effects:
+ * - Updates the id counter.
+ */
+Task assignTaskId(Task t) {
+    if (t == NULL) return NULL;
+    if (t->id <= 0) t->id = ++lastId;
+    else if (t->id > lastId) lastId = t->id;
+    return t;
+}
 
-    new->completionPercentage = 0.0;
-    strcpy(new->startDate, today);
-    strcpy(new->completionDate, "00000000"); // Placeholder for uncompleted task
+/* getLastTaskId, reserveTaskIds
+ * The id counter is saved in the header of the data files, so that the ids of
+ * tasks that are no longer loaded are not reused.
+ */
+int getLastTaskId() {
+    return lastId;
+}
 
-    clearScreen();
-    printf("\nNew data added:\n");
-    printTaskDetails(new);
-    return new;
+void reserveTaskIds(int last) {
+    if (last > lastId) lastId = last;
+}
+
+/* copyTask
+ * Syntax Specification:
+ * Task copyTask(Task t);
+ *
+ * Semantic Specification:
+ * Allocates an independent copy of a task, id included.
+ *
+ * Preconditions:
+ * - 't' must be a valid Task.
+ *
+ * Postconditions:
+ * - Returns the copy, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+Task copyTask(Task t) {
+    if (t == NULL) return NULL;
+    Task copy = malloc(sizeof(struct task));
+    if (copy != NULL) memcpy(copy, t, sizeof(struct task));
+    return copy;
 }
 
 /* getTitle
@@ -287,6 +337,41 @@ Task fReadTask(FILE *f) {
         free(t);
         return NULL;
     }
+    t->id = 0;
+    return t;
+}
+
+/* sReadTask
+ * Syntax Specification:
+ * Task sReadTask(const char *line);
+ *
+ * Semantic Specification:
+ * Reads a task from a tab-separated line already in memory, with the same
+ * format used by fReadTask plus the optional id as tenth field (0 if missing).
+ * If the line is invalid, returns NULL. The id is not registered: see assignTaskId.
+ *
+ * Preconditions:
+ * - 'line' must be a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns a new Task object with data read from the line, or NULL on failure.
+ *
+ * Side Effects:
+ * - Allocates dynamic memory.
+ */
+Task sReadTask(const char *line) {
+    Task t = malloc(sizeof(struct task));
+    if (t == NULL) return NULL;
+
+    t->id = 0;
+    int res = sscanf(line, "%20[^\t]\t%255[^\t]\t%50[^\t]\t%d\t%8s\t%8s\t%f\t%8s\t%d\t%d",
+        t->title, t->description, t->course, &t->estimatedTime, t->startDate,
+        t->deadline, &t->completionPercentage, t->completionDate, &t->priority, &t->id);
+
+    if (res != 9 && res != 10) {
+        free(t);
+        return NULL;
+    }
     return t;
 }
 
@@ -408,9 +493,107 @@ void fPrintTask(Task t, FILE *f) {
         return;
     }
 
-    fprintf(f, "%s\t%s\t%s\t%d\t%s\t%s\t%.2f\t%s\t%d\n",
+    fprintf(f, "%s\t%s\t%s\t%d\t%s\t%s\t%.2f\t%s\t%d\t%d\n",
         t->title, t->description, t->course, t->estimatedTime, t->startDate,
-        t->deadline, t->completionPercentage, t->completionDate, t->priority);
+        t->deadline, t->completionPercentage, t->completionDate, t->priority, t->id);
+}
+
+/* sPrintTask
+ * Syntax Specification:
+ * int sPrintTask(Task t, char *buffer, int size);
+ *
+ * Semantic Specification:
+ * Formats the task as the tab-separated line written by fPrintTask, without the newline.
+ *
+ * Preconditions:
+ * - 't' must be a valid Task, 'buffer' must have 'size' bytes of space.
+ *
+ * Postconditions:
+ * - Returns the length of the line, or -1 if it does not fit in the buffer.
+ *
+ * Side Effects:
+ * - Writes into 'buffer'.
+ */
+int sPrintTask(Task t, char *buffer, int size) {
+    if (t == NULL || buffer == NULL) return -1;
+
+    int len = snprintf(buffer, size, "%s\t%s\t%s\t%d\t%s\t%s\t%.2f\t%s\t%d\t%d",
+        t->title, t->description, t->course, t->estimatedTime, t->startDate,
+        t->deadline, t->completionPercentage, t->completionDate, t->priority, t->id);
+    return (len < size) ? len : -1;
+}
+
+// Fields that differ between two tasks (TASK_*)
+unsigned int compareTaskFields(Task a, Task b) {
+    unsigned int fields = 0;
+    if (strcmp(a->title, b->title) != 0) fields |= TASK_TITLE;
+    if (strcmp(a->description, b->description) != 0) fields |= TASK_DESCRIPTION;
+    if (strcmp(a->course, b->course) != 0) fields |= TASK_COURSE;
+    if (a->estimatedTime != b->estimatedTime) fields |= TASK_TIME;
+    if (strcmp(a->deadline, b->deadline) != 0) fields |= TASK_DEADLINE;
+    if (a->priority != b->priority) fields |= TASK_PRIORITY;
+    if (a->completionPercentage != b->completionPercentage) fields |= TASK_COMPLETION;
+    if (strcmp(a->completionDate, b->completionDate) != 0) fields |= TASK_COMPLETION_DATE;
+    if (strcmp(a->startDate, b->startDate) != 0) fields |= TASK_START;
+    return fields;
+}
+
+// Copies a string field in or out of a packed buffer, returns the bytes used
+static int packString(char *field, char *buffer, bool in) {
+    int len = strlen(in ? buffer : field) + 1;
+    if (in) memcpy(field, buffer, len);
+        else if (buffer != NULL) memcpy(buffer, field, len);
+    return len;
+}
+
+// Copies a number field in or out of a packed buffer, returns the bytes used
+static int packNumber(void *field, int size, char *buffer, bool in) {
+    if (in) memcpy(field, buffer, size);
+        else if (buffer != NULL) memcpy(buffer, field, size);
+    return size;
+}
+
+/* packTaskFields, unpackTaskFields
+ * Syntax Specification:
+ * int packTaskFields(Task t, unsigned int fields, char *buffer);
+ * int unpackTaskFields(Task t, unsigned int fields, const char *buffer);
+ *
+ * Semantic Specification:
+ * Write the selected fields (TASK_*) of a task one after the other in 'buffer',
+ * or set them from it as they were written: the strings with their terminator,
+ * the numbers as they are in memory. The values are not checked again, so a
+ * past deadline or completion date can be set back.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'buffer' may be NULL for packTaskFields (only the size
+ *   is computed), otherwise it must have room for the fields.
+ *
+ * Postconditions:
+ * - Return the number of bytes written, or read.
+ *
+ * Side Effects:
+ * - Write into 'buffer', or into the task.
+ */
+static int packFields(Task t, unsigned int fields, char *buffer, bool in) {
+    int len = 0;
+    if (fields & TASK_TITLE) len += packString(t->title, buffer ? buffer + len : NULL, in);
+    if (fields & TASK_DESCRIPTION) len += packString(t->description, buffer ? buffer + len : NULL, in);
+    if (fields & TASK_COURSE) len += packString(t->course, buffer ? buffer + len : NULL, in);
+    if (fields & TASK_TIME) len += packNumber(&t->estimatedTime, sizeof(int), buffer ? buffer + len : NULL, in);
+    if (fields & TASK_DEADLINE) len += packString(t->deadline, buffer ? buffer + len : NULL, in);
+    if (fields & TASK_PRIORITY) len += packNumber(&t->priority, sizeof(int), buffer ? buffer + len : NULL, in);
+    if (fields & TASK_COMPLETION) len += packNumber(&t->completionPercentage, sizeof(float), buffer ? buffer + len : NULL, in);
+    if (fields & TASK_COMPLETION_DATE) len += packString(t->completionDate, buffer ? buffer + len : NULL, in);
+    if (fields & TASK_START) len += packString(t->startDate, buffer ? buffer + len : NULL, in);
+    return len;
+}
+
+int packTaskFields(Task t, unsigned int fields, char *buffer) {
+    return packFields(t, fields, buffer, false);
+}
+
+int unpackTaskFields(Task t, unsigned int fields, const char *buffer) {
+    return packFields(t, fields, (char *)buffer, true);
 }
 
 /* freeTask
@@ -436,4 +619,5 @@ int freeTask(Task t) {
         return 0;
     }
     free(t);
+    return 1;
 }
@@ -3,8 +3,28 @@
 // Forward declaration of the task struct
 typedef struct task *Task;
 
+// Fields of a task, for the changes recorded field by field (the first seven
+// are the PATCH_* of the planner)
+#define TASK_TITLE 0x001
+#define TASK_DESCRIPTION 0x002
+#define TASK_COURSE 0x004
+#define TASK_TIME 0x008
+#define TASK_DEADLINE 0x010
+#define TASK_PRIORITY 0x020
+#define TASK_COMPLETION 0x040
+#define TASK_COMPLETION_DATE 0x080
+#define TASK_START 0x100
+#define TASK_ALL 0x1ff
+
  //tisk prototypes
-Task newTask();
+Task createTask(const char *title, const char *description, const char *course,
+                int estimatedTime, const char *deadline, char *pTxt);
+
+int getId(Task t);
+Task assignTaskId(Task t);
+int getLastTaskId();
+void reserveTaskIds(int last);
+Task copyTask(Task t);
 
 char *getTitle(Task t);
 Task setTitle(Task t, const char *title);
@@ -34,8 +54,14 @@ char *getStartDate(Task t);
 Task setStartDate(Task t);
 
 Task fReadTask(FILE *f);
+Task sReadTask(const char *line);
 void printTaskDetails(Task t);
 void printTask(Task t);
 void fPrintTask(Task t, FILE *f);
+int sPrintTask(Task t, char *buffer, int size);
+
+unsigned int compareTaskFields(Task a, Task b);
+int packTaskFields(Task t, unsigned int fields, char *buffer);
+int unpackTaskFields(Task t, unsigned int fields, const char *buffer);
 
 int freeTask(Task t);
@@ -1,13 +1,25 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 #include "./planner/planner.h"
+#include "./menu/menu.h"
+#include "./batch/batch.h"
+#include "./datafile/datafile.h"
+#include "./loader/loader.h"
 
 int insertTest();
 int modifyTest();
 int reportTest();
+int journalTest();
+int batchTest();
+int undoTest();
+int dataFileTest();
+int fieldsTest();
 
 bool compare_files(const char *file1, const char *file2);
+bool copy_file(const char *from, const char *to);
+int run_script(Planner planner, const char *script, FILE *out);
 
 int main(void){
 
@@ -31,6 +43,36 @@ int main(void){
             return 1;
         }
 
+    if (!journalTest() ||
+        !compare_files("./test/oracle/journal.txt", "./test/output/journal.txt")) {
+            printf("\nJournal recovery error.");
+            return 1;
+        }
+
+    if (!batchTest() ||
+        !compare_files("./test/oracle/batch.txt", "./test/output/batch.txt")) {
+            printf("\nBatch mode error.");
+            return 1;
+        }
+
+    if (!undoTest() ||
+        !compare_files("./test/oracle/undo.txt", "./test/output/undo.txt")) {
+            printf("\nUndo error.");
+            return 1;
+        }
+
+    if (!dataFileTest() ||
+        !compare_files("./test/oracle/datafile.txt", "./test/output/datafile.txt")) {
+            printf("\nData file error.");
+            return 1;
+        }
+
+    if (!fieldsTest() ||
+        !compare_files("./test/oracle/fields.txt", "./test/output/fields.txt")) {
+            printf("\nField check error.");
+            return 1;
+        }
+
     printf("\nAll the tests gone well.");
     return 0;
 }
@@ -75,6 +117,165 @@ int reportTest(){
     return 1;
 }
 
+int journalTest(){
+    // journal left by a session that crashed after five changes, while writing the sixth
+    if (!copy_file("./test/input/journal.log", "./test/output/journal.log")) return 0;
+    today = "16062025";
+    Planner planner;
+    if ((planner = openPlanner()) == NULL) return 0;
+
+    FILE *out = fopen("./test/output/journal.txt", "w");
+    if (out == NULL) return 0;
+    int errors = run_script(planner, "./test/input/dump.txt", out);
+    fclose(out);
+    if (errors != 0) return 0;
+
+    closePlanner(planner);
+    return 1;
+}
+
+int batchTest(){
+    today = "16062025";
+    Planner planner;
+    if ((planner = openPlanner()) == NULL) return 0;
+
+    // the script has wrong commands on purpose: their errors are in the oracle
+    FILE *out = fopen("./test/output/batch.txt", "w");
+    if (out == NULL) return 0;
+    int errors = run_script(planner, "./test/input/batch.txt", out);
+    fclose(out);
+    if (errors < 0) return 0;
+
+    closePlanner(planner);
+    return 1;
+}
+
+int undoTest(){
+    today = "16062025";
+    Planner planner;
+    if ((planner = openPlanner()) == NULL) return 0;
+
+    FILE *out = fopen("./test/output/undo.txt", "w");
+    if (out == NULL) return 0;
+    // update, complete and delete, each one undone and redone
+    bool done = run_script(planner, "./test/input/undo.txt", out) >= 0;
+    // the history deleted, brought back and deleted again
+    done = done && deleteHistory(planner);
+    done = done && run_script(planner, "./test/input/undo_history.txt", out) >= 0;
+    fclose(out);
+    if (!done) return 0;
+
+    closePlanner(planner);
+    return 1;
+}
+
+int dataFileTest(){
+    today = "16062025";
+    const char *filename = "./test/output/datafile.dat";
+    // two blocks: a full one and a partial one
+    int numel = DATA_BLOCK_RECORDS + 44;
+    Task *tasks = malloc(numel * sizeof(Task));
+    if (tasks == NULL) return 0;
+
+    char title[21];
+    for (int i = 0; i < numel; i++){
+        snprintf(title, sizeof(title), "task %d", i);
+        tasks[i] = createTask(title, "round trip", "datafile", i, "30062025", i % 2 ? "low" : "high");
+        if (tasks[i] == NULL) return 0;
+    }
+
+    DataWriter w = beginDataFile(filename, numel, getLastTaskId());
+    if (w == NULL) return 0;
+    for (int i = 0; i < numel; i++) if (!writeRecord(w, tasks[i])) return 0;
+    if (!endDataFile(w)) return 0;
+
+    FILE *out = fopen("./test/output/datafile.txt", "w");
+    if (out == NULL) return 0;
+
+    // every record is read back equal to the one written
+    DataReader r = openDataFile(fopen(filename, "r"));
+    int read = 0, equal = 0;
+    Task t;
+    while ((t = readRecord(r)) != NULL){
+        if (read < numel && getId(t) == getId(tasks[read]) && compareTaskFields(t, tasks[read]) == 0) equal++;
+        read++;
+        freeTask(t);
+    }
+    fprintf(out, "round trip: %d records written, %d read, %d equal, valid %d\n", numel, read, equal, closeDataFile(r));
+
+    // a character changed in the second record: the CRC of the first block no longer matches
+    FILE *f = fopen(filename, "r+b");
+    char line[DATA_MAX_LINE];
+    if (f == NULL || !fgets(line, sizeof(line), f) || !fgets(line, sizeof(line), f)) return 0;
+    long record = ftell(f);
+    fseek(f, record, SEEK_SET);
+    fputc('T', f);
+    fclose(f);
+
+    r = openDataFile(fopen(filename, "r"));
+    read = 0;
+    while ((t = readRecord(r)) != NULL){
+        read++;
+        freeTask(t);
+    }
+    fprintf(out, "corrupted block: %d records read, valid %d\n", read, closeDataFile(r));
+
+    Task *items;
+    int lastId;
+    bool damaged;
+    int loaded = loadTasks(filename, &items, &lastId, &damaged);
+    fprintf(out, "corrupted block, loader: %d records read, damaged %d\n", loaded, damaged);
+    for (int i = 0; i < loaded; i++) freeTask(items[i]);
+    if (loaded >= 0) free(items);
+
+    fclose(out);
+    remove(filename);
+    for (int i = 0; i < numel; i++) freeTask(tasks[i]);
+    free(tasks);
+    return 1;
+}
+
+int fieldsTest(){
+    today = "16062025";
+    Planner planner;
+    if ((planner = openPlanner()) == NULL) return 0;
+
+    FILE *out = fopen("./test/output/fields.txt", "w");
+    if (out == NULL) return 0;
+
+    // an empty field could not be read back: the task must be refused
+    struct taskFields f = { "", "empty fields", "campi", 15, "30062025", "low" };
+    fprintf(out, "empty title: %d\n", plannerAddTask(planner, &f));
+    f.title = "campi vuoti";
+    f.description = "";
+    fprintf(out, "empty description: %d\n", plannerAddTask(planner, &f));
+    f.description = "empty fields";
+    f.course = "";
+    fprintf(out, "empty course: %d\n", plannerAddTask(planner, &f));
+    f.course = "campi";
+    int id = plannerAddTask(planner, &f);
+    fprintf(out, "valid fields: %d\n", id > 0);
+
+    struct taskPatch patch = { PATCH_TITLE };
+    patch.title = "";
+    fprintf(out, "empty title update: %d\n", plannerUpdate(planner, id, &patch));
+    patch.fields = PATCH_COMPLETION;
+    patch.completion = NAN;
+    fprintf(out, "NaN completion: %d\n", plannerUpdate(planner, id, &patch));
+    patch.completion = 40;
+    fprintf(out, "valid completion: %d\n", plannerUpdate(planner, id, &patch));
+    closePlanner(planner);
+
+    // the planner is loaded again: every task must be read back
+    if ((planner = openPlanner()) == NULL) return 0;
+    int errors = run_script(planner, "./test/input/dump.txt", out);
+    fclose(out);
+    if (errors != 0) return 0;
+
+    closePlanner(planner);
+    return 1;
+}
+
 #include <stdio.h>
 #include <stdbool.h>
 
@@ -83,17 +284,17 @@ bool compare_files(const char *file1, const char *file2) {
     FILE *fp2 = fopen(file2, "r");
 
     if (fp1 == NULL || fp2 == NULL) {
+        if (fp1 != NULL) fclose(fp1);
+        if (fp2 != NULL) fclose(fp2);
         return false;
     }
 
+    // both files are read at every step, so a shorter file is not mistaken for a prefix
     int ch1, ch2;
-    while ((ch1 = fgetc(fp1)) != EOF && (ch2 = fgetc(fp2)) != EOF) {
-        if (ch1 != ch2) {
-            fclose(fp1);
-            fclose(fp2);
-            return false;
-        }
-    }
+    do {
+        ch1 = fgetc(fp1);
+        ch2 = fgetc(fp2);
+    } while (ch1 == ch2 && ch1 != EOF);
 
     // Controlla se entrambi i file hanno raggiunto EOF
     bool result = (ch1 == EOF && ch2 == EOF);
@@ -101,4 +302,39 @@ bool compare_files(const char *file1, const char *file2) {
     fclose(fp1);
     fclose(fp2);
     return result;
-}
\ No newline at end of file
+}
+
+bool copy_file(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    if (in == NULL) {
+        return false;
+    }
+    FILE *out = fopen(to, "wb");
+    if (out == NULL) {
+        fclose(in);
+        return false;
+    }
+
+    int ch;
+    while ((ch = fgetc(in)) != EOF) {
+        fputc(ch, out);
+    }
+
+    bool result = !ferror(in) && !ferror(out);
+    fclose(in);
+    fclose(out);
+    return result;
+}
+
+// Runs a batch script, writing its results in 'out'; returns the number of
+// commands that failed, -1 if the script cannot be opened
+int run_script(Planner planner, const char *script, FILE *out) {
+    FILE *in = fopen(script, "r");
+    if (in == NULL) {
+        return -1;
+    }
+
+    int errors = runBatch(planner, in, out);
+    fclose(in);
+    return errors;
+}
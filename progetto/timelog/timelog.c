@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../crc/crc.h"
+#include "timelog.h"
+
+#define HEADER_FORMAT "#PTL\t%d\t%012ld\t%010d\t%08x\n"
+#define TIMELOG_MAX_LINE 128
+
+struct timeLog {
+    struct taskTime *tasks;     // in order of id
+    int numTasks;
+    int totTasks;
+    struct courseTime *courses; // in order of course
+    int numCourses;
+    int totCourses;
+    const char *path;           // of the log
+    FILE *log;                  // opened for appending on the first session
+    bool changed;               // totals not saved yet
+};
+
+// Minutes since the epoch, the clock of the sessions
+long studyClock(void) {
+    return (long) (time(NULL) / 60);
+}
+
+static TimeLog newTimeLog(const char *path) {
+    TimeLog l = calloc(1, sizeof(struct timeLog));
+    if (l != NULL) l->path = path;
+    return l;
+}
+
+void freeTimeLog(TimeLog l) {
+    if (l == NULL) return;
+    if (l->log != NULL) fclose(l->log);
+    free(l->tasks);
+    free(l->courses);
+    free(l);
+}
+
+/* findTask, findCourse
+ * Syntax Specification:
+ * static struct taskTime *findTask(TimeLog l, int id, bool add);
+ * static struct courseTime *findCourse(TimeLog l, const char *course, bool add);
+ *
+ * Semantic Specification:
+ * Binary search of the totals of a task (or course); with 'add' an empty entry
+ * is inserted in order if there is none. The ids of the new tasks are the
+ * highest, so their entries are appended.
+ *
+ * Preconditions:
+ * - 'l' must be valid.
+ *
+ * Postconditions:
+ * - Return the entry, or NULL if there is none (or memory is not available).
+ *
+ * Side Effects:
+ * - May allocate memory; the pointers to the entries are valid until the next insertion.
+ */
+static struct taskTime *findTask(TimeLog l, int id, bool add) {
+    int low = 0, high = l->numTasks;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (l->tasks[mid].id < id) low = mid + 1;
+            else high = mid;
+    }
+    if (low < l->numTasks && l->tasks[low].id == id) return &l->tasks[low];
+    if (!add) return NULL;
+
+    if (l->numTasks == l->totTasks) {
+        int tot = l->totTasks ? l->totTasks * 2 : 64;
+        struct taskTime *tasks = realloc(l->tasks, tot * sizeof(struct taskTime));
+        if (tasks == NULL) return NULL;
+        l->tasks = tasks;
+        l->totTasks = tot;
+    }
+    memmove(&l->tasks[low + 1], &l->tasks[low], (l->numTasks - low) * sizeof(struct taskTime));
+    l->numTasks++;
+    l->tasks[low] = (struct taskTime) { id, 0, 0, 0 };
+    return &l->tasks[low];
+}
+
+static struct courseTime *findCourse(TimeLog l, const char *course, bool add) {
+    int low = 0, high = l->numCourses;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (strcmp(l->courses[mid].course, course) < 0) low = mid + 1;
+            else high = mid;
+    }
+    if (low < l->numCourses && strcmp(l->courses[low].course, course) == 0) return &l->courses[low];
+    if (!add) return NULL;
+
+    if (l->numCourses == l->totCourses) {
+        int tot = l->totCourses ? l->totCourses * 2 : 8;
+        struct courseTime *courses = realloc(l->courses, tot * sizeof(struct courseTime));
+        if (courses == NULL) return NULL;
+        l->courses = courses;
+        l->totCourses = tot;
+    }
+    memmove(&l->courses[low + 1], &l->courses[low], (l->numCourses - low) * sizeof(struct courseTime));
+    l->numCourses++;
+    memset(&l->courses[low], 0, sizeof(struct courseTime));
+    snprintf(l->courses[low].course, sizeof(l->courses[low].course), "%s", course);
+    return &l->courses[low];
+}
+
+// Adds a session that is over to the totals of its task and course; a timed one stops the session running
+static bool addSession(TimeLog l, int id, const char *course, long start, int minutes, bool timed) {
+    struct taskTime *t = findTask(l, id, true);
+    if (t == NULL) return false;
+    t->minutes += minutes;
+    t->sessions++;
+    if (timed && t->started == start) t->started = 0;
+    if (course != NULL) {
+        struct courseTime *c = findCourse(l, course, true);
+        if (c == NULL) return false;
+        c->minutes += minutes;
+    }
+    l->changed = true;
+    return true;
+}
+
+// Appends a line to the log: one write, the rest of the file is never read
+static bool appendLine(TimeLog l, const char *line) {
+    if (l->log == NULL) {
+        l->log = fopen(l->path, "a+");
+        if (l->log == NULL) return false;
+        // a line cut by a crash is ended, so that it does not swallow the next one
+        bool cut = fseek(l->log, -1, SEEK_END) == 0 && fgetc(l->log) != '\n';
+        fseek(l->log, 0, SEEK_END);
+        if (cut) fputc('\n', l->log);
+    }
+    return fputs(line, l->log) >= 0 && fflush(l->log) == 0;
+}
+
+/* startStudy, stopStudy, logStudy
+ * Syntax Specification:
+ * int startStudy(TimeLog l, int id, long now);
+ * int stopStudy(TimeLog l, int id, const char *course, long now);
+ * int logStudy(TimeLog l, int id, const char *course, long start, int minutes);
+ *
+ * Semantic Specification:
+ * Start a session on a task, stop it adding its minutes to the totals of the
+ * task and of 'course', or add a session of 'minutes' started at 'start'
+ * (e.g. one that was not timed). Every call appends one line to the log.
+ *
+ * Preconditions:
+ * - 'l' must be valid, 'now' and 'start' from studyClock; 'course' may be NULL
+ *   (the course totals are not changed).
+ *
+ * Postconditions:
+ * - startStudy and logStudy return 1, stopStudy the minutes of the session;
+ *   TIMELOG_ERUNNING if a session of the task is running (startStudy),
+ *   TIMELOG_ESTOPPED if none is (stopStudy), TIMELOG_EIO if the log cannot be written.
+ *
+ * Side Effects:
+ * - Write to the log, may allocate memory.
+ */
+int startStudy(TimeLog l, int id, long now) {
+    struct taskTime *t = findTask(l, id, true);
+    if (t == NULL) return TIMELOG_EIO;
+    if (t->started != 0) return TIMELOG_ERUNNING;
+
+    char line[TIMELOG_MAX_LINE];
+    snprintf(line, sizeof(line), "S\t%d\t%ld\n", id, now);
+    if (!appendLine(l, line)) return TIMELOG_EIO;
+    t->started = now;
+    l->changed = true;
+    return 1;
+}
+
+int stopStudy(TimeLog l, int id, const char *course, long now) {
+    struct taskTime *t = findTask(l, id, false);
+    if (t == NULL || t->started == 0) return TIMELOG_ESTOPPED;
+
+    long start = t->started;
+    int minutes = (now > start) ? (int) (now - start) : 0;
+    char line[TIMELOG_MAX_LINE];
+    snprintf(line, sizeof(line), "E\t%d\t%ld\t%d\n", id, start, minutes);
+    if (!appendLine(l, line) || !addSession(l, id, course, start, minutes, true)) return TIMELOG_EIO;
+    return minutes;
+}
+
+int logStudy(TimeLog l, int id, const char *course, long start, int minutes) {
+    char line[TIMELOG_MAX_LINE];
+    snprintf(line, sizeof(line), "L\t%d\t%ld\t%d\n", id, start, minutes);
+    if (!appendLine(l, line) || !addSession(l, id, course, start, minutes, false)) return TIMELOG_EIO;
+    return 1;
+}
+
+bool getTaskTime(TimeLog l, int id, struct taskTime *t) {
+    struct taskTime *found = findTask(l, id, false);
+    if (found != NULL) *t = *found;
+        else *t = (struct taskTime) { id, 0, 0, 0 };
+    return found != NULL;
+}
+
+long getCourseTime(TimeLog l, const char *course) {
+    struct courseTime *found = findCourse(l, course, false);
+    return (found != NULL) ? found->minutes : 0;
+}
+
+// Totals of the courses in order of course, owned by 'l' and valid until the next session
+int getCourseTimes(TimeLog l, const struct courseTime **courses) {
+    *courses = l->courses;
+    return l->numCourses;
+}
+
+// Length of the log, 0 if there is none
+static long logLength(TimeLog l) {
+    if (l->log != NULL) {
+        fflush(l->log);
+        fseek(l->log, 0, SEEK_END);
+        return ftell(l->log);
+    }
+    FILE *f = fopen(l->path, "r");
+    if (f == NULL) return 0;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fclose(f);
+    return length;
+}
+
+/* saveTimeLog
+ * Syntax Specification:
+ * bool saveTimeLog(TimeLog l, const char *totals);
+ *
+ * Semantic Specification:
+ * Writes the totals on file (see timelog.h) with the length of the log they
+ * include; the header is written last, with the checksum of the records.
+ * Nothing is written if no session changed since the loading.
+ *
+ * Preconditions:
+ * - 'l' must be valid, 'totals' a writable path.
+ *
+ * Postconditions:
+ * - Returns true if the totals on file are up to date.
+ *
+ * Side Effects:
+ * - Writes to file.
+ */
+bool saveTimeLog(TimeLog l, const char *totals) {
+    if (!l->changed) return true;
+    FILE *f = fopen(totals, "w");
+    if (f == NULL) return false;
+
+    long covered = logLength(l);
+    bool ok = fprintf(f, HEADER_FORMAT, TIMELOG_VERSION, 0L, 0, 0u) > 0;
+    unsigned int crc = 0;
+    char line[TIMELOG_MAX_LINE];
+    for (int i = 0; i < l->numTasks && ok; i++) {
+        const struct taskTime *t = &l->tasks[i];
+        int len = snprintf(line, sizeof(line), "T\t%d\t%ld\t%d\t%ld", t->id, t->minutes, t->sessions, t->started);
+        crc = crc32c(crc, line, len);
+        ok = fprintf(f, "%s\n", line) > 0;
+    }
+    for (int i = 0; i < l->numCourses && ok; i++) {
+        int len = snprintf(line, sizeof(line), "C\t%ld\t%s", l->courses[i].minutes, l->courses[i].course);
+        crc = crc32c(crc, line, len);
+        ok = fprintf(f, "%s\n", line) > 0;
+    }
+    int count = l->numTasks + l->numCourses;
+    if (ok) ok = fseek(f, 0, SEEK_SET) == 0 && fprintf(f, HEADER_FORMAT, TIMELOG_VERSION, covered, count, crc) > 0;
+    if (fclose(f) != 0) ok = false;
+    if (ok) l->changed = false;
+    return ok;
+}
+
+// Reads a record of the totals, false if it is damaged
+static bool readTotal(TimeLog l, char *line) {
+    struct taskTime t;
+    long minutes;
+    int offset = 0;
+    if (sscanf(line, "T\t%d\t%ld\t%d\t%ld", &t.id, &t.minutes, &t.sessions, &t.started) == 4) {
+        struct taskTime *added = findTask(l, t.id, true);
+        if (added != NULL) *added = t;
+        return added != NULL;
+    }
+    if (sscanf(line, "C\t%ld\t%n", &minutes, &offset) == 1 && offset > 0) {
+        struct courseTime *added = findCourse(l, line + offset, true);
+        if (added != NULL) added->minutes = minutes;
+        return added != NULL;
+    }
+    return false;
+}
+
+/* readTotals
+ * Syntax Specification:
+ * static long readTotals(TimeLog l, const char *totals);
+ *
+ * Semantic Specification:
+ * Reads the totals written by saveTimeLog.
+ *
+ * Preconditions:
+ * - 'l' must be a new time log.
+ *
+ * Postconditions:
+ * - Returns the length of the log the totals include, or -1 if the file is
+ *   missing or damaged: the totals read are then discarded.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static long readTotals(TimeLog l, const char *totals) {
+    FILE *f = fopen(totals, "r");
+    if (f == NULL) return -1;
+
+    char line[TIMELOG_MAX_LINE];
+    int version, count = -1, numel = 0;
+    long covered = -1;
+    unsigned int crc = 0, computed = 0;
+    bool ok = fgets(line, sizeof(line), f) != NULL &&
+              sscanf(line, "#PTL\t%d\t%ld\t%d\t%x", &version, &covered, &count, &crc) == 4 && version == TIMELOG_VERSION;
+    while (ok && fgets(line, sizeof(line), f) != NULL) {
+        int len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        computed = crc32c(computed, line, len);
+        ok = readTotal(l, line);
+        numel++;
+    }
+    fclose(f);
+
+    if (ok && numel == count && computed == crc) return covered;
+    l->numTasks = l->numCourses = 0;
+    return -1;
+}
+
+/* replayLog
+ * Syntax Specification:
+ * static bool replayLog(TimeLog l, long from, CourseOf courseOf, void *ctx);
+ *
+ * Semantic Specification:
+ * Adds to the totals the lines of the log from byte 'from' on. The course of
+ * the sessions that are over is asked to 'courseOf'. A line that cannot be
+ * read (e.g. cut by a crash) is skipped.
+ *
+ * Preconditions:
+ * - 'from' must be the start of a line, at most the length of the log.
+ *
+ * Postconditions:
+ * - Returns false if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+static bool replayLog(TimeLog l, long from, CourseOf courseOf, void *ctx) {
+    FILE *f = fopen(l->path, "r");
+    if (f == NULL) return true;
+    if (fseek(f, from, SEEK_SET) != 0) {
+        fclose(f);
+        return true;
+    }
+
+    char line[TIMELOG_MAX_LINE];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f) != NULL) {
+        int id, minutes;
+        long start;
+        if ((line[0] == 'E' || line[0] == 'L') && sscanf(line + 1, "\t%d\t%ld\t%d", &id, &start, &minutes) == 3) {
+            ok = addSession(l, id, courseOf(ctx, id), start, minutes, line[0] == 'E');
+        } else if (sscanf(line, "S\t%d\t%ld", &id, &start) == 2) {
+            struct taskTime *t = findTask(l, id, true);
+            if (t != NULL) t->started = start;
+            ok = t != NULL;
+            l->changed = true;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/* loadTimeLog
+ * Syntax Specification:
+ * TimeLog loadTimeLog(const char *totals, const char *log, CourseOf courseOf, void *ctx);
+ *
+ * Semantic Specification:
+ * Reads the totals and the lines of the log appended after them. If the totals
+ * are missing or damaged, or do not match the log, they are computed again
+ * from the whole log: nothing is lost, the log being the only record of the
+ * sessions.
+ *
+ * Preconditions:
+ * - 'totals' and 'log' must be valid paths, kept valid while the time log is used;
+ *   'courseOf' must give the course of a task of the planner.
+ *
+ * Postconditions:
+ * - Returns the time log, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Reads from file, allocates memory.
+ */
+TimeLog loadTimeLog(const char *totals, const char *log, CourseOf courseOf, void *ctx) {
+    TimeLog l = newTimeLog(log);
+    if (l == NULL) return NULL;
+
+    long covered = readTotals(l, totals);
+    if (covered > logLength(l)) {
+        // the log was replaced: the totals no longer describe it
+        l->numTasks = l->numCourses = 0;
+        covered = -1;
+    }
+    if (covered < 0) l->changed = true;
+    if (!replayLog(l, (covered > 0) ? covered : 0, courseOf, ctx)) {
+        freeTimeLog(l);
+        return NULL;
+    }
+    return l;
+}
@@ -0,0 +1,55 @@
+#include <stdbool.h>
+
+// Minutes actually spent on the tasks. Every study session is appended to the
+// log as one short line, and the totals of every task and course are kept in
+// memory and written in a second file when the planner closes, with the length
+// of the log they include: loading reads the totals, and only the lines of the
+// log appended after them (e.g. before a crash) are read again, so the time to
+// load does not grow with the number of sessions. Times are in minutes since
+// the epoch (see studyClock). Layout of the files:
+//   log:    S <id> <start>              a session is started
+//           E <id> <start> <minutes>    the session started at <start> is over
+//           L <id> <start> <minutes>    a session that was not timed is added
+//   totals: #PTL <version> <bytes of the log included> <count> <CRC32C of the records>
+//           T <id> <minutes> <sessions> <start of the session running, 0 if none>
+//           C <minutes> <course>
+#define TIMELOG_VERSION 1
+
+// Results of startStudy and stopStudy
+#define TIMELOG_ERUNNING -1
+#define TIMELOG_ESTOPPED -2
+#define TIMELOG_EIO -3
+
+// Time spent on a task
+struct taskTime {
+    int id;
+    long minutes;
+    int sessions;
+    long started;               // start of the session running, 0 if none
+};
+
+// Time spent on a course, with the course the tasks had when the sessions ended
+struct courseTime {
+    char course[51];
+    long minutes;
+};
+
+// Course of a task, NULL if the task no longer exists; used for the lines read again
+typedef const char *(*CourseOf)(void *ctx, int id);
+
+// Forward declaration of the time log struct
+typedef struct timeLog *TimeLog;
+
+ //time log prototypes
+TimeLog loadTimeLog(const char *totals, const char *log, CourseOf courseOf, void *ctx);
+bool saveTimeLog(TimeLog l, const char *totals);
+void freeTimeLog(TimeLog l);
+long studyClock(void);
+
+int startStudy(TimeLog l, int id, long now);
+int stopStudy(TimeLog l, int id, const char *course, long now);
+int logStudy(TimeLog l, int id, const char *course, long start, int minutes);
+
+bool getTaskTime(TimeLog l, int id, struct taskTime *t);
+long getCourseTime(TimeLog l, const char *course);
+int getCourseTimes(TimeLog l, const struct courseTime **courses);
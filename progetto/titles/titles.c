@@ -0,0 +1,450 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "titles.h"
+
+// Node of the trie: the characters of a title are the path from the root
+struct node {
+    int child;                  // first child, -1 if none; the children are in order of character
+    int sibling;                // next child of the same parent, -1 if none
+    int entries;                // first task whose title ends here, -1 if none
+    int count[3];               // tasks of every collection in the subtree, to skip the empty ones
+    unsigned char c;
+};
+
+// The nodes are never freed: a node left without tasks is skipped by its counts.
+// The tasks of a node are linked through 'next'; free entries are reused.
+struct titleIndex {
+    struct node *nodes;
+    int numNodes;
+    int totNodes;
+    Task *tasks;
+    int *next;
+    unsigned char *state;       // collection: 0 progress, 1 completed, 2 expired
+    int numEntries;
+    int totEntries;
+    int freeEntry;              // first free entry, -1 if none
+    bool failed;                // a task could not be added: the index is incomplete
+};
+
+// State of a search of suggestions
+struct search {
+    unsigned char key[TITLE_KEY];
+    int m;
+    int distance;
+    unsigned int states;
+    int rows[TITLE_KEY + 1][TITLE_KEY + 1]; // rows[d][j]: edits from the first d characters of the path to the first j of the key
+    unsigned char path[TITLE_KEY];
+    Task *result;               // best suggestions found, in order
+    int *dist;
+    int max;
+    int numel;
+};
+
+// Appends a node without children or tasks, returns its index or -1
+static int newNode(TitleIndex x, unsigned char c) {
+    if (x->numNodes == x->totNodes) {
+        int tot = x->totNodes ? x->totNodes * 2 : 64;
+        struct node *nodes = realloc(x->nodes, tot * sizeof(struct node));
+        if (nodes == NULL) return -1;
+        x->nodes = nodes;
+        x->totNodes = tot;
+    }
+    struct node *n = &x->nodes[x->numNodes];
+    memset(n, 0, sizeof(struct node));
+    n->child = n->sibling = n->entries = -1;
+    n->c = c;
+    return x->numNodes++;
+}
+
+/* newTitleIndex
+ * Syntax Specification:
+ * TitleIndex newTitleIndex(void);
+ *
+ * Semantic Specification:
+ * Creates an empty index. The tasks are then added with addTitle, and the index
+ * is kept up to date at every change of a title or of a collection.
+ *
+ * Preconditions:
+ * - None.
+ *
+ * Postconditions:
+ * - Returns the new index, or NULL if memory is not available.
+ *
+ * Side Effects:
+ * - Allocates memory.
+ */
+TitleIndex newTitleIndex(void) {
+    TitleIndex x = calloc(1, sizeof(struct titleIndex));
+    if (x == NULL) return NULL;
+    x->freeEntry = -1;
+    if (newNode(x, '\0') < 0) {
+        free(x);
+        return NULL;
+    }
+    return x;
+}
+
+void freeTitleIndex(TitleIndex x) {
+    if (x == NULL) return;
+    free(x->nodes);
+    free(x->tasks);
+    free(x->next);
+    free(x->state);
+    free(x);
+}
+
+// Key of a title: ASCII letters in lower case, at most TITLE_KEY characters
+static int titleKey(const char *title, unsigned char *key) {
+    int n = 0;
+    while (n < TITLE_KEY && title[n] != '\0') {
+        unsigned char c = title[n];
+        key[n++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    }
+    return n;
+}
+
+// Tasks of the collections in 'states' (all if 0) in the subtree of 'n'
+static int countIn(const struct node *n, unsigned int states) {
+    int count = 0;
+    for (int k = 0; k < 3; k++) {
+        if (states == 0 || (states & (1u << k))) count += n->count[k];
+    }
+    return count;
+}
+
+static bool inStates(int state, unsigned int states) {
+    return states == 0 || (states & (1u << state));
+}
+
+/* findChild
+ * Syntax Specification:
+ * static int findChild(TitleIndex x, int node, unsigned char c, bool add);
+ *
+ * Semantic Specification:
+ * Returns the child of 'node' for the character 'c'; if 'add' is true it is
+ * added when missing, keeping the children in order of character.
+ *
+ * Preconditions:
+ * - 'node' must be a node of 'x'.
+ *
+ * Postconditions:
+ * - Returns the child, or -1 if it is missing (and not added) or memory is not available.
+ *
+ * Side Effects:
+ * - May allocate memory.
+ */
+static int findChild(TitleIndex x, int node, unsigned char c, bool add) {
+    int prev = -1, n = x->nodes[node].child;
+    while (n != -1 && x->nodes[n].c < c) {
+        prev = n;
+        n = x->nodes[n].sibling;
+    }
+    if (n != -1 && x->nodes[n].c == c) return n;
+    if (!add) return -1;
+
+    int m = newNode(x, c);
+    if (m < 0) return -1;
+    x->nodes[m].sibling = n;
+    if (prev == -1) x->nodes[node].child = m;
+        else x->nodes[prev].sibling = m;
+    return m;
+}
+
+// Makes room for one more entry
+static bool reserveEntry(TitleIndex x) {
+    if (x->freeEntry != -1 || x->numEntries < x->totEntries) return true;
+
+    int tot = x->totEntries ? x->totEntries * 2 : 64;
+    Task *tasks = realloc(x->tasks, tot * sizeof(Task));
+    if (tasks == NULL) return false;
+    x->tasks = tasks;
+    int *next = realloc(x->next, tot * sizeof(int));
+    if (next == NULL) return false;
+    x->next = next;
+    unsigned char *state = realloc(x->state, tot);
+    if (state == NULL) return false;
+    x->state = state;
+    x->totEntries = tot;
+    return true;
+}
+
+/* addTitle, removeTitle
+ * Syntax Specification:
+ * void addTitle(TitleIndex x, Task t, int collection);
+ * void removeTitle(TitleIndex x, Task t);
+ *
+ * Semantic Specification:
+ * Add a task of the given collection (0 progress, 1 completed, 2 expired) under
+ * its title, or remove it. removeTitle must be called before the title is
+ * changed, since it is used to find the task. Both visit at most TITLE_KEY nodes.
+ *
+ * Preconditions:
+ * - 't' must be valid; 'x' may be NULL (nothing is done).
+ * - addTitle: 't' must not be in the index.
+ *
+ * Postconditions:
+ * - The task is (no longer) in the index. If addTitle runs out of memory the
+ *   index is marked incomplete and the searches fail.
+ *
+ * Side Effects:
+ * - addTitle may allocate memory.
+ */
+void addTitle(TitleIndex x, Task t, int collection) {
+    if (x == NULL || t == NULL || x->failed) return;
+
+    unsigned char key[TITLE_KEY];
+    int path[TITLE_KEY + 1], len = titleKey(getTitle(t), key);
+    path[0] = 0;
+    for (int i = 0; i < len; i++) {
+        path[i + 1] = findChild(x, path[i], key[i], true);
+        if (path[i + 1] < 0) {
+            x->failed = true;
+            return;
+        }
+    }
+    if (!reserveEntry(x)) {
+        x->failed = true;
+        return;
+    }
+
+    int e = x->freeEntry;
+    if (e != -1) x->freeEntry = x->next[e];
+        else e = x->numEntries++;
+    x->tasks[e] = t;
+    x->state[e] = collection;
+    x->next[e] = x->nodes[path[len]].entries;
+    x->nodes[path[len]].entries = e;
+    for (int i = 0; i <= len; i++) x->nodes[path[i]].count[collection]++;
+}
+
+void removeTitle(TitleIndex x, Task t) {
+    if (x == NULL || t == NULL || x->failed) return;
+
+    unsigned char key[TITLE_KEY];
+    int path[TITLE_KEY + 1], len = titleKey(getTitle(t), key);
+    path[0] = 0;
+    for (int i = 0; i < len; i++) {
+        path[i + 1] = findChild(x, path[i], key[i], false);
+        if (path[i + 1] < 0) return;
+    }
+
+    int prev = -1, e = x->nodes[path[len]].entries;
+    while (e != -1 && x->tasks[e] != t) {
+        prev = e;
+        e = x->next[e];
+    }
+    if (e == -1) return;
+    if (prev == -1) x->nodes[path[len]].entries = x->next[e];
+        else x->next[prev] = x->next[e];
+    for (int i = 0; i <= len; i++) x->nodes[path[i]].count[x->state[e]]--;
+    x->tasks[e] = NULL;
+    x->next[e] = x->freeEntry;
+    x->freeEntry = e;
+}
+
+// Node of the key of 'title', -1 if no title starts with it
+static int findNode(TitleIndex x, const char *title) {
+    unsigned char key[TITLE_KEY];
+    int node = 0, len = titleKey(title, key);
+    for (int i = 0; i < len && node >= 0; i++) node = findChild(x, node, key[i], false);
+    return node;
+}
+
+/* findTitle
+ * Syntax Specification:
+ * Task findTitle(TitleIndex x, const char *title, unsigned int states);
+ *
+ * Semantic Specification:
+ * Returns the task of the collections in 'states' (bit 1 << collection, 0 for
+ * all) with exactly the given title; among tasks with the same title, the one
+ * with the lowest id.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 'title' a null-terminated string.
+ *
+ * Postconditions:
+ * - Returns the task, or NULL if none has the title.
+ *
+ * Side Effects:
+ * - None.
+ */
+Task findTitle(TitleIndex x, const char *title, unsigned int states) {
+    int node = findNode(x, title);
+    if (node < 0) return NULL;
+
+    Task found = NULL;
+    for (int e = x->nodes[node].entries; e != -1; e = x->next[e]) {
+        if (!inStates(x->state[e], states) || strcmp(getTitle(x->tasks[e]), title) != 0) continue;
+        if (found == NULL || getId(x->tasks[e]) < getId(found)) found = x->tasks[e];
+    }
+    return found;
+}
+
+// Tasks of the subtree of 'node' in order of title, until 'max' are found
+static void collect(TitleIndex x, int node, unsigned int states, Task *result, int max, int *numel) {
+    for (int e = x->nodes[node].entries; e != -1 && *numel < max; e = x->next[e]) {
+        if (inStates(x->state[e], states)) result[(*numel)++] = x->tasks[e];
+    }
+    for (int c = x->nodes[node].child; c != -1 && *numel < max; c = x->nodes[c].sibling) {
+        if (countIn(&x->nodes[c], states) > 0) collect(x, c, states, result, max, numel);
+    }
+}
+
+/* completeTitle
+ * Syntax Specification:
+ * int completeTitle(TitleIndex x, const char *prefix, unsigned int states, Task *result, int max);
+ *
+ * Semantic Specification:
+ * Returns the tasks of the collections in 'states' (0 for all) whose title starts
+ * with 'prefix', case ignored, in order of title. Only the nodes of the prefix and
+ * of the returned titles are visited.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 'prefix' a null-terminated string, 'result' must have room for 'max' tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks (at most 'max') or -1 if the index is incomplete.
+ *
+ * Side Effects:
+ * - None.
+ */
+int completeTitle(TitleIndex x, const char *prefix, unsigned int states, Task *result, int max) {
+    if (x == NULL || x->failed) return -1;
+
+    int node = findNode(x, prefix), numel = 0;
+    if (node >= 0 && countIn(&x->nodes[node], states) > 0) collect(x, node, states, result, max, &numel);
+    return numel;
+}
+
+// Order of the suggestions: edits, then title, then id
+static int compareSuggestions(Task a, int da, Task b, int db) {
+    if (da != db) return da - db;
+    int c = strcmp(getTitle(a), getTitle(b));
+    if (c != 0) return c;
+    return getId(a) - getId(b);
+}
+
+// Keeps the task among the best 'max' suggestions
+static void addSuggestion(struct search *s, Task t, int d) {
+    if (s->numel == s->max && compareSuggestions(t, d, s->result[s->max - 1], s->dist[s->max - 1]) >= 0) return;
+
+    int i = (s->numel < s->max) ? s->numel++ : s->max - 1;
+    while (i > 0 && compareSuggestions(t, d, s->result[i - 1], s->dist[i - 1]) < 0) {
+        s->result[i] = s->result[i - 1];
+        s->dist[i] = s->dist[i - 1];
+        i--;
+    }
+    s->result[i] = t;
+    s->dist[i] = d;
+}
+
+// Edits allowed to a new suggestion: fewer once 'max' are found
+static int bound(const struct search *s) {
+    return (s->numel == s->max && s->dist[s->max - 1] < s->distance) ? s->dist[s->max - 1] : s->distance;
+}
+
+/* visit
+ * Syntax Specification:
+ * static void visit(TitleIndex x, int node, int depth, struct search *s);
+ *
+ * Semantic Specification:
+ * Visits the children of 'node', whose row of edits is s->rows[depth]: the row of
+ * every child is computed from it (insertion, deletion, substitution and swap of
+ * two adjacent characters), and a subtree is skipped as soon as every prefix
+ * already needs more edits than allowed.
+ *
+ * Preconditions:
+ * - s->rows[0..depth] and s->path[0..depth-1] must hold the path to 'node'.
+ *
+ * Postconditions:
+ * - The titles of the subtree within the edits allowed are in the suggestions.
+ *
+ * Side Effects:
+ * - None.
+ */
+static void visit(TitleIndex x, int node, int depth, struct search *s) {
+    if (depth >= TITLE_KEY) return;
+
+    const int *prev = s->rows[depth];
+    int *row = s->rows[depth + 1];
+    for (int c = x->nodes[node].child; c != -1; c = x->nodes[c].sibling) {
+        if (countIn(&x->nodes[c], s->states) == 0) continue;
+
+        unsigned char ch = x->nodes[c].c;
+        int best = row[0] = depth + 1;
+        for (int j = 1; j <= s->m; j++) {
+            int v = prev[j - 1] + (s->key[j - 1] != ch);
+            if (prev[j] + 1 < v) v = prev[j] + 1;
+            if (row[j - 1] + 1 < v) v = row[j - 1] + 1;
+            if (depth > 0 && j > 1 && ch == s->key[j - 2] && s->path[depth - 1] == s->key[j - 1] &&
+                s->rows[depth - 1][j - 2] + 1 < v) v = s->rows[depth - 1][j - 2] + 1;
+            row[j] = v;
+            if (v < best) best = v;
+        }
+        if (best > bound(s)) continue;
+
+        s->path[depth] = ch;
+        if (row[s->m] <= bound(s)) {
+            for (int e = x->nodes[c].entries; e != -1; e = x->next[e]) {
+                if (inStates(x->state[e], s->states)) addSuggestion(s, x->tasks[e], row[s->m]);
+            }
+        }
+        visit(x, c, depth + 1, s);
+    }
+}
+
+/* suggestTitles
+ * Syntax Specification:
+ * int suggestTitles(TitleIndex x, const char *title, int distance, unsigned int states, Task *result, int max);
+ *
+ * Semantic Specification:
+ * Returns the tasks of the collections in 'states' (0 for all) whose title is at
+ * most 'distance' edits (a character inserted, deleted, changed, or two adjacent
+ * ones swapped) from 'title', case ignored: the closest first, then in order of
+ * title. The trie is walked keeping one row of edits per level, so only the
+ * prefixes still within 'distance' of the title are visited.
+ *
+ * Preconditions:
+ * - 'x' must be valid, 'title' a null-terminated string, 'result' must have room for 'max' tasks.
+ *
+ * Postconditions:
+ * - Returns the number of tasks (at most 'max') or -1 if the index is incomplete
+ *   or memory is not available.
+ *
+ * Side Effects:
+ * - None.
+ */
+int suggestTitles(TitleIndex x, const char *title, int distance, unsigned int states, Task *result, int max) {
+    if (x == NULL || x->failed) return -1;
+    if (max <= 0) return 0;
+
+    struct search *s = malloc(sizeof(struct search));
+    if (s == NULL) return -1;
+    s->dist = malloc(max * sizeof(int));
+    if (s->dist == NULL) {
+        free(s);
+        return -1;
+    }
+    s->m = titleKey(title, s->key);
+    s->distance = distance;
+    s->states = states;
+    s->result = result;
+    s->max = max;
+    s->numel = 0;
+    for (int j = 0; j <= s->m; j++) s->rows[0][j] = j;
+
+    // the empty title is at m edits from any title
+    if (s->m <= distance) {
+        for (int e = x->nodes[0].entries; e != -1; e = x->next[e]) {
+            if (inStates(x->state[e], states)) addSuggestion(s, x->tasks[e], s->m);
+        }
+    }
+    visit(x, 0, 0, s);
+
+    int numel = s->numel;
+    free(s->dist);
+    free(s);
+    return numel;
+}
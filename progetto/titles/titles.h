@@ -0,0 +1,20 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Trie of the titles of every task, for completion and suggestions: the titles
+// are compared without case (ASCII letters) and cut at TITLE_KEY characters
+#define TITLE_KEY 20
+
+// Forward declaration of the title index struct
+typedef struct titleIndex *TitleIndex;
+
+ //title index prototypes
+TitleIndex newTitleIndex(void);
+void freeTitleIndex(TitleIndex x);
+
+void addTitle(TitleIndex x, Task t, int collection);
+void removeTitle(TitleIndex x, Task t);
+
+Task findTitle(TitleIndex x, const char *title, unsigned int states);
+int completeTitle(TitleIndex x, const char *prefix, unsigned int states, Task *result, int max);
+int suggestTitles(TitleIndex x, const char *title, int distance, unsigned int states, Task *result, int max);
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "undo.h"
+
+// Step of the log
+struct entry {
+    int op;
+    int id;
+    unsigned int fields;
+    bool first;                 // first step of its action
+    int oldSize;                // bytes of the old values, the new ones follow
+    int newSize;
+    char *values;
+    Task task;                  // task out of the planner kept by the step, or NULL
+};
+
+// The steps to undo, oldest first, and the ones to redo, the last undone on top.
+// Both arrays have the same capacity, enough for every step: moving a step from
+// one to the other never allocates.
+struct undoLog {
+    struct entry *undo;
+    int numUndo;
+    struct entry *redo;
+    int numRedo;
+    int tot;
+    long bytes;                 // memory of the steps and of the tasks they keep
+    long budget;
+    bool newAction;             // the next step starts an action
+    bool dropped;               // the action being recorded did not fit: its next steps are dropped too
+};
+
+UndoLog newUndoLog(long budget) {
+    UndoLog u = calloc(1, sizeof(struct undoLog));
+    if (u != NULL) u->budget = budget;
+    return u;
+}
+
+// Memory of a task kept by a step
+static long taskBytes(Task t) {
+    return (t != NULL) ? packTaskFields(t, TASK_ALL, NULL) + sizeof(int) : 0;
+}
+
+static long entryBytes(const struct entry *e) {
+    return sizeof(struct entry) + e->oldSize + e->newSize + taskBytes(e->task);
+}
+
+static void freeEntry(UndoLog u, struct entry *e) {
+    u->bytes -= entryBytes(e);
+    free(e->values);
+    if (e->task != NULL) freeTask(e->task);
+}
+
+// Removes every step, the kept tasks are freed
+void clearUndo(UndoLog u) {
+    if (u == NULL) return;
+    for (int i = 0; i < u->numUndo; i++) freeEntry(u, &u->undo[i]);
+    for (int i = 0; i < u->numRedo; i++) freeEntry(u, &u->redo[i]);
+    u->numUndo = u->numRedo = 0;
+}
+
+void freeUndoLog(UndoLog u) {
+    if (u == NULL) return;
+    clearUndo(u);
+    free(u->undo);
+    free(u->redo);
+    free(u);
+}
+
+// The next step recorded starts a new action
+void beginAction(UndoLog u) {
+    if (u == NULL) return;
+    u->newAction = true;
+    u->dropped = false;
+}
+
+// Room for one more step in both arrays
+static bool reserveStep(UndoLog u) {
+    if (u->numUndo + u->numRedo < u->tot) return true;
+    int tot = u->tot ? u->tot * 2 : 32;
+    struct entry *undo = realloc(u->undo, tot * sizeof(struct entry));
+    if (undo != NULL) u->undo = undo;
+    struct entry *redo = realloc(u->redo, tot * sizeof(struct entry));
+    if (redo != NULL) u->redo = redo;
+    if (undo == NULL || redo == NULL) return false;
+    u->tot = tot;
+    return true;
+}
+
+// Drops the steps of the action being recorded, on top of the undo steps
+static void dropAction(UndoLog u) {
+    while (u->numUndo > 0) {
+        struct entry *e = &u->undo[--u->numUndo];
+        bool first = e->first;
+        freeEntry(u, e);
+        if (first) break;
+    }
+    u->dropped = true;
+}
+
+// Drops the oldest actions until the log fits its budget
+static void enforceBudget(UndoLog u) {
+    while (u->bytes > u->budget && u->numUndo > 0) {
+        int end = 1;
+        while (end < u->numUndo && !u->undo[end].first) end++;
+        if (end == u->numUndo) {
+            // the action being recorded does not fit alone
+            dropAction(u);
+            return;
+        }
+        for (int i = 0; i < end; i++) freeEntry(u, &u->undo[i]);
+        memmove(u->undo, &u->undo[end], (u->numUndo - end) * sizeof(struct entry));
+        u->numUndo -= end;
+    }
+}
+
+/* recordStep
+ * Syntax Specification:
+ * bool recordStep(UndoLog u, int op, Task before, Task after);
+ *
+ * Semantic Specification:
+ * Records a step of the current action (see beginAction). For UNDO_UPDATE,
+ * UNDO_COMPLETE and UNDO_RESTORE 'before' is a copy of the task before the
+ * change and 'after' the task: only the fields that differ are packed. For
+ * UNDO_ADD and UNDO_DELETE 'after' is the task, which an UNDO_DELETE keeps.
+ * UNDO_HISTORY has no task and drops every older step, since the archive of the
+ * history it gives back is replaced. The first step of an action drops the
+ * steps to redo. A step that cannot be recorded drops the whole action.
+ *
+ * Preconditions:
+ * - 'u' may be NULL (nothing is recorded); 'after' must be valid except for UNDO_HISTORY.
+ *
+ * Postconditions:
+ * - Returns true if the log took the step: the task of an UNDO_DELETE then
+ *   belongs to the log, otherwise it is still the caller's. 'before' is not kept.
+ *
+ * Side Effects:
+ * - Allocates memory, may free the oldest steps and their tasks.
+ */
+bool recordStep(UndoLog u, int op, Task before, Task after) {
+    if (u == NULL || u->dropped) return false;
+    if ((op == UNDO_UPDATE || op == UNDO_COMPLETE || op == UNDO_RESTORE) && before == NULL) {
+        // no copy of the old fields: this action cannot be undone, nor the older ones after it
+        clearUndo(u);
+        u->dropped = true;
+        return false;
+    }
+    if (op == UNDO_HISTORY) clearUndo(u);
+    if (u->newAction) {
+        for (int i = 0; i < u->numRedo; i++) freeEntry(u, &u->redo[i]);
+        u->numRedo = 0;
+    }
+
+    struct entry e = { op, (after != NULL) ? getId(after) : 0, 0, u->newAction, 0, 0, NULL, NULL };
+    if (before != NULL) {
+        e.fields = compareTaskFields(before, after);
+        e.oldSize = packTaskFields(before, e.fields, NULL);
+        e.newSize = packTaskFields(after, e.fields, NULL);
+        if (e.fields != 0) e.values = malloc(e.oldSize + e.newSize);
+        if (e.fields != 0 && e.values == NULL) {
+            if (!u->newAction) dropAction(u);
+            u->dropped = true;
+            return false;
+        }
+        if (e.values != NULL) {
+            packTaskFields(before, e.fields, e.values);
+            packTaskFields(after, e.fields, e.values + e.oldSize);
+        }
+    }
+    if (!reserveStep(u)) {
+        free(e.values);
+        if (!u->newAction) dropAction(u);
+        u->dropped = true;
+        return false;
+    }
+
+    if (op == UNDO_DELETE) e.task = after;
+    u->undo[u->numUndo++] = e;
+    u->bytes += entryBytes(&e);
+    u->newAction = false;
+    enforceBudget(u);
+    return true;
+}
+
+/* lastAction
+ * Syntax Specification:
+ * int lastAction(UndoLog u, bool redo);
+ *
+ * Semantic Specification:
+ * Number of steps of the action to undo (or redo) next: they are taken one by
+ * one with takeStep, the last recorded first when undoing.
+ *
+ * Preconditions:
+ * - 'u' may be NULL.
+ *
+ * Postconditions:
+ * - Returns the number of steps, 0 if there is nothing to undo (or redo).
+ *
+ * Side Effects:
+ * - None.
+ */
+int lastAction(UndoLog u, bool redo) {
+    if (u == NULL) return 0;
+    int count = 0;
+    if (!redo) {
+        for (int i = u->numUndo - 1; i >= 0; i--) {
+            count++;
+            if (u->undo[i].first) break;
+        }
+    } else {
+        for (int i = u->numRedo - 1; i >= 0; i--) {
+            if (u->redo[i].first && count > 0) break;
+            count++;
+        }
+    }
+    return count;
+}
+
+/* takeStep, applyStep, keepTask
+ * Syntax Specification:
+ * void takeStep(UndoLog u, bool redo, struct undoStep *s);
+ * void applyStep(UndoLog u, bool redo, Task t);
+ * void keepTask(UndoLog u, bool redo, Task t);
+ *
+ * Semantic Specification:
+ * takeStep moves the next step to undo (or redo) to the other side and
+ * describes it in 's', handing over the task it kept, if any. applyStep sets
+ * the fields of that step on 't' to their old values (or new, for redo): it
+ * costs the size of the delta. keepTask gives the step the task that leaves the
+ * planner when it is applied.
+ *
+ * Preconditions:
+ * - takeStep: lastAction(u, redo) > 0. applyStep, keepTask: after takeStep with
+ *   the same 'redo'; keepTask only for a step that handed over no task.
+ *
+ * Postconditions:
+ * - The step can be redone (or undone) again.
+ *
+ * Side Effects:
+ * - Modify the log, or the task.
+ */
+void takeStep(UndoLog u, bool redo, struct undoStep *s) {
+    struct entry e = redo ? u->redo[--u->numRedo] : u->undo[--u->numUndo];
+    s->op = e.op;
+    s->id = e.id;
+    s->fields = e.fields;
+    s->task = e.task;
+    u->bytes -= taskBytes(e.task);
+    e.task = NULL;
+    if (redo) u->undo[u->numUndo++] = e;
+        else u->redo[u->numRedo++] = e;
+}
+
+void applyStep(UndoLog u, bool redo, Task t) {
+    struct entry *e = redo ? &u->undo[u->numUndo - 1] : &u->redo[u->numRedo - 1];
+    if (e->values != NULL) unpackTaskFields(t, e->fields, redo ? e->values + e->oldSize : e->values);
+}
+
+void keepTask(UndoLog u, bool redo, Task t) {
+    struct entry *e = redo ? &u->undo[u->numUndo - 1] : &u->redo[u->numRedo - 1];
+    e->task = t;
+    u->bytes += taskBytes(t);
+}
@@ -0,0 +1,38 @@
+#include <stdbool.h>
+#include "../task/task.h"
+
+// Undo and redo of the changes of the planner, with bounded memory. Every step
+// is a field-level delta: the fields (TASK_*) changed by an operation, with
+// their old and new values packed one after the other, so changing a title
+// costs a few bytes and not a copy of the task. A deleted task is not copied
+// either: the step keeps the task itself, moved out of the planner, and gives
+// it back on undo. The steps of an action (e.g. a plannerDeleteMany) are undone
+// together; beyond the budget the oldest actions are dropped.
+#define UNDO_BUDGET (1024 * 1024)
+
+// Operations of the steps
+enum { UNDO_ADD, UNDO_UPDATE, UNDO_COMPLETE, UNDO_RESTORE, UNDO_DELETE, UNDO_HISTORY };
+
+// Step taken from the log, to be applied by the planner
+struct undoStep {
+    int op;
+    int id;                 // task of the step, 0 for UNDO_HISTORY
+    unsigned int fields;    // fields changed (TASK_*)
+    Task task;              // task kept by the log and now given back, or NULL
+};
+
+// Forward declaration of the undo log struct
+typedef struct undoLog *UndoLog;
+
+ //undo log prototypes
+UndoLog newUndoLog(long budget);
+void freeUndoLog(UndoLog u);
+void clearUndo(UndoLog u);
+
+void beginAction(UndoLog u);
+bool recordStep(UndoLog u, int op, Task before, Task after);
+
+int lastAction(UndoLog u, bool redo);
+void takeStep(UndoLog u, bool redo, struct undoStep *s);
+void applyStep(UndoLog u, bool redo, Task t);
+void keepTask(UndoLog u, bool redo, Task t);